@@ -30,16 +30,34 @@ SOURCES += \
     src/common/zmultiselectmenu.cpp \
     src/common/ztableheadermanager.cpp \
     src/common/zffprobe.cpp \
+    src/common/zprobescheduler.cpp \
+    src/common/zcapabilitycatalog.cpp \
+    src/common/zprobeengine.cpp \
+    src/common/zframeengine.cpp \
+    src/common/zprobecache.cpp \
+    src/common/zproberesultcache.cpp \
     src/common/zffmpeg.cpp \
     src/common/zffplay.cpp \
     src/common/zlogger.cpp \
     src/common/ztexteditor.cpp \
     src/common/ztexthighlighter.cpp \
     src/common/zwindowhelper.cpp \
+    src/model/columntablestore.cpp \
     src/model/fileshistorymodel.cpp \
     src/model/logmodel.cpp \
     src/model/mediainfotabelmodel.cpp \
     src/model/multicolumnsearchproxymodel.cpp \
+    src/model/rawtextmodel.cpp \
+    src/model/tableaggregator.cpp \
+    src/model/tablediff.cpp \
+    src/model/tablefilterengine.cpp \
+    src/model/tablefilterexpression.cpp \
+    src/model/tablememorybudget.cpp \
+    src/model/tablemimedata.cpp \
+    src/model/tablesnapshot.cpp \
+    src/model/timelinepyramid.cpp \
+    src/model/trigramindex.cpp \
+    src/widgets/aggregationwg.cpp \
     src/widgets/basefmtwg.cpp \
     src/widgets/configurebuildtool.cpp \
     src/widgets/exportwg.cpp \
@@ -56,6 +74,8 @@ SOURCES += \
     src/widgets/searchwg.cpp \
     src/widgets/tabconfigwg.cpp \
     src/widgets/tabelfmtwg.cpp \
+    src/widgets/tablediffwg.cpp \
+    src/widgets/timelinewg.cpp \
     src/widgets/mediapropswg.cpp
 
 HEADERS += \
@@ -69,16 +89,35 @@ HEADERS += \
     src/common/zsingleton.h \
     src/common/ztableheadermanager.h \
     src/common/zffprobe.h \
+    src/common/zprobescheduler.h \
+    src/common/zcapabilitycatalog.h \
+    src/common/zprobeengine.h \
+    src/common/zframeengine.h \
+    src/common/zboundedqueue.h \
+    src/common/zprobecache.h \
+    src/common/zproberesultcache.h \
     src/common/zffmpeg.h \
     src/common/zffplay.h \
     src/common/zlogger.h \
     src/common/ztexteditor.h \
     src/common/ztexthighlighter.h \
     src/common/zwindowhelper.h \
+    src/model/columntablestore.h \
     src/model/fileshistorymodel.h \
     src/model/logmodel.h \
     src/model/mediainfotabelmodel.h \
     src/model/multicolumnsearchproxymodel.h \
+    src/model/rawtextmodel.h \
+    src/model/tableaggregator.h \
+    src/model/tablediff.h \
+    src/model/tablefilterengine.h \
+    src/model/tablefilterexpression.h \
+    src/model/tablememorybudget.h \
+    src/model/tablemimedata.h \
+    src/model/tablesnapshot.h \
+    src/model/timelinepyramid.h \
+    src/model/trigramindex.h \
+    src/widgets/aggregationwg.h \
     src/widgets/basefmtwg.h \
     src/widgets/configurebuildtool.h \
     src/widgets/exportwg.h \
@@ -94,9 +133,12 @@ HEADERS += \
     src/widgets/searchwg.h \
     src/widgets/tabconfigwg.h \
     src/widgets/tabelfmtwg.h \
+    src/widgets/tablediffwg.h \
+    src/widgets/timelinewg.h \
     src/widgets/mediapropswg.h
 
 FORMS += \
+    src/widgets/aggregationwg.ui \
     src/widgets/configurebuildtool.ui \
     src/widgets/exportwg.ui \
     src/widgets/fileswg.ui \
@@ -110,6 +152,7 @@ FORMS += \
     src/widgets/searchwg.ui \
     src/widgets/tabconfigwg.ui \
     src/widgets/tabelfmtwg.ui \
+    src/widgets/tablediffwg.ui \
     src/widgets/mediapropswg.ui
 
 TRANSLATIONS += \
@@ -81,6 +81,33 @@ void Common::initialize()
     if (m_initialized) {
         return;
     }
+
+    // Seed default values so they are listed in the global config window
+    if (!getConfigValue(PROBE_ENGINE_KEY, QVariant()).isValid()) {
+        setConfigValue(PROBE_ENGINE_KEY, DEFAULT_PROBE_ENGINE);
+    }
+    if (!getConfigValue(PROBE_CACHE_ENABLED_KEY, QVariant()).isValid()) {
+        setConfigValue(PROBE_CACHE_ENABLED_KEY, DEFAULT_PROBE_CACHE_ENABLED);
+    }
+    if (!getConfigValue(PROBE_CACHE_MAX_SIZE_KEY, QVariant()).isValid()) {
+        setConfigValue(PROBE_CACHE_MAX_SIZE_KEY, DEFAULT_PROBE_CACHE_MAX_SIZE);
+    }
+    if (!getConfigValue(PROBE_MEMORY_CACHE_SIZE_KEY, QVariant()).isValid()) {
+        setConfigValue(PROBE_MEMORY_CACHE_SIZE_KEY, DEFAULT_PROBE_MEMORY_CACHE_SIZE);
+    }
+    if (!getConfigValue(PROBE_MAX_JOBS_KEY, QVariant()).isValid()) {
+        setConfigValue(PROBE_MAX_JOBS_KEY, DEFAULT_PROBE_MAX_JOBS);
+    }
+    if (!getConfigValue(PAGED_TABLE_MIN_DURATION_KEY, QVariant()).isValid()) {
+        setConfigValue(PAGED_TABLE_MIN_DURATION_KEY, DEFAULT_PAGED_TABLE_MIN_DURATION);
+    }
+    if (!getConfigValue(SEARCH_INDEX_MIN_ROWS_KEY, QVariant()).isValid()) {
+        setConfigValue(SEARCH_INDEX_MIN_ROWS_KEY, DEFAULT_SEARCH_INDEX_MIN_ROWS);
+    }
+    if (!getConfigValue(TABLE_MEMORY_BUDGET_KEY, QVariant()).isValid()) {
+        setConfigValue(TABLE_MEMORY_BUDGET_KEY, DEFAULT_TABLE_MEMORY_BUDGET);
+    }
+
     m_initialized = true;
 }
 
@@ -40,6 +40,34 @@ constexpr auto CONFIGURE_BUILDER_RECENTFOLDERS_KEY = "RecentFolders";
 constexpr auto IMAGE_PREVIEW_PATH_KEY = "ImagePreviewPath";
 constexpr auto DEFAULT_IMAGE_PREVIEW_PATH = "./preview_images";
 
+// Probe engine settings
+constexpr auto PROBE_ENGINE_KEY = "General/probeEngine";
+constexpr auto PROBE_ENGINE_LIBAV = "libav";       // in-process libavformat engine
+constexpr auto PROBE_ENGINE_FFPROBE = "ffprobe";   // external ffprobe process
+constexpr auto DEFAULT_PROBE_ENGINE = PROBE_ENGINE_LIBAV;
+
+// Probe cache settings
+constexpr auto PROBE_CACHE_ENABLED_KEY = "General/probeCacheEnabled";
+constexpr auto PROBE_CACHE_MAX_SIZE_KEY = "General/probeCacheMaxSizeMB";
+constexpr bool DEFAULT_PROBE_CACHE_ENABLED = true;
+constexpr int DEFAULT_PROBE_CACHE_MAX_SIZE = 512; // MB
+constexpr auto PROBE_MEMORY_CACHE_SIZE_KEY = "General/probeMemoryCacheMB";
+constexpr int DEFAULT_PROBE_MEMORY_CACHE_SIZE = 256; // MB
+constexpr auto PROBE_MAX_JOBS_KEY = "General/probeMaxJobs";
+constexpr int DEFAULT_PROBE_MAX_JOBS = 2;
+
+// Packet/frame tables of longer files are paged by time window instead of fully loaded
+constexpr auto PAGED_TABLE_MIN_DURATION_KEY = "General/pagedTableMinDuration";
+constexpr int DEFAULT_PAGED_TABLE_MIN_DURATION = 600; // seconds
+
+// Tables with at least this many rows get a trigram search index, 0 disables it
+constexpr auto SEARCH_INDEX_MIN_ROWS_KEY = "General/searchIndexMinRows";
+constexpr int DEFAULT_SEARCH_INDEX_MIN_ROWS = 100000;
+
+// Heap budget of all info tables, the coldest columns above it move to memory mapped temp files, 0 disables it
+constexpr auto TABLE_MEMORY_BUDGET_KEY = "General/tableMemoryBudgetMB";
+constexpr int DEFAULT_TABLE_MEMORY_BUDGET = 1024; // MB
+
 // config
 /**
  * @brief Macro definitions and default values for log configuration
@@ -40,4 +40,11 @@
     #define QT_SET_FILTER_REGEXP(proxyModel, pattern) proxyModel->setFilterRegularExpression(pattern)
 #endif
 
+// QWheelEvent::pos() was replaced with position() in Qt 5.14 and removed in Qt6
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    #define QT_WHEEL_EVENT_X(event) (event)->pos().x()
+#else
+    #define QT_WHEEL_EVENT_X(event) (event)->position().x()
+#endif
+
 #endif // QTCOMPAT_H
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef ZBOUNDEDQUEUE_H
+#define ZBOUNDEDQUEUE_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+
+/**
+ * @brief Blocking producer/consumer queue with a fixed capacity
+ *
+ * push() blocks while the queue is full and pop() blocks while it is empty.
+ * close() wakes up every waiter: pending items can still be popped, further
+ * pushes are rejected so producers can release what they own.
+ */
+template <typename T>
+class ZBoundedQueue
+{
+public:
+    explicit ZBoundedQueue(int capacity = 64)
+        : m_capacity(qMax(1, capacity))
+    {}
+
+    bool push(const T &item)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_closed && m_queue.size() >= m_capacity) {
+            m_notFull.wait(&m_mutex);
+        }
+        if (m_closed) {
+            return false;
+        }
+        m_queue.enqueue(item);
+        m_notEmpty.wakeOne();
+        return true;
+    }
+
+    bool pop(T &item)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_closed && m_queue.isEmpty()) {
+            m_notEmpty.wait(&m_mutex);
+        }
+        if (m_queue.isEmpty()) {
+            return false;
+        }
+        item = m_queue.dequeue();
+        m_notFull.wakeOne();
+        return true;
+    }
+
+    void close()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_closed = true;
+        m_notEmpty.wakeAll();
+        m_notFull.wakeAll();
+    }
+
+    bool isClosed() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_closed;
+    }
+
+    // Remove everything left in the queue, e.g. to free owned pointers after an abort
+    QList<T> takeAll()
+    {
+        QMutexLocker locker(&m_mutex);
+        QList<T> items;
+        while (!m_queue.isEmpty()) {
+            items.append(m_queue.dequeue());
+        }
+        m_notFull.wakeAll();
+        return items;
+    }
+
+private:
+    mutable QMutex m_mutex;
+    QWaitCondition m_notEmpty;
+    QWaitCondition m_notFull;
+    QQueue<T> m_queue;
+    int m_capacity;
+    bool m_closed = false;
+};
+
+#endif // ZBOUNDEDQUEUE_H
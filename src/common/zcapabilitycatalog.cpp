@@ -0,0 +1,682 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "zcapabilitycatalog.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+#include <QDebug>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavcodec/bsf.h>
+#include <libavformat/avformat.h>
+#include <libavfilter/avfilter.h>
+#include <libavutil/avutil.h>
+#include <libavutil/pixdesc.h>
+#include <libavutil/samplefmt.h>
+#include <libavutil/parseutils.h>
+#include <libavutil/channel_layout.h>
+#include <libswscale/swscale.h>
+}
+
+#define CAPABILITY_SNAPSHOT_FILE "capabilities.bin"
+#define CAPABILITY_SNAPSHOT_MAGIC 0x5A434301
+#define CAPABILITY_SNAPSHOT_VERSION 1
+
+static char mediaTypeChar(AVMediaType type)
+{
+    switch (type) {
+    case AVMEDIA_TYPE_VIDEO:      return 'V';
+    case AVMEDIA_TYPE_AUDIO:      return 'A';
+    case AVMEDIA_TYPE_DATA:       return 'D';
+    case AVMEDIA_TYPE_SUBTITLE:   return 'S';
+    case AVMEDIA_TYPE_ATTACHMENT: return 'T';
+    default:                      return '?';
+    }
+}
+
+static QString flagChar(bool set, char ch)
+{
+    return QString(QChar(set ? ch : '.'));
+}
+
+// Snapshot serialization
+static QDataStream &operator<<(QDataStream &out, const ZFormatCapability &cap)
+{
+    return out << cap.name << cap.longName << cap.demuxer << cap.muxer;
+}
+
+static QDataStream &operator>>(QDataStream &in, ZFormatCapability &cap)
+{
+    return in >> cap.name >> cap.longName >> cap.demuxer >> cap.muxer;
+}
+
+static QDataStream &operator<<(QDataStream &out, const ZCodecCapability &cap)
+{
+    return out << cap.name << cap.longName << static_cast<qint8>(cap.mediaType)
+               << cap.decoder << cap.encoder << cap.intraOnly << cap.lossy << cap.lossless
+               << cap.decoders << cap.encoders;
+}
+
+static QDataStream &operator>>(QDataStream &in, ZCodecCapability &cap)
+{
+    qint8 mediaType = '?';
+    in >> cap.name >> cap.longName >> mediaType
+       >> cap.decoder >> cap.encoder >> cap.intraOnly >> cap.lossy >> cap.lossless
+       >> cap.decoders >> cap.encoders;
+    cap.mediaType = static_cast<char>(mediaType);
+    return in;
+}
+
+static QDataStream &operator<<(QDataStream &out, const ZCoderCapability &cap)
+{
+    return out << cap.name << cap.longName << cap.codec << static_cast<qint8>(cap.mediaType)
+               << cap.encoder << cap.frameThreads << cap.sliceThreads << cap.experimental
+               << cap.drawHorizBand << cap.directRendering;
+}
+
+static QDataStream &operator>>(QDataStream &in, ZCoderCapability &cap)
+{
+    qint8 mediaType = '?';
+    in >> cap.name >> cap.longName >> cap.codec >> mediaType
+       >> cap.encoder >> cap.frameThreads >> cap.sliceThreads >> cap.experimental
+       >> cap.drawHorizBand >> cap.directRendering;
+    cap.mediaType = static_cast<char>(mediaType);
+    return in;
+}
+
+static QDataStream &operator<<(QDataStream &out, const ZFilterCapability &cap)
+{
+    return out << cap.name << cap.description << cap.io << cap.timeline << cap.sliceThreads << cap.command;
+}
+
+static QDataStream &operator>>(QDataStream &in, ZFilterCapability &cap)
+{
+    return in >> cap.name >> cap.description >> cap.io >> cap.timeline >> cap.sliceThreads >> cap.command;
+}
+
+static QDataStream &operator<<(QDataStream &out, const ZPixelFormatCapability &cap)
+{
+    return out << cap.name << cap.nbComponents << cap.bitsPerPixel << cap.bitDepths
+               << cap.input << cap.output << cap.hwaccel << cap.paletted << cap.bitstream;
+}
+
+static QDataStream &operator>>(QDataStream &in, ZPixelFormatCapability &cap)
+{
+    return in >> cap.name >> cap.nbComponents >> cap.bitsPerPixel >> cap.bitDepths
+              >> cap.input >> cap.output >> cap.hwaccel >> cap.paletted >> cap.bitstream;
+}
+
+ZCapabilityCatalog::ZCapabilityCatalog()
+    : m_loaded(false)
+{
+}
+
+const ZCapabilities &ZCapabilityCatalog::capabilities()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_loaded) {
+        QElapsedTimer timer;
+        timer.start();
+
+        if (!loadSnapshot()) {
+            build();
+            saveSnapshot();
+        }
+        m_loaded = true;
+
+        qDebug() << "Capability catalogue ready in" << timer.elapsed() << "ms";
+    }
+
+    return m_capabilities;
+}
+
+QString ZCapabilityCatalog::formatsText(bool demuxers, bool muxers)
+{
+    QString title = demuxers && muxers ? "File formats" : (demuxers ? "Demuxers" : "Muxers");
+    QString text = title + ":\n"
+                   " D. = Demuxing supported\n"
+                   " .E = Muxing supported\n"
+                   " --\n";
+
+    for (const ZFormatCapability &format : capabilities().formats) {
+        bool demux = demuxers && format.demuxer;
+        bool mux = muxers && format.muxer;
+        if (!demux && !mux) {
+            continue;
+        }
+
+        text.append(QString(" %1%2 %3 %4\n")
+                        .arg(demux ? "D" : " ")
+                        .arg(mux ? "E" : " ")
+                        .arg(format.name, -15)
+                        .arg(format.longName.isEmpty() ? " " : format.longName));
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::codecsText()
+{
+    QString text = "Codecs:\n"
+                   " D..... = Decoding supported\n"
+                   " .E.... = Encoding supported\n"
+                   " ..V... = Video codec\n"
+                   " ..A... = Audio codec\n"
+                   " ..S... = Subtitle codec\n"
+                   " ..D... = Data codec\n"
+                   " ..T... = Attachment codec\n"
+                   " ...I.. = Intra frame-only codec\n"
+                   " ....L. = Lossy compression\n"
+                   " .....S = Lossless compression\n"
+                   " -------\n";
+
+    for (const ZCodecCapability &codec : capabilities().codecs) {
+        text.append(QString(" %1%2%3%4%5%6 %7 %8")
+                        .arg(flagChar(codec.decoder, 'D'))
+                        .arg(flagChar(codec.encoder, 'E'))
+                        .arg(QChar(codec.mediaType))
+                        .arg(flagChar(codec.intraOnly, 'I'))
+                        .arg(flagChar(codec.lossy, 'L'))
+                        .arg(flagChar(codec.lossless, 'S'))
+                        .arg(codec.name, -20)
+                        .arg(codec.longName));
+
+        // print implementations when their names differ from the codec name
+        if (codec.decoders.size() > 1 || (codec.decoders.size() == 1 && codec.decoders.first() != codec.name)) {
+            text.append(QString(" (decoders: %1 )").arg(codec.decoders.join(" ")));
+        }
+        if (codec.encoders.size() > 1 || (codec.encoders.size() == 1 && codec.encoders.first() != codec.name)) {
+            text.append(QString(" (encoders: %1 )").arg(codec.encoders.join(" ")));
+        }
+        text.append("\n");
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::codersText(bool encoders)
+{
+    QString text = QString("%1:\n"
+                           " V..... = Video\n"
+                           " A..... = Audio\n"
+                           " S..... = Subtitle\n"
+                           " .F.... = Frame-level multithreading\n"
+                           " ..S... = Slice-level multithreading\n"
+                           " ...X.. = Codec is experimental\n"
+                           " ....B. = Supports draw_horiz_band\n"
+                           " .....D = Supports direct rendering method 1\n"
+                           " ------\n").arg(encoders ? "Encoders" : "Decoders");
+
+    for (const ZCoderCapability &coder : capabilities().coders) {
+        if (coder.encoder != encoders) {
+            continue;
+        }
+
+        text.append(QString(" %1%2%3%4%5%6 %7 %8")
+                        .arg(QChar(coder.mediaType))
+                        .arg(flagChar(coder.frameThreads, 'F'))
+                        .arg(flagChar(coder.sliceThreads, 'S'))
+                        .arg(flagChar(coder.experimental, 'X'))
+                        .arg(flagChar(coder.drawHorizBand, 'B'))
+                        .arg(flagChar(coder.directRendering, 'D'))
+                        .arg(coder.name, -20)
+                        .arg(coder.longName));
+        if (coder.name != coder.codec) {
+            text.append(QString(" (codec %1)").arg(coder.codec));
+        }
+        text.append("\n");
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::bsfsText()
+{
+    return QString("Bitstream filters:\n%1\n\n").arg(capabilities().bsfs.join("\n"));
+}
+
+QString ZCapabilityCatalog::protocolsText()
+{
+    const ZCapabilities &caps = capabilities();
+    QString text = "Supported file protocols:\nInput:\n";
+
+    for (const QString &protocol : caps.inputProtocols) {
+        text.append(QString("  %1\n").arg(protocol));
+    }
+    text.append("Output:\n");
+    for (const QString &protocol : caps.outputProtocols) {
+        text.append(QString("  %1\n").arg(protocol));
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::filtersText()
+{
+    QString text = "Filters:\n"
+                   "  T.. = Timeline support\n"
+                   "  .S. = Slice threading\n"
+                   "  ..C = Command support\n"
+                   "  A = Audio input/output\n"
+                   "  V = Video input/output\n"
+                   "  N = Dynamic number and/or type of input/output\n"
+                   "  | = Source or sink filter\n";
+
+    for (const ZFilterCapability &filter : capabilities().filters) {
+        text.append(QString(" %1%2%3 %4 %5 %6\n")
+                        .arg(flagChar(filter.timeline, 'T'))
+                        .arg(flagChar(filter.sliceThreads, 'S'))
+                        .arg(flagChar(filter.command, 'C'))
+                        .arg(filter.name, -17)
+                        .arg(filter.io, -10)
+                        .arg(filter.description));
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::pixelFormatsText()
+{
+    QString text = "Pixel formats:\n"
+                   "I.... = Supported Input  format for conversion\n"
+                   ".O... = Supported Output format for conversion\n"
+                   "..H.. = Hardware accelerated format\n"
+                   "...P. = Paletted format\n"
+                   "....B = Bitstream format\n"
+                   "FLAGS NAME            NB_COMPONENTS BITS_PER_PIXEL BIT_DEPTHS\n"
+                   "-----\n";
+
+    for (const ZPixelFormatCapability &format : capabilities().pixelFormats) {
+        text.append(QString("%1%2%3%4%5 %6       %7            %8      %9\n")
+                        .arg(flagChar(format.input, 'I'))
+                        .arg(flagChar(format.output, 'O'))
+                        .arg(flagChar(format.hwaccel, 'H'))
+                        .arg(flagChar(format.paletted, 'P'))
+                        .arg(flagChar(format.bitstream, 'B'))
+                        .arg(format.name, -16)
+                        .arg(format.nbComponents)
+                        .arg(format.bitsPerPixel, 3)
+                        .arg(format.bitDepths));
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::sampleFormatsText()
+{
+    return capabilities().sampleFormats.join("\n") + "\n";
+}
+
+QString ZCapabilityCatalog::layoutsText()
+{
+    const ZCapabilities &caps = capabilities();
+    QString text = "Individual channels:\n"
+                   "NAME           DESCRIPTION\n";
+
+    for (const auto &channel : caps.channels) {
+        text.append(QString("%1 %2\n").arg(channel.first, -14).arg(channel.second));
+    }
+
+    text.append("\nStandard channel layouts:\n"
+                "NAME           DECOMPOSITION\n");
+    for (const auto &layout : caps.channelLayouts) {
+        text.append(QString("%1 %2\n").arg(layout.first, -14).arg(layout.second));
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::colorsText()
+{
+    QString text = QString("%1 %2\n").arg("name", -32).arg("#RRGGBB");
+
+    for (const auto &color : capabilities().colors) {
+        text.append(QString("%1 %2\n").arg(color.first, -32).arg(color.second));
+    }
+
+    return text;
+}
+
+QString ZCapabilityCatalog::versionKey()
+{
+    // compile time and runtime versions, a library upgrade invalidates the snapshot
+    return QString("avutil=%1/%2;avcodec=%3/%4;avformat=%5/%6;avfilter=%7/%8;swscale=%9/%10")
+        .arg(LIBAVUTIL_VERSION_INT).arg(avutil_version())
+        .arg(LIBAVCODEC_VERSION_INT).arg(avcodec_version())
+        .arg(LIBAVFORMAT_VERSION_INT).arg(avformat_version())
+        .arg(LIBAVFILTER_VERSION_INT).arg(avfilter_version())
+        .arg(LIBSWSCALE_VERSION_INT).arg(swscale_version());
+}
+
+QString ZCapabilityCatalog::snapshotPath() const
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)).filePath(CAPABILITY_SNAPSHOT_FILE);
+}
+
+bool ZCapabilityCatalog::loadSnapshot()
+{
+    QFile file(snapshotPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QString key;
+    stream >> magic >> version >> key;
+    if (magic != CAPABILITY_SNAPSHOT_MAGIC || version != CAPABILITY_SNAPSHOT_VERSION || key != versionKey()) {
+        qDebug() << "Capability snapshot is stale, rebuilding";
+        return false;
+    }
+
+    ZCapabilities caps;
+    stream >> caps.formats >> caps.codecs >> caps.coders >> caps.filters >> caps.pixelFormats
+           >> caps.bsfs >> caps.inputProtocols >> caps.outputProtocols >> caps.sampleFormats
+           >> caps.channels >> caps.channelLayouts >> caps.colors;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    m_capabilities = caps;
+    return true;
+}
+
+void ZCapabilityCatalog::saveSnapshot() const
+{
+    QDir().mkpath(QFileInfo(snapshotPath()).absolutePath());
+
+    QSaveFile file(snapshotPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write capability snapshot:" << snapshotPath();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    const ZCapabilities &caps = m_capabilities;
+    stream << static_cast<quint32>(CAPABILITY_SNAPSHOT_MAGIC)
+           << static_cast<quint16>(CAPABILITY_SNAPSHOT_VERSION)
+           << versionKey()
+           << caps.formats << caps.codecs << caps.coders << caps.filters << caps.pixelFormats
+           << caps.bsfs << caps.inputProtocols << caps.outputProtocols << caps.sampleFormats
+           << caps.channels << caps.channelLayouts << caps.colors;
+
+    if (!file.commit()) {
+        qWarning() << "Could not commit capability snapshot:" << snapshotPath();
+    }
+}
+
+void ZCapabilityCatalog::build()
+{
+    ZCapabilities caps;
+
+    // formats, merged by name like ffprobe -formats
+    {
+        QMap<QByteArray, ZFormatCapability> formats;
+        void *opaque = nullptr;
+
+        const AVInputFormat *ifmt = nullptr;
+        while ((ifmt = av_demuxer_iterate(&opaque))) {
+            ZFormatCapability &format = formats[ifmt->name];
+            format.name = ifmt->name;
+            format.demuxer = true;
+            if (ifmt->long_name && format.longName.isEmpty()) {
+                format.longName = ifmt->long_name;
+            }
+        }
+
+        opaque = nullptr;
+        const AVOutputFormat *ofmt = nullptr;
+        while ((ofmt = av_muxer_iterate(&opaque))) {
+            ZFormatCapability &format = formats[ofmt->name];
+            format.name = ofmt->name;
+            format.muxer = true;
+            if (ofmt->long_name && format.longName.isEmpty()) {
+                format.longName = ofmt->long_name;
+            }
+        }
+
+        caps.formats = formats.values();
+    }
+
+    // codecs and their decoders/encoders, in descriptor order
+    {
+        QHash<int, QList<const AVCodec *>> codecsById;
+        void *opaque = nullptr;
+        const AVCodec *codec = nullptr;
+        while ((codec = av_codec_iterate(&opaque))) {
+            codecsById[codec->id].append(codec);
+        }
+
+        QList<const AVCodecDescriptor *> descriptors;
+        const AVCodecDescriptor *desc = nullptr;
+        while ((desc = avcodec_descriptor_next(desc))) {
+            descriptors.append(desc);
+        }
+        std::sort(descriptors.begin(), descriptors.end(),
+                  [](const AVCodecDescriptor *a, const AVCodecDescriptor *b) {
+                      return a->type != b->type ? a->type < b->type : strcmp(a->name, b->name) < 0;
+                  });
+
+        for (const AVCodecDescriptor *descriptor : descriptors) {
+            if (strstr(descriptor->name, "_deprecated")) {
+                continue;
+            }
+
+            ZCodecCapability codecCap;
+            codecCap.name = descriptor->name;
+            codecCap.longName = descriptor->long_name ? descriptor->long_name : "";
+            codecCap.mediaType = mediaTypeChar(descriptor->type);
+            codecCap.intraOnly = descriptor->props & AV_CODEC_PROP_INTRA_ONLY;
+            codecCap.lossy = descriptor->props & AV_CODEC_PROP_LOSSY;
+            codecCap.lossless = descriptor->props & AV_CODEC_PROP_LOSSLESS;
+
+            for (const AVCodec *impl : codecsById.value(descriptor->id)) {
+                bool isEncoder = av_codec_is_encoder(impl);
+
+                ZCoderCapability coder;
+                coder.name = impl->name;
+                coder.longName = impl->long_name ? impl->long_name : "";
+                coder.codec = descriptor->name;
+                coder.mediaType = mediaTypeChar(descriptor->type);
+                coder.encoder = isEncoder;
+                coder.frameThreads = impl->capabilities & AV_CODEC_CAP_FRAME_THREADS;
+                coder.sliceThreads = impl->capabilities & AV_CODEC_CAP_SLICE_THREADS;
+                coder.experimental = impl->capabilities & AV_CODEC_CAP_EXPERIMENTAL;
+                coder.drawHorizBand = impl->capabilities & AV_CODEC_CAP_DRAW_HORIZ_BAND;
+                coder.directRendering = impl->capabilities & AV_CODEC_CAP_DR1;
+                caps.coders.append(coder);
+
+                if (isEncoder) {
+                    codecCap.encoder = true;
+                    codecCap.encoders.append(impl->name);
+                } else {
+                    codecCap.decoder = true;
+                    codecCap.decoders.append(impl->name);
+                }
+            }
+
+            caps.codecs.append(codecCap);
+        }
+    }
+
+    // filters
+    {
+        const AVFilter *filter = nullptr;
+        void *opaque = nullptr;
+        while ((filter = av_filter_iterate(&opaque))) {
+            ZFilterCapability filterCap;
+            filterCap.name = filter->name;
+            filterCap.description = filter->description ? filter->description : "";
+            filterCap.timeline = filter->flags & AVFILTER_FLAG_SUPPORT_TIMELINE;
+            filterCap.sliceThreads = filter->flags & AVFILTER_FLAG_SLICE_THREADS;
+#if LIBAVFILTER_VERSION_MAJOR < 11
+            filterCap.command = filter->process_command != nullptr;
+#endif
+
+            for (int output = 0; output < 2; ++output) {
+                if (output) {
+                    filterCap.io.append("->");
+                }
+
+                const AVFilterPad *pads = output ? filter->outputs : filter->inputs;
+#if LIBAVFILTER_VERSION_INT >= AV_VERSION_INT(8, 24, 100)
+                unsigned int nbPads = avfilter_filter_pad_count(filter, output);
+#else
+                unsigned int nbPads = avfilter_pad_count(pads);
+#endif
+                for (unsigned int i = 0; i < nbPads; ++i) {
+                    filterCap.io.append(mediaTypeChar(avfilter_pad_get_type(pads, i)));
+                }
+                if (!nbPads) {
+                    bool dynamic = output ? (filter->flags & AVFILTER_FLAG_DYNAMIC_OUTPUTS)
+                                          : (filter->flags & AVFILTER_FLAG_DYNAMIC_INPUTS);
+                    filterCap.io.append(dynamic ? 'N' : '|');
+                }
+            }
+
+            caps.filters.append(filterCap);
+        }
+    }
+
+    // pixel formats
+    {
+        const AVPixFmtDescriptor *desc = nullptr;
+        while ((desc = av_pix_fmt_desc_next(desc))) {
+            AVPixelFormat pixFmt = av_pix_fmt_desc_get_id(desc);
+
+            ZPixelFormatCapability format;
+            format.name = desc->name;
+            format.nbComponents = desc->nb_components;
+            format.bitsPerPixel = av_get_bits_per_pixel(desc);
+            format.input = sws_isSupportedInput(pixFmt);
+            format.output = sws_isSupportedOutput(pixFmt);
+            format.hwaccel = desc->flags & AV_PIX_FMT_FLAG_HWACCEL;
+            format.paletted = desc->flags & AV_PIX_FMT_FLAG_PAL;
+            format.bitstream = desc->flags & AV_PIX_FMT_FLAG_BITSTREAM;
+
+            QStringList depths;
+            for (int i = 0; i < desc->nb_components; ++i) {
+                depths.append(QString::number(desc->comp[i].depth));
+            }
+            format.bitDepths = depths.isEmpty() ? "0" : depths.join("-");
+
+            caps.pixelFormats.append(format);
+        }
+    }
+
+    // bitstream filters
+    {
+        const AVBitStreamFilter *bsf = nullptr;
+        void *opaque = nullptr;
+        while ((bsf = av_bsf_iterate(&opaque))) {
+            caps.bsfs.append(bsf->name);
+        }
+    }
+
+    // protocols
+    {
+        void *opaque = nullptr;
+        const char *name = nullptr;
+        while ((name = avio_enum_protocols(&opaque, 0))) {
+            caps.inputProtocols.append(name);
+        }
+        opaque = nullptr;
+        while ((name = avio_enum_protocols(&opaque, 1))) {
+            caps.outputProtocols.append(name);
+        }
+    }
+
+    // sample formats, first line is the header
+    {
+        char buf[128] = {0};
+        caps.sampleFormats.append(av_get_sample_fmt_string(buf, sizeof(buf), static_cast<AVSampleFormat>(-1)));
+        for (int i = 0; i < AV_SAMPLE_FMT_NB; ++i) {
+            caps.sampleFormats.append(av_get_sample_fmt_string(buf, sizeof(buf), static_cast<AVSampleFormat>(i)));
+        }
+    }
+
+    // channels and standard layouts
+    {
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 24, 100)
+        char name[128] = {0};
+        char description[128] = {0};
+        for (int i = 0; i < 63; ++i) {
+            av_channel_name(name, sizeof(name), static_cast<AVChannel>(i));
+            if (strstr(name, "USR")) {
+                continue;
+            }
+            av_channel_description(description, sizeof(description), static_cast<AVChannel>(i));
+            caps.channels.append(qMakePair(QString(name), QString(description)));
+        }
+
+        const AVChannelLayout *layout = nullptr;
+        void *opaque = nullptr;
+        while ((layout = av_channel_layout_standard(&opaque))) {
+            av_channel_layout_describe(layout, name, sizeof(name));
+
+            QStringList decomposition;
+            for (int i = 0; i < 63; ++i) {
+                if (av_channel_layout_index_from_channel(layout, static_cast<AVChannel>(i)) >= 0) {
+                    av_channel_name(description, sizeof(description), static_cast<AVChannel>(i));
+                    decomposition.append(description);
+                }
+            }
+            caps.channelLayouts.append(qMakePair(QString(name), decomposition.join("+")));
+        }
+#else
+        for (int i = 0; i < 63; ++i) {
+            const char *name = av_get_channel_name(static_cast<uint64_t>(1) << i);
+            if (!name) {
+                continue;
+            }
+            const char *description = av_get_channel_description(static_cast<uint64_t>(1) << i);
+            caps.channels.append(qMakePair(QString(name), QString(description)));
+        }
+
+        uint64_t layout = 0;
+        const char *name = nullptr;
+        for (unsigned int i = 0; !av_get_standard_channel_layout(i, &layout, &name); ++i) {
+            if (!name) {
+                continue;
+            }
+
+            QStringList decomposition;
+            for (uint64_t channel = 1; channel; channel <<= 1) {
+                if (layout & channel) {
+                    decomposition.append(av_get_channel_name(channel));
+                }
+            }
+            caps.channelLayouts.append(qMakePair(QString(name), decomposition.join("+")));
+        }
+#endif
+    }
+
+    // colors
+    {
+        const char *name = nullptr;
+        const uint8_t *rgb = nullptr;
+        for (int i = 0; (name = av_get_known_color_name(i, &rgb)); ++i) {
+            caps.colors.append(qMakePair(QString(name),
+                                         QString::asprintf("#%02x%02x%02x", rgb[0], rgb[1], rgb[2])));
+        }
+    }
+
+    m_capabilities = caps;
+}
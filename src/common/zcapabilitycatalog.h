@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef ZCAPABILITYCATALOG_H
+#define ZCAPABILITYCATALOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include <QMutex>
+
+#include "zsingleton.h"
+
+// Container formats (muxers and demuxers merged by name)
+struct ZFormatCapability
+{
+    QString name;
+    QString longName;
+    bool demuxer = false;
+    bool muxer = false;
+};
+
+// Codec descriptors with their implementations
+struct ZCodecCapability
+{
+    QString name;
+    QString longName;
+    char mediaType = '?';
+    bool decoder = false;
+    bool encoder = false;
+    bool intraOnly = false;
+    bool lossy = false;
+    bool lossless = false;
+    QStringList decoders;
+    QStringList encoders;
+};
+
+// Decoder or encoder implementation
+struct ZCoderCapability
+{
+    QString name;
+    QString longName;
+    QString codec;
+    char mediaType = '?';
+    bool encoder = false;
+    bool frameThreads = false;
+    bool sliceThreads = false;
+    bool experimental = false;
+    bool drawHorizBand = false;
+    bool directRendering = false;
+};
+
+struct ZFilterCapability
+{
+    QString name;
+    QString description;
+    QString io;
+    bool timeline = false;
+    bool sliceThreads = false;
+    bool command = false;
+};
+
+struct ZPixelFormatCapability
+{
+    QString name;
+    int nbComponents = 0;
+    int bitsPerPixel = 0;
+    QString bitDepths;
+    bool input = false;
+    bool output = false;
+    bool hwaccel = false;
+    bool paletted = false;
+    bool bitstream = false;
+};
+
+struct ZCapabilities
+{
+    QList<ZFormatCapability> formats;
+    QList<ZCodecCapability> codecs;
+    QList<ZCoderCapability> coders;
+    QList<ZFilterCapability> filters;
+    QList<ZPixelFormatCapability> pixelFormats;
+    QStringList bsfs;
+    QStringList inputProtocols;
+    QStringList outputProtocols;
+    QStringList sampleFormats;                      // av_get_sample_fmt_string lines
+    QList<QPair<QString, QString>> channels;        // name, description
+    QList<QPair<QString, QString>> channelLayouts;  // name, decomposition
+    QList<QPair<QString, QString>> colors;          // name, #rrggbb
+};
+
+/**
+ * @brief Capability catalogue built once from the libav registries
+ *
+ * Replaces the ffprobe -formats/-codecs/-filters/... subprocesses of the
+ * Basic Info menu. The catalogue is snapshotted to the config dir, keyed on
+ * the LIBAV*_VERSION_INT values, so later startups load it from disk. The
+ * text renderers reproduce the ffprobe listings, so InfoWidgets::format_data
+ * parses them unchanged.
+ */
+class ZCapabilityCatalog
+{
+    DECLARE_ZSINGLETON(ZCapabilityCatalog)
+
+public:
+    const ZCapabilities &capabilities();
+
+    QString formatsText(bool demuxers, bool muxers);
+    QString codecsText();
+    QString codersText(bool encoders);
+    QString bsfsText();
+    QString protocolsText();
+    QString filtersText();
+    QString pixelFormatsText();
+    QString sampleFormatsText();
+    QString layoutsText();
+    QString colorsText();
+
+    // Key of the linked libav versions, a snapshot is only valid for the same key
+    static QString versionKey();
+
+private:
+    ZCapabilityCatalog();
+    ~ZCapabilityCatalog() = default;
+
+    QString snapshotPath() const;
+    bool loadSnapshot();
+    void saveSnapshot() const;
+    void build();
+
+private:
+    QMutex m_mutex;
+    bool m_loaded;
+    ZCapabilities m_capabilities;
+};
+
+#endif // ZCAPABILITYCATALOG_H
@@ -2,6 +2,13 @@
 // SPDX-License-Identifier: MIT
 
 #include "zffprobe.h"
+#include "zprobeengine.h"
+#include "zframeengine.h"
+#include "zprobecache.h"
+#include "zproberesultcache.h"
+#include "zcapabilitycatalog.h"
+#include "zprobescheduler.h"
+#include "common.h"
 #include "qtcompat.h"
 #include "qdebug.h"
 #include "qrgb.h"
@@ -9,6 +16,10 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QElapsedTimer>
+#include <QHash>
+
+#include <cmath>
 
 ZFfprobe::ZFfprobe(QObject *parent)
     : QObject{parent}
@@ -30,16 +41,25 @@ QString ZFfprobe::getBuildconf()
 
 QString ZFfprobe::getFormats()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().formatsText(true, true);
+    }
     return getFFprobeCommandOutput(FORMATS);
 }
 
 QString ZFfprobe::getMuxers()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().formatsText(false, true);
+    }
     return getFFprobeCommandOutput(MUXERS);
 }
 
 QString ZFfprobe::getDemuxers()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().formatsText(true, false);
+    }
     return getFFprobeCommandOutput(DEMUXERS);
 }
 
@@ -50,51 +70,81 @@ QString ZFfprobe::getDevices()
 
 QString ZFfprobe::getCodecs()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().codecsText();
+    }
     return getFFprobeCommandOutput(CODECS);
 }
 
 QString ZFfprobe::getDecoders()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().codersText(false);
+    }
     return getFFprobeCommandOutput(DECODERS);
 }
 
 QString ZFfprobe::getEncoders()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().codersText(true);
+    }
     return getFFprobeCommandOutput(ENCODERS);
 }
 
 QString ZFfprobe::getBsfs()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().bsfsText();
+    }
     return getFFprobeCommandOutput(BSFS);
 }
 
 QString ZFfprobe::getProtocols()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().protocolsText();
+    }
     return getFFprobeCommandOutput(PROTOCOLS);
 }
 
 QString ZFfprobe::getFilters()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().filtersText();
+    }
     return getFFprobeCommandOutput(FILTERS);
 }
 
 QString ZFfprobe::getPixfmts()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().pixelFormatsText();
+    }
     return getFFprobeCommandOutput(PIX_FMTS);
 }
 
 QString ZFfprobe::getLayouts()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().layoutsText();
+    }
     return getFFprobeCommandOutput(LAYOUTS);
 }
 
 QString ZFfprobe::getSamplefmts()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().sampleFormatsText();
+    }
     return getFFprobeCommandOutput(SAMPLE_FMTS);
 }
 
 QString ZFfprobe::getColors()
 {
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        return ZCapabilityCatalog::instance().colorsText();
+    }
     return getFFprobeCommandOutput(COLORS);
 }
 
@@ -170,6 +220,555 @@ QString ZFfprobe::getBasicInfo(const QString &function, bool *sucess)
 }
 
 QString ZFfprobe::getMediaInfoJsonFormat(const QString& command, const QString& fileName)
+{
+    // memory cache -> disk cache -> probe, concurrent callers share one probe
+    QString key = cacheCommand("json", command);
+    ZProbeResult result = ZProbeResultCache::instance().fetch(fileName, key, [&]() {
+        ZProbeCache &cache = ZProbeCache::instance();
+        ZProbeResult probed;
+
+        if (!cache.lookup(fileName, key, probed.json)) {
+            probed.json = probeMediaInfoJsonFormat(command, fileName);
+            cache.store(fileName, key, probed.json);
+        }
+        probed.ok = !probed.json.isEmpty();
+        return probed;
+    });
+
+    return QString::fromUtf8(result.json);
+}
+
+bool ZFfprobe::getMediaInfoTable(const QString &command, const QString &fileName, QStringList &headers, QList<QStringList> &rows)
+{
+    QString key = cacheCommand("table", command);
+    ZProbeResult result = ZProbeResultCache::instance().fetch(fileName, key, [&]() {
+        ZProbeCache &cache = ZProbeCache::instance();
+        ZProbeResult probed;
+
+        probed.ok = cache.lookupTable(fileName, key, probed.headers, probed.rows);
+        if (!probed.ok) {
+            probed.ok = probeMediaInfoTable(command, fileName, probed.headers, probed.rows);
+            if (probed.ok) {
+                cache.storeTable(fileName, key, probed.headers, probed.rows);
+            }
+        }
+        return probed;
+    });
+
+    if (!result.ok) {
+        return false;
+    }
+
+    headers = result.headers;
+    rows = result.rows;
+    return true;
+}
+
+ZFfprobe::MediaSections ZFfprobe::probeSections(ZProbeEngine::Sections sections, const QString &fileName, const QString &streamSpecifier)
+{
+    MediaSections result;
+    result.sections = sections;
+
+    if (sections == ZProbeEngine::SECTION_NONE) {
+        return result;
+    }
+
+    // All sections in one command: one open and one header read, whichever engine serves it
+    QString command = ZProbeEngine::buildCommand(sections, streamSpecifier);
+    QByteArray json = getMediaInfoJsonFormat(command, fileName).toUtf8();
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "Failed to parse probe output:" << command << error.errorString();
+        return result;
+    }
+
+    QJsonObject root = doc.object();
+    result.format = root.value(ZProbeEngine::sectionName(ZProbeEngine::SECTION_FORMAT)).toObject();
+    result.streams = root.value(ZProbeEngine::sectionName(ZProbeEngine::SECTION_STREAMS)).toArray();
+    result.chapters = root.value(ZProbeEngine::sectionName(ZProbeEngine::SECTION_CHAPTERS)).toArray();
+    result.programs = root.value(ZProbeEngine::sectionName(ZProbeEngine::SECTION_PROGRAMS)).toArray();
+    result.packets = root.value(ZProbeEngine::sectionName(ZProbeEngine::SECTION_PACKETS)).toArray();
+    result.frames = root.value(ZProbeEngine::sectionName(ZProbeEngine::SECTION_FRAMES)).toArray();
+    result.ok = true;
+
+    return result;
+}
+
+QByteArray ZFfprobe::MediaSections::sectionJson(ZProbeEngine::Section section) const
+{
+    if (!ok || !(sections & section)) {
+        return QByteArray();
+    }
+
+    QJsonObject root;
+    QString key = ZProbeEngine::sectionName(section);
+    switch (section) {
+    case ZProbeEngine::SECTION_FORMAT:   root.insert(key, format); break;
+    case ZProbeEngine::SECTION_STREAMS:  root.insert(key, streams); break;
+    case ZProbeEngine::SECTION_CHAPTERS: root.insert(key, chapters); break;
+    case ZProbeEngine::SECTION_PROGRAMS: root.insert(key, programs); break;
+    case ZProbeEngine::SECTION_PACKETS:  root.insert(key, packets); break;
+    case ZProbeEngine::SECTION_FRAMES:   root.insert(key, frames); break;
+    default: return QByteArray();
+    }
+
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QByteArray ZFfprobe::MediaSections::toJson() const
+{
+    if (!ok) {
+        return QByteArray();
+    }
+
+    QJsonObject root;
+    if (sections & ZProbeEngine::SECTION_PACKETS) {
+        root.insert(ZProbeEngine::sectionName(ZProbeEngine::SECTION_PACKETS), packets);
+    }
+    if (sections & ZProbeEngine::SECTION_FRAMES) {
+        root.insert(ZProbeEngine::sectionName(ZProbeEngine::SECTION_FRAMES), frames);
+    }
+    if (sections & ZProbeEngine::SECTION_PROGRAMS) {
+        root.insert(ZProbeEngine::sectionName(ZProbeEngine::SECTION_PROGRAMS), programs);
+    }
+    if (sections & ZProbeEngine::SECTION_STREAMS) {
+        root.insert(ZProbeEngine::sectionName(ZProbeEngine::SECTION_STREAMS), streams);
+    }
+    if (sections & ZProbeEngine::SECTION_CHAPTERS) {
+        root.insert(ZProbeEngine::sectionName(ZProbeEngine::SECTION_CHAPTERS), chapters);
+    }
+    if (sections & ZProbeEngine::SECTION_FORMAT) {
+        root.insert(ZProbeEngine::sectionName(ZProbeEngine::SECTION_FORMAT), format);
+    }
+
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+#define TABLE_BATCH_INTERVAL 100       // ms between two batches handed to the table
+#define TABLE_BATCH_MAX_ROWS 20000      // flush early when rows come in faster than that
+
+namespace {
+
+// Collects streamed rows and hands them to the caller in batches. The first
+// batch leaves after TABLE_BATCH_INTERVAL so the table fills right away,
+// later ones are throttled so the GUI thread is not flooded. A batch is handed
+// off whole and dropped here, only the cache writer keeps a serialized copy.
+class TableBatcher
+{
+public:
+    explicit TableBatcher(const ZFfprobe::TableBatchCallback &callback, ZProbeCache::TableWriter *writer = nullptr)
+        : m_callback(callback)
+        , m_writer(writer)
+    {
+        m_timer.start();
+    }
+
+    QStringList headers;
+
+    bool add(const QStringList &row)
+    {
+        m_batch.append(row);
+        if (m_batch.size() >= TABLE_BATCH_MAX_ROWS || m_timer.elapsed() >= TABLE_BATCH_INTERVAL) {
+            return flush();
+        }
+        return !m_canceled;
+    }
+
+    bool flush()
+    {
+        if (!m_canceled && !m_batch.isEmpty()) {
+            QList<QStringList> batch;
+            batch.swap(m_batch);
+            if (m_writer) {
+                m_writer->appendRows(batch);
+            }
+            m_canceled = !m_callback(headers, batch);
+            m_started = true;
+        }
+        m_timer.restart();
+        return !m_canceled;
+    }
+
+    // Hands out the pending rows once the interval is over, even when no new row arrived
+    bool poll()
+    {
+        if (m_timer.elapsed() >= TABLE_BATCH_INTERVAL) {
+            return flush();
+        }
+        return !m_canceled;
+    }
+
+    // Forget what a failed engine read before anything was handed out
+    void reset()
+    {
+        headers.clear();
+        m_batch.clear();
+    }
+
+    bool wasCanceled() const { return m_canceled; }
+    bool started() const { return m_started; }
+
+private:
+    const ZFfprobe::TableBatchCallback &m_callback;
+    ZProbeCache::TableWriter *m_writer;
+    QList<QStringList> m_batch;
+    QElapsedTimer m_timer;
+    bool m_started = false;
+    bool m_canceled = false;
+};
+
+QString sideDataCell(int count)
+{
+    return count > 0 ? QString("[%1 items]").arg(count) : QString();
+}
+
+// side_data_list is streamed as a column up front, drop it again when nothing used it
+void dropEmptySideDataColumn(QStringList &headers, QList<QStringList> &rows)
+{
+    int column = headers.indexOf("side_data_list");
+    if (column < 0) {
+        return;
+    }
+
+    for (const QStringList &row : rows) {
+        if (column < row.size() && !row.at(column).isEmpty()) {
+            return;
+        }
+    }
+
+    headers.removeAt(column);
+    for (QStringList &row : rows) {
+        if (column < row.size()) {
+            row.removeAt(column);
+        }
+    }
+}
+
+bool streamTableFromEngine(ZProbeEngine::Sections sections, const QString &streamSpecifier,
+                           const QString &fileName, TableBatcher &batcher,
+                           double startTime = NAN, double endTime = NAN)
+{
+    if (sections == ZProbeEngine::SECTION_FRAMES) {
+        ZFrameEngine frameEngine;
+        if (!frameEngine.open(fileName, streamSpecifier)) {
+            qWarning() << "In-process frame probe failed, fall back to ffprobe:" << frameEngine.errorString();
+            return false;
+        }
+        frameEngine.setReadInterval(startTime, endTime);
+
+        batcher.headers = frameEngine.columns();
+        bool ok = frameEngine.readFrames([&](const QStringList &row) {
+            return batcher.add(row);
+        });
+        return ok && batcher.flush();
+    }
+
+    ZProbeEngine engine;
+    if (!engine.open(fileName)) {
+        qWarning() << "In-process probe failed, fall back to ffprobe:" << engine.errorString();
+        return false;
+    }
+    engine.setReadInterval(startTime, endTime);
+
+    // side_data_list is kept even when no packet has side data, the first batch
+    // leaves long before that is known and the cached table must match it
+    batcher.headers = ZProbeEngine::packetColumns() << "side_data_list";
+    bool ok = engine.readPackets(streamSpecifier, [&](const ZProbeEngine::PacketRecord &record) {
+        return batcher.add(engine.packetRecordToRow(record) << sideDataCell(record.sideDataCount));
+    });
+    return ok && batcher.flush();
+}
+
+// Parses "-of compact" lines (section|key=value|...) while ffprobe is still writing them
+bool streamTableFromProcess(const QString &command, const QString &section,
+                            const QString &fileName, TableBatcher &batcher,
+                            const QStringList &extraArgs = QStringList())
+{
+    QProcess process;
+    process.start(FFPROBE, QStringList() << HIDEBANNER <<
+                               LOGLEVEL << QUIET <<
+                               OF << COMPACT <<
+                               command.split(" ", QT_SKIP_EMPTY_PARTS) <<
+                               extraArgs <<
+                               FI << fileName);
+
+    qDebug() << process.arguments().join(" ").prepend(" ").prepend(FFPROBE);
+    if (!process.waitForStarted()) {
+        return false;
+    }
+
+    QHash<QString, int> columnIndex;
+    for (int i = 0; i < batcher.headers.size(); ++i) {
+        columnIndex.insert(batcher.headers.at(i), i);
+    }
+
+    QByteArray pending;
+    for (;;) {
+        bool running = process.state() != QProcess::NotRunning;
+        if (running) {
+            process.waitForReadyRead(TABLE_BATCH_INTERVAL);
+        }
+        pending.append(process.readAllStandardOutput());
+
+        int start = 0;
+        int end = 0;
+        while ((end = pending.indexOf('\n', start)) >= 0) {
+            QStringList fields = QString::fromUtf8(pending.constData() + start, end - start).trimmed().split('|');
+            start = end + 1;
+            if (fields.size() < 2 || fields.first() != section) {
+                continue;
+            }
+
+            QStringList row;
+            for (int i = 1; i < fields.size(); ++i) {
+                const QString &field = fields.at(i);
+                int separator = field.indexOf('=');
+                QString key = field.left(separator);
+
+                int column = columnIndex.value(key, -1);
+                if (column < 0) {
+                    column = batcher.headers.size();
+                    batcher.headers.append(key);
+                    columnIndex.insert(key, column);
+                }
+                while (row.size() <= column) {
+                    row.append(QString());
+                }
+
+                // repeated keys come from nested lists such as side data
+                QString value = separator < 0 ? QString() : field.mid(separator + 1);
+                row[column] = row.at(column).isEmpty() ? value : row.at(column) + "; " + value;
+            }
+
+            if (!batcher.add(row)) {
+                process.kill();
+                process.waitForFinished();
+                return false;
+            }
+        }
+        pending.remove(0, start);
+
+        // every pipe read is only a few rows, the batch leaves on the interval or at the end
+        bool more = running ? batcher.poll() : batcher.flush();
+        if (!more || ZProbeScheduler::isCanceled()) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+        if (!running) {
+            break;
+        }
+    }
+
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+}
+
+bool ZFfprobe::streamMediaInfoTable(const QString &command, const QString &fileName, const TableBatchCallback &callback)
+{
+    ZProbeEngine::Sections sections;
+    QString streamSpecifier;
+    if (!ZProbeEngine::parseCommand(command, &sections, &streamSpecifier)
+        || (sections != ZProbeEngine::SECTION_PACKETS && sections != ZProbeEngine::SECTION_FRAMES)) {
+        return false;
+    }
+
+    // Cached tables are complete already, hand them out in one go. Streamed tables
+    // are cached apart from whole ones, their side_data_list column is always there
+    QString key = cacheCommand("stream", command);
+    ZProbeResult cached;
+    if (ZProbeResultCache::instance().lookup(fileName, key, cached)
+        || ZProbeCache::instance().lookupTable(fileName, key, cached.headers, cached.rows)) {
+        cached.ok = true;
+        ZProbeResultCache::instance().insert(fileName, key, cached);
+        callback(cached.headers, cached.rows);
+        return true;
+    }
+
+    ZProbeCache::TableWriter writer;
+    TableBatcher batcher(callback, &writer);
+    bool ok = false;
+
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        ok = streamTableFromEngine(sections, streamSpecifier, fileName, batcher);
+    }
+    if (!ok && !batcher.started() && !batcher.wasCanceled() && !ZProbeScheduler::isCanceled()) {
+        batcher.reset();
+        QString section = sections == ZProbeEngine::SECTION_FRAMES ? "frame" : "packet";
+        ok = streamTableFromProcess(command, section, fileName, batcher);
+    }
+
+    if (batcher.wasCanceled() || ZProbeScheduler::isCanceled()) {
+        return batcher.started();
+    }
+    if (!ok) {
+        // rows handed out already belong to a truncated table, the caller reports that
+        return false;
+    }
+
+    // the rows live in the table window now, a repeat is answered from the disk
+    // cache, which then fills the memory cache as well
+    ZProbeCache::instance().storeTable(fileName, key, batcher.headers, writer);
+    return true;
+}
+
+bool ZFfprobe::getMediaInfoTableInterval(const QString &command, const QString &fileName, double startTime, double endTime,
+                                         QStringList &headers, QList<QStringList> &rows)
+{
+    ZProbeEngine::Sections sections;
+    QString streamSpecifier;
+    if (!ZProbeEngine::parseCommand(command, &sections, &streamSpecifier)
+        || (sections != ZProbeEngine::SECTION_PACKETS && sections != ZProbeEngine::SECTION_FRAMES)) {
+        return false;
+    }
+
+    // pages are collected whole, nothing is handed out before the window is read
+    QList<QStringList> collected;
+    TableBatchCallback collect = [&collected](const QStringList &, const QList<QStringList> &batch) {
+        collected += batch;
+        return true;
+    };
+    TableBatcher batcher(collect);
+    bool ok = false;
+
+    if (probeEngine() == PROBE_ENGINE_LIBAV) {
+        ok = streamTableFromEngine(sections, streamSpecifier, fileName, batcher, startTime, endTime);
+    }
+    if (!ok && !ZProbeScheduler::isCanceled()) {
+        batcher.reset();
+        collected.clear();
+        QString section = sections == ZProbeEngine::SECTION_FRAMES ? "frame" : "packet";
+        QString interval = QString("%1%%2").arg(startTime, 0, 'f', 6).arg(endTime + READ_INTERVAL_MARGIN, 0, 'f', 6);
+        ok = streamTableFromProcess(command, section, fileName, batcher, QStringList() << READ_INTERVALS << interval);
+
+        // -read_intervals starts at the keyframe before startTime, cut the window exactly
+        if (ok) {
+            int timeColumn = batcher.headers.indexOf(sections == ZProbeEngine::SECTION_FRAMES ? "best_effort_timestamp_time" : "pts_time");
+            int dtsColumn = batcher.headers.indexOf(sections == ZProbeEngine::SECTION_FRAMES ? "pts_time" : "dts_time");
+            QList<QStringList> inInterval;
+            for (const QStringList &row : qAsConst(collected)) {
+                bool valid = false;
+                double time = timeColumn >= 0 && timeColumn < row.size() ? row.at(timeColumn).toDouble(&valid) : 0.0;
+                if (!valid && dtsColumn >= 0 && dtsColumn < row.size()) {
+                    time = row.at(dtsColumn).toDouble(&valid);
+                }
+                if (valid && time >= startTime && time < endTime) {
+                    inInterval.append(row);
+                }
+            }
+            collected = inInterval;
+        }
+    }
+
+    if (!ok || ZProbeScheduler::isCanceled()) {
+        return false;
+    }
+
+    headers = batcher.headers;
+    rows = collected;
+    dropEmptySideDataColumn(headers, rows);
+    return true;
+}
+
+bool ZFfprobe::getMediaTimeRange(const QString &fileName, double *startTime, double *duration)
+{
+    MediaSections result = probeSections(ZProbeEngine::SECTION_FORMAT, fileName);
+    if (!result.ok) {
+        return false;
+    }
+
+    bool ok = false;
+    double length = result.format.value(DURATION).toString().toDouble(&ok);
+    if (!ok || length <= 0) {
+        return false;
+    }
+
+    if (startTime) {
+        *startTime = qMax(0.0, result.format.value(START_TIME).toString().toDouble());
+    }
+    if (duration) {
+        *duration = length;
+    }
+    return true;
+}
+
+QByteArray ZFfprobe::probeMediaInfoJsonFormat(const QString &command, const QString &fileName)
+{
+    if (probeEngine() == PROBE_ENGINE_LIBAV && ZProbeEngine::canHandle(command)) {
+        ZProbeEngine engine;
+        QByteArray output;
+        bool ok = engine.probe(command, fileName, output);
+
+        // an interrupted probe is incomplete and must not reach the caches
+        if (ZProbeScheduler::isCanceled()) {
+            return QByteArray();
+        }
+        if (ok) {
+            return output;
+        }
+        qWarning() << "In-process probe failed, fall back to ffprobe:" << engine.errorString();
+    }
+
+    return getMediaInfoJsonFormatFromProcess(command, fileName);
+}
+
+bool ZFfprobe::probeMediaInfoTable(const QString &command, const QString &fileName, QStringList &headers, QList<QStringList> &rows)
+{
+    ZProbeEngine::Sections sections;
+    QString streamSpecifier;
+
+    if (probeEngine() != PROBE_ENGINE_LIBAV
+        || !ZProbeEngine::parseCommand(command, &sections, &streamSpecifier)) {
+        return false;
+    }
+
+    if (sections == ZProbeEngine::SECTION_FRAMES) {
+        ZFrameEngine frameEngine;
+        if (!frameEngine.open(fileName, streamSpecifier)) {
+            qWarning() << "In-process frame probe failed, fall back to ffprobe:" << frameEngine.errorString();
+            return false;
+        }
+
+        return frameEngine.framesTable(headers, rows) && !ZProbeScheduler::isCanceled();
+    }
+
+    if (sections != ZProbeEngine::SECTION_PACKETS) {
+        return false;
+    }
+
+    ZProbeEngine engine;
+    if (!engine.open(fileName)) {
+        qWarning() << "In-process probe failed, fall back to ffprobe:" << engine.errorString();
+        return false;
+    }
+
+    return engine.packetsTable(streamSpecifier, headers, rows) && !ZProbeScheduler::isCanceled();
+}
+
+void ZFfprobe::setProbeEngine(const QString &engine)
+{
+    m_probeEngine = engine;
+}
+
+QString ZFfprobe::probeEngine() const
+{
+    if (!m_probeEngine.isEmpty()) {
+        return m_probeEngine;
+    }
+
+    return Common::instance()->getConfigValue(PROBE_ENGINE_KEY, DEFAULT_PROBE_ENGINE).toString();
+}
+
+QString ZFfprobe::cacheCommand(const QString &kind, const QString &command) const
+{
+    // e.g. "table libav -show_packets", switching the engine misses the cache
+    return QString("%1 %2 %3").arg(kind, probeEngine(), command);
+}
+
+QByteArray ZFfprobe::getMediaInfoJsonFormatFromProcess(const QString &command, const QString &fileName)
 {
     QProcess process;
     process.start(FFPROBE, QStringList() << HIDEBANNER <<
@@ -179,7 +778,16 @@ QString ZFfprobe::getMediaInfoJsonFormat(const QString& command, const QString&
                                FI  << fileName);
 
     qDebug() << process.arguments().join(" ").prepend(" ").prepend(FFPROBE);
-    process.waitForFinished(-1);
+    while (!process.waitForFinished(100)) {
+        if (process.state() == QProcess::NotRunning) {
+            break;
+        }
+        if (ZProbeScheduler::isCanceled()) {
+            process.kill();
+            process.waitForFinished();
+            return QByteArray();
+        }
+    }
     return process.readAll();
 }
 
@@ -11,6 +11,10 @@
 #include <QColor>
 #include <QRgb>
 
+#include <functional>
+
+#include "zprobeengine.h"
+
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavcodec/bsf.h>
@@ -138,6 +142,7 @@ extern "C" {
 #define INI "ini"
 #define FLAT "flat"
 #define CSV "csv"
+#define COMPACT "compact"
 
 // program
 #define SHOW_FRAMES_VIDEO "-show_frames_video"       // show frames info of video
@@ -206,6 +211,47 @@ public:
  * Media Info
  */
     Q_INVOKABLE QString getMediaInfoJsonFormat(const QString& command, const QString& fileName);           // show format/container info
+
+    // Fill packet/frame tables straight from the in-process engines, false means the caller should use the json path
+    bool getMediaInfoTable(const QString& command, const QString& fileName, QStringList& headers, QList<QStringList>& rows);
+
+    // Packet/frame table rows delivered in batches while the file is still being read,
+    // headers may grow when the ffprobe output reveals new keys. Return false to stop.
+    // A false result after batches were delivered means reading failed and the table is incomplete.
+    using TableBatchCallback = std::function<bool(const QStringList& headers, const QList<QStringList>& rows)>;
+    bool streamMediaInfoTable(const QString& command, const QString& fileName, const TableBatchCallback& callback);
+
+    // Packet/frame rows whose timestamps fall in [startTime, endTime), one page of a paged table.
+    // Pages are not cached, the caller keeps only the pages around the visible rows.
+    bool getMediaInfoTableInterval(const QString& command, const QString& fileName, double startTime, double endTime,
+                                   QStringList& headers, QList<QStringList>& rows);
+
+    // start_time and duration of the container in seconds, false when the duration is unknown
+    bool getMediaTimeRange(const QString& fileName, double *startTime, double *duration);
+
+    // One entry per requested section, filled from a single probe of the file
+    struct MediaSections {
+        bool ok = false;
+        ZProbeEngine::Sections sections;
+        QJsonObject format;
+        QJsonArray streams;
+        QJsonArray chapters;
+        QJsonArray programs;
+        QJsonArray packets;
+        QJsonArray frames;
+
+        // ffprobe style json of one section, e.g. {"streams": [...]}
+        QByteArray sectionJson(ZProbeEngine::Section section) const;
+        // All requested sections in one document
+        QByteArray toJson() const;
+    };
+
+    // Open the file once and read every requested section
+    MediaSections probeSections(ZProbeEngine::Sections sections, const QString& fileName, const QString& streamSpecifier = QString());
+
+    // Probe engine, PROBE_ENGINE_LIBAV or PROBE_ENGINE_FFPROBE, empty means follow the global config
+    void setProbeEngine(const QString& engine);
+    QString probeEngine() const;
     
     // Stream info methods
     struct StreamInfo {
@@ -238,8 +284,16 @@ private:
     int get_codecs_sorted(const AVCodecDescriptor ***rcodecs);
     char get_media_type_char(enum AVMediaType type);
     static int compare_codec_desc(const void *a, const void *b);
+private:
+    QByteArray probeMediaInfoJsonFormat(const QString& command, const QString& fileName);
+    bool probeMediaInfoTable(const QString& command, const QString& fileName, QStringList& headers, QList<QStringList>& rows);
+    QByteArray getMediaInfoJsonFormatFromProcess(const QString& command, const QString& fileName);
+    // Key of a probe result in both caches, the engines differ in columns and values
+    QString cacheCommand(const QString& kind, const QString& command) const;
+
 private:
     QString cacheVersion;
+    QString m_probeEngine;
 };
 
 #endif // ZFFPROBE_H
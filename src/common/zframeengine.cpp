@@ -0,0 +1,604 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "zframeengine.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <cmath>
+
+extern "C" {
+#include <libavutil/pixdesc.h>
+#include <libavutil/samplefmt.h>
+#include <libavutil/channel_layout.h>
+}
+
+#define PACKET_QUEUE_SIZE 256
+#define FRAME_QUEUE_SIZE 64
+
+#ifdef AV_CODEC_FLAG_COPY_OPAQUE
+// frame->pkt_pos/pkt_size are deprecated, forward them from the packet like ffprobe does
+struct FramePacketProps {
+    int64_t pktPos;
+    int pktSize;
+};
+#endif
+
+ZFrameEngine::ZFrameEngine()
+    : m_threadCount(0)
+    , m_abort(0)
+{
+}
+
+ZFrameEngine::~ZFrameEngine()
+{
+    close();
+}
+
+bool ZFrameEngine::open(const QString &fileName, const QString &streamSpecifier)
+{
+    close();
+    m_errorString.clear();
+
+    if (!m_probe.open(fileName)) {
+        m_errorString = m_probe.errorString();
+        return false;
+    }
+
+    AVFormatContext *fmtCtx = m_probe.formatContext();
+    int threadCount = m_threadCount > 0 ? m_threadCount : QThread::idealThreadCount();
+    bool hasVideo = false;
+    bool hasAudio = false;
+
+    for (unsigned int i = 0; i < fmtCtx->nb_streams; ++i) {
+        AVStream *stream = fmtCtx->streams[i];
+        AVMediaType type = stream->codecpar->codec_type;
+
+        // unselected streams are dropped by the demuxer already
+        stream->discard = AVDISCARD_ALL;
+
+        if ((type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO)
+            || !m_probe.matchStream(stream, streamSpecifier)) {
+            continue;
+        }
+
+        const AVCodec *codec = avcodec_find_decoder(stream->codecpar->codec_id);
+        if (!codec) {
+            qWarning() << "No decoder for stream" << i;
+            continue;
+        }
+
+        AVCodecContext *codecCtx = avcodec_alloc_context3(codec);
+        if (!codecCtx) {
+            continue;
+        }
+
+        if (avcodec_parameters_to_context(codecCtx, stream->codecpar) < 0) {
+            avcodec_free_context(&codecCtx);
+            continue;
+        }
+
+        codecCtx->pkt_timebase = stream->time_base;
+        codecCtx->thread_count = threadCount;
+        codecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+#ifdef AV_CODEC_FLAG_COPY_OPAQUE
+        codecCtx->flags |= AV_CODEC_FLAG_COPY_OPAQUE;
+#endif
+
+        if (avcodec_open2(codecCtx, codec, nullptr) < 0) {
+            qWarning() << "Could not open decoder for stream" << i;
+            avcodec_free_context(&codecCtx);
+            continue;
+        }
+
+        stream->discard = AVDISCARD_DEFAULT;
+        m_decoders.insert(i, codecCtx);
+        hasVideo |= type == AVMEDIA_TYPE_VIDEO;
+        hasAudio |= type == AVMEDIA_TYPE_AUDIO;
+    }
+
+    if (m_decoders.isEmpty()) {
+        m_errorString = QString("No decodable stream selected in %1").arg(fileName);
+        close();
+        return false;
+    }
+
+    // Common fields, then media specific fields, then the rest in sorted order
+    m_fields = {
+        FIELD_MEDIA_TYPE, FIELD_STREAM_INDEX, FIELD_KEY_FRAME,
+        FIELD_PKT_DTS, FIELD_PKT_DTS_TIME,
+        FIELD_BEST_EFFORT_TIMESTAMP, FIELD_BEST_EFFORT_TIMESTAMP_TIME,
+        FIELD_PKT_POS, FIELD_PKT_SIZE
+    };
+    if (hasVideo) {
+        m_fields << FIELD_WIDTH << FIELD_HEIGHT << FIELD_PIX_FMT << FIELD_SAMPLE_ASPECT_RATIO
+                 << FIELD_PICT_TYPE << FIELD_INTERLACED_FRAME << FIELD_TOP_FIELD_FIRST
+                 << FIELD_REPEAT_PICT << FIELD_CHROMA_LOCATION;
+    }
+    if (hasAudio) {
+        m_fields << FIELD_SAMPLE_FMT << FIELD_NB_SAMPLES << FIELD_CHANNELS << FIELD_CHANNEL_LAYOUT;
+    }
+    if (hasVideo) {
+        m_fields << FIELD_COLOR_PRIMARIES << FIELD_COLOR_RANGE << FIELD_COLOR_SPACE << FIELD_COLOR_TRANSFER;
+    }
+    m_fields << FIELD_DURATION << FIELD_DURATION_TIME << FIELD_PTS << FIELD_PTS_TIME << FIELD_SIDE_DATA_LIST;
+
+    return true;
+}
+
+void ZFrameEngine::close()
+{
+    for (AVCodecContext *codecCtx : m_decoders) {
+        avcodec_free_context(&codecCtx);
+    }
+    m_decoders.clear();
+    m_fields.clear();
+    m_probe.close();
+}
+
+QString ZFrameEngine::errorString() const
+{
+    return m_errorString;
+}
+
+void ZFrameEngine::setThreadCount(int count)
+{
+    m_threadCount = count;
+}
+
+void ZFrameEngine::setReadInterval(double startTime, double endTime)
+{
+    m_probe.setReadInterval(startTime, endTime);
+}
+
+QStringList ZFrameEngine::columns() const
+{
+    QStringList headers;
+    for (FrameField field : m_fields) {
+        headers.append(fieldName(field));
+    }
+    return headers;
+}
+
+bool ZFrameEngine::readFrames(const RowCallback &callback)
+{
+    if (m_decoders.isEmpty()) {
+        m_errorString = "No media file opened";
+        return false;
+    }
+
+    m_abort.storeRelease(0);
+    m_demuxError.clear();
+    m_decodeError.clear();
+
+    ZBoundedQueue<AVPacket *> packets(PACKET_QUEUE_SIZE);
+    ZBoundedQueue<DecodedFrame> frames(FRAME_QUEUE_SIZE);
+
+    // demux and decode get their own threads, rows are extracted on the calling thread
+    QThreadPool pool;
+    pool.setMaxThreadCount(2);
+    QFuture<void> demuxer = QtConcurrent::run(&pool, [&]() { demuxLoop(packets); });
+    QFuture<void> decoder = QtConcurrent::run(&pool, [&]() { decodeLoop(packets, frames); });
+
+    DecodedFrame decoded;
+    while (frames.pop(decoded)) {
+        // frames decoded from the keyframe before the interval are dropped here
+        if (!frameInInterval(decoded.streamIndex, decoded.frame)) {
+            av_frame_free(&decoded.frame);
+            continue;
+        }
+
+        bool keepReading = callback(frameToRow(decoded.streamIndex, decoded.frame));
+        av_frame_free(&decoded.frame);
+
+        if (!keepReading) {
+            m_abort.storeRelease(1);
+            packets.close();
+            frames.close();
+            break;
+        }
+    }
+
+    demuxer.waitForFinished();
+    decoder.waitForFinished();
+
+    // Release whatever was still queued after an abort
+    for (AVPacket *pkt : packets.takeAll()) {
+        av_packet_free(&pkt);
+    }
+    for (DecodedFrame pending : frames.takeAll()) {
+        av_frame_free(&pending.frame);
+    }
+
+    // the rows read before the error stay with the caller, the table is not complete
+    if (!m_demuxError.isEmpty() || !m_decodeError.isEmpty()) {
+        m_errorString = !m_demuxError.isEmpty() ? m_demuxError : m_decodeError;
+        return false;
+    }
+    return true;
+}
+
+bool ZFrameEngine::framesTable(QStringList &headers, QList<QStringList> &rows)
+{
+    headers = columns();
+    rows.clear();
+
+    int sideDataColumn = headers.indexOf("side_data_list");
+    bool hasSideData = false;
+
+    bool ok = readFrames([&](const QStringList &row) {
+        hasSideData |= !row.at(sideDataColumn).isEmpty();
+        rows.append(row);
+        return true;
+    });
+
+    // side_data_list only shows up in ffprobe output when a frame carries side data
+    if (!hasSideData) {
+        headers.removeAt(sideDataColumn);
+        for (QStringList &row : rows) {
+            row.removeAt(sideDataColumn);
+        }
+    }
+
+    return ok;
+}
+
+bool ZFrameEngine::frameInInterval(int streamIndex, const AVFrame *frame) const
+{
+    if (!m_probe.hasReadInterval()) {
+        return true;
+    }
+
+    AVRational timeBase = m_probe.formatContext()->streams[streamIndex]->time_base;
+    int64_t ts = frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+    double time = ZProbeEngine::timestampToSeconds(ts, timeBase);
+
+    return !std::isnan(time) && time >= m_probe.intervalStart() && time < m_probe.intervalEnd();
+}
+
+void ZFrameEngine::demuxLoop(ZBoundedQueue<AVPacket *> &packets)
+{
+    AVFormatContext *fmtCtx = m_probe.formatContext();
+    AVPacket *pkt = av_packet_alloc();
+
+    bool interval = m_probe.hasReadInterval();
+    if (interval) {
+        m_probe.seekToIntervalStart();
+    }
+
+    int ret = 0;
+    while (pkt && !m_abort.loadAcquire() && (ret = av_read_frame(fmtCtx, pkt)) >= 0) {
+        if (!m_decoders.contains(pkt->stream_index)) {
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        if (interval) {
+            AVRational timeBase = fmtCtx->streams[pkt->stream_index]->time_base;
+            double time = ZProbeEngine::timestampToSeconds(pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts, timeBase);
+            if (!std::isnan(time) && time >= m_probe.intervalEnd() + READ_INTERVAL_MARGIN) {
+                av_packet_unref(pkt);
+                break;
+            }
+        }
+
+#ifdef AV_CODEC_FLAG_COPY_OPAQUE
+        pkt->opaque_ref = av_buffer_allocz(sizeof(FramePacketProps));
+        if (pkt->opaque_ref) {
+            FramePacketProps *props = reinterpret_cast<FramePacketProps *>(pkt->opaque_ref->data);
+            props->pktPos = pkt->pos;
+            props->pktSize = pkt->size;
+        }
+#endif
+
+        AVPacket *queued = av_packet_alloc();
+        if (!queued) {
+            av_packet_unref(pkt);
+            m_demuxError = "Could not allocate packet";
+            break;
+        }
+        av_packet_move_ref(queued, pkt);
+
+        if (!packets.push(queued)) {
+            av_packet_free(&queued);
+            break;
+        }
+    }
+
+    if (!pkt) {
+        m_demuxError = "Could not allocate packet";
+    } else if (ret < 0 && ret != AVERROR_EOF && !(ret == AVERROR_EXIT && m_probe.isCanceled())) {
+        // only the end of the file or a cancel is a clean stop, like ZProbeEngine::readPackets()
+        char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        m_demuxError = QString("Could not read packets: %1").arg(errbuf);
+    }
+
+    av_packet_free(&pkt);
+    packets.close();
+}
+
+void ZFrameEngine::decodeLoop(ZBoundedQueue<AVPacket *> &packets, ZBoundedQueue<DecodedFrame> &frames)
+{
+    AVPacket *pkt = nullptr;
+    while (packets.pop(pkt)) {
+        int streamIndex = pkt->stream_index;
+        bool ok = !m_abort.loadAcquire()
+                  && decodePacket(m_decoders.value(streamIndex), streamIndex, pkt, frames);
+        av_packet_free(&pkt);
+
+        if (!ok) {
+            if (!m_decodeError.isEmpty()) {
+                // nobody pops the packets any more, release the demuxer
+                m_abort.storeRelease(1);
+                packets.close();
+            }
+            break;
+        }
+    }
+
+    // Drain the frames still buffered by the frame threads
+    if (!m_abort.loadAcquire()) {
+        for (auto it = m_decoders.constBegin(); it != m_decoders.constEnd(); ++it) {
+            if (!decodePacket(it.value(), it.key(), nullptr, frames)) {
+                break;
+            }
+        }
+    }
+
+    frames.close();
+}
+
+bool ZFrameEngine::decodePacket(AVCodecContext *codecCtx, int streamIndex, const AVPacket *pkt,
+                                ZBoundedQueue<DecodedFrame> &frames)
+{
+    int ret = avcodec_send_packet(codecCtx, pkt);
+    if (ret < 0 && ret != AVERROR_EOF) {
+        // broken packets are skipped, like ffprobe does
+        return true;
+    }
+
+    while (true) {
+        AVFrame *frame = av_frame_alloc();
+        if (!frame) {
+            m_decodeError = "Could not allocate frame";
+            return false;
+        }
+
+        ret = avcodec_receive_frame(codecCtx, frame);
+        if (ret < 0) {
+            av_frame_free(&frame);
+            // corrupt frames are skipped like broken packets, anything else stops the decoder
+            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF || ret == AVERROR_INVALIDDATA) {
+                break;
+            }
+            char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+            av_strerror(ret, errbuf, sizeof(errbuf));
+            m_decodeError = QString("Could not decode stream %1: %2").arg(streamIndex).arg(errbuf);
+            return false;
+        }
+
+        DecodedFrame decoded;
+        decoded.streamIndex = streamIndex;
+        decoded.frame = frame;
+        if (!frames.push(decoded)) {
+            av_frame_free(&frame);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QStringList ZFrameEngine::frameToRow(int streamIndex, const AVFrame *frame) const
+{
+    QStringList row;
+    row.reserve(m_fields.size());
+
+    for (FrameField field : m_fields) {
+        row.append(fieldValue(field, streamIndex, frame));
+    }
+
+    return row;
+}
+
+QString ZFrameEngine::fieldValue(FrameField field, int streamIndex, const AVFrame *frame) const
+{
+    AVStream *stream = m_probe.formatContext()->streams[streamIndex];
+    AVMediaType type = stream->codecpar->codec_type;
+    AVRational timeBase = stream->time_base;
+    bool isVideo = type == AVMEDIA_TYPE_VIDEO;
+    bool isAudio = type == AVMEDIA_TYPE_AUDIO;
+
+    switch (field) {
+    case FIELD_MEDIA_TYPE: {
+        const char *mediaType = av_get_media_type_string(type);
+        return mediaType ? mediaType : "unknown";
+    }
+    case FIELD_STREAM_INDEX:
+        return QString::number(streamIndex);
+    case FIELD_KEY_FRAME:
+#ifdef AV_FRAME_FLAG_KEY
+        return QString::number((frame->flags & AV_FRAME_FLAG_KEY) ? 1 : 0);
+#else
+        return QString::number(frame->key_frame);
+#endif
+    case FIELD_PKT_DTS:
+        return frame->pkt_dts != AV_NOPTS_VALUE ? QString::number(frame->pkt_dts) : "";
+    case FIELD_PKT_DTS_TIME:
+        return frame->pkt_dts != AV_NOPTS_VALUE ? ZProbeEngine::timeToString(frame->pkt_dts, timeBase) : "";
+    case FIELD_BEST_EFFORT_TIMESTAMP:
+        return frame->best_effort_timestamp != AV_NOPTS_VALUE ?
+                   QString::number(frame->best_effort_timestamp) : "";
+    case FIELD_BEST_EFFORT_TIMESTAMP_TIME:
+        return frame->best_effort_timestamp != AV_NOPTS_VALUE ?
+                   ZProbeEngine::timeToString(frame->best_effort_timestamp, timeBase) : "";
+    case FIELD_PKT_POS:
+    case FIELD_PKT_SIZE: {
+#ifdef AV_CODEC_FLAG_COPY_OPAQUE
+        if (!frame->opaque_ref) {
+            return "";
+        }
+        const FramePacketProps *props = reinterpret_cast<const FramePacketProps *>(frame->opaque_ref->data);
+        int64_t pktPos = props->pktPos;
+        int pktSize = props->pktSize;
+#else
+        int64_t pktPos = frame->pkt_pos;
+        int pktSize = frame->pkt_size;
+#endif
+        if (field == FIELD_PKT_POS) {
+            return pktPos != -1 ? QString::number(pktPos) : "";
+        }
+        return pktSize >= 0 ? QString::number(pktSize) : "";
+    }
+    case FIELD_DURATION:
+    case FIELD_DURATION_TIME: {
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 30, 100)
+        int64_t duration = frame->duration;
+#else
+        int64_t duration = frame->pkt_duration;
+#endif
+        if (field == FIELD_DURATION) {
+            return QString::number(duration);
+        }
+        return ZProbeEngine::timeToString(duration, timeBase);
+    }
+    case FIELD_PTS:
+        return frame->pts != AV_NOPTS_VALUE ? QString::number(frame->pts) : "";
+    case FIELD_PTS_TIME:
+        return frame->pts != AV_NOPTS_VALUE ? ZProbeEngine::timeToString(frame->pts, timeBase) : "";
+    case FIELD_SIDE_DATA_LIST:
+        return frame->nb_side_data > 0 ? QString("[%1 items]").arg(frame->nb_side_data) : "";
+    default:
+        break;
+    }
+
+    if (isVideo) {
+        switch (field) {
+        case FIELD_WIDTH:
+            return QString::number(frame->width);
+        case FIELD_HEIGHT:
+            return QString::number(frame->height);
+        case FIELD_PIX_FMT: {
+            const char *pixFmt = av_get_pix_fmt_name(static_cast<AVPixelFormat>(frame->format));
+            return pixFmt ? pixFmt : "";
+        }
+        case FIELD_SAMPLE_ASPECT_RATIO:
+            return frame->sample_aspect_ratio.num ?
+                       ZProbeEngine::rationalToString(frame->sample_aspect_ratio, ":") : "";
+        case FIELD_PICT_TYPE:
+            return QString(av_get_picture_type_char(frame->pict_type));
+        case FIELD_INTERLACED_FRAME:
+#ifdef AV_FRAME_FLAG_INTERLACED
+            return QString::number((frame->flags & AV_FRAME_FLAG_INTERLACED) ? 1 : 0);
+#else
+            return QString::number(frame->interlaced_frame);
+#endif
+        case FIELD_TOP_FIELD_FIRST:
+#ifdef AV_FRAME_FLAG_TOP_FIELD_FIRST
+            return QString::number((frame->flags & AV_FRAME_FLAG_TOP_FIELD_FIRST) ? 1 : 0);
+#else
+            return QString::number(frame->top_field_first);
+#endif
+        case FIELD_REPEAT_PICT:
+            return QString::number(frame->repeat_pict);
+        case FIELD_CHROMA_LOCATION: {
+            const char *location = av_chroma_location_name(frame->chroma_location);
+            return location ? location : "unspecified";
+        }
+        case FIELD_COLOR_PRIMARIES:
+            return frame->color_primaries != AVCOL_PRI_UNSPECIFIED ?
+                       av_color_primaries_name(frame->color_primaries) : "";
+        case FIELD_COLOR_RANGE:
+            return frame->color_range != AVCOL_RANGE_UNSPECIFIED ?
+                       av_color_range_name(frame->color_range) : "";
+        case FIELD_COLOR_SPACE:
+            return frame->colorspace != AVCOL_SPC_UNSPECIFIED ?
+                       av_color_space_name(frame->colorspace) : "";
+        case FIELD_COLOR_TRANSFER:
+            return frame->color_trc != AVCOL_TRC_UNSPECIFIED ?
+                       av_color_transfer_name(frame->color_trc) : "";
+        default:
+            break;
+        }
+    }
+
+    if (isAudio) {
+        switch (field) {
+        case FIELD_SAMPLE_FMT: {
+            const char *sampleFmt = av_get_sample_fmt_name(static_cast<AVSampleFormat>(frame->format));
+            return sampleFmt ? sampleFmt : "";
+        }
+        case FIELD_NB_SAMPLES:
+            return QString::number(frame->nb_samples);
+        case FIELD_CHANNELS:
+        case FIELD_CHANNEL_LAYOUT: {
+            char layout[128] = {0};
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 24, 100)
+            if (field == FIELD_CHANNELS) {
+                return QString::number(frame->ch_layout.nb_channels);
+            }
+            if (frame->ch_layout.order != AV_CHANNEL_ORDER_UNSPEC
+                && av_channel_layout_describe(&frame->ch_layout, layout, sizeof(layout)) > 0) {
+                return layout;
+            }
+#else
+            if (field == FIELD_CHANNELS) {
+                return QString::number(frame->channels);
+            }
+            if (frame->channel_layout) {
+                av_get_channel_layout_string(layout, sizeof(layout), frame->channels, frame->channel_layout);
+                return layout;
+            }
+#endif
+            return "unknown";
+        }
+        default:
+            break;
+        }
+    }
+
+    return "";
+}
+
+const char *ZFrameEngine::fieldName(FrameField field)
+{
+    switch (field) {
+    case FIELD_MEDIA_TYPE:                  return "media_type";
+    case FIELD_STREAM_INDEX:                return "stream_index";
+    case FIELD_KEY_FRAME:                   return "key_frame";
+    case FIELD_PKT_DTS:                     return "pkt_dts";
+    case FIELD_PKT_DTS_TIME:                return "pkt_dts_time";
+    case FIELD_BEST_EFFORT_TIMESTAMP:       return "best_effort_timestamp";
+    case FIELD_BEST_EFFORT_TIMESTAMP_TIME:  return "best_effort_timestamp_time";
+    case FIELD_PKT_POS:                     return "pkt_pos";
+    case FIELD_PKT_SIZE:                    return "pkt_size";
+    case FIELD_WIDTH:                       return "width";
+    case FIELD_HEIGHT:                      return "height";
+    case FIELD_PIX_FMT:                     return "pix_fmt";
+    case FIELD_SAMPLE_ASPECT_RATIO:         return "sample_aspect_ratio";
+    case FIELD_PICT_TYPE:                   return "pict_type";
+    case FIELD_INTERLACED_FRAME:            return "interlaced_frame";
+    case FIELD_TOP_FIELD_FIRST:             return "top_field_first";
+    case FIELD_REPEAT_PICT:                 return "repeat_pict";
+    case FIELD_CHROMA_LOCATION:             return "chroma_location";
+    case FIELD_SAMPLE_FMT:                  return "sample_fmt";
+    case FIELD_NB_SAMPLES:                  return "nb_samples";
+    case FIELD_CHANNELS:                    return "channels";
+    case FIELD_CHANNEL_LAYOUT:              return "channel_layout";
+    case FIELD_COLOR_PRIMARIES:             return "color_primaries";
+    case FIELD_COLOR_RANGE:                 return "color_range";
+    case FIELD_COLOR_SPACE:                 return "color_space";
+    case FIELD_COLOR_TRANSFER:              return "color_transfer";
+    case FIELD_DURATION:                    return "duration";
+    case FIELD_DURATION_TIME:               return "duration_time";
+    case FIELD_PTS:                         return "pts";
+    case FIELD_PTS_TIME:                    return "pts_time";
+    case FIELD_SIDE_DATA_LIST:              return "side_data_list";
+    }
+
+    return "";
+}
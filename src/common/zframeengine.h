@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef ZFRAMEENGINE_H
+#define ZFRAMEENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QAtomicInt>
+
+#include <functional>
+
+#include "zprobeengine.h"
+#include "zboundedqueue.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+/**
+ * @brief Multi-threaded in-process replacement for ffprobe -show_frames
+ *
+ * Demuxing, decoding and row extraction run on separate threads connected by
+ * bounded queues. The decoders use libavcodec frame and slice threading sized
+ * to the machine, so throughput scales with the number of cores.
+ */
+class ZFrameEngine
+{
+public:
+    // Return false from the callback to stop decoding
+    using RowCallback = std::function<bool(const QStringList &row)>;
+
+    ZFrameEngine();
+    ~ZFrameEngine();
+
+    ZFrameEngine(const ZFrameEngine&) = delete;
+    ZFrameEngine& operator=(const ZFrameEngine&) = delete;
+
+    /**
+     * @brief Open the file and a decoder for each selected stream
+     * @param fileName Media file
+     * @param streamSpecifier ffprobe stream specifier, empty selects all streams
+     */
+    bool open(const QString &fileName, const QString &streamSpecifier = QString());
+    void close();
+    QString errorString() const;
+
+    // Decoder threads per stream, 0 means QThread::idealThreadCount()
+    void setThreadCount(int count);
+
+    // Only emit frames with timestamps in [startTime, endTime), see ZProbeEngine::setReadInterval()
+    void setReadInterval(double startTime, double endTime);
+
+    // Columns follow the -show_frames json keys in TabelFormatWG order
+    QStringList columns() const;
+
+    /**
+     * @brief Decode every selected stream and emit one row per frame
+     * @return false on open, demuxer or decoder errors, the rows handed out
+     *         until then are a truncated table
+     */
+    bool readFrames(const RowCallback &callback);
+    bool framesTable(QStringList &headers, QList<QStringList> &rows);
+
+private:
+    enum FrameField {
+        FIELD_MEDIA_TYPE,
+        FIELD_STREAM_INDEX,
+        FIELD_KEY_FRAME,
+        FIELD_PKT_DTS,
+        FIELD_PKT_DTS_TIME,
+        FIELD_BEST_EFFORT_TIMESTAMP,
+        FIELD_BEST_EFFORT_TIMESTAMP_TIME,
+        FIELD_PKT_POS,
+        FIELD_PKT_SIZE,
+        FIELD_WIDTH,
+        FIELD_HEIGHT,
+        FIELD_PIX_FMT,
+        FIELD_SAMPLE_ASPECT_RATIO,
+        FIELD_PICT_TYPE,
+        FIELD_INTERLACED_FRAME,
+        FIELD_TOP_FIELD_FIRST,
+        FIELD_REPEAT_PICT,
+        FIELD_CHROMA_LOCATION,
+        FIELD_SAMPLE_FMT,
+        FIELD_NB_SAMPLES,
+        FIELD_CHANNELS,
+        FIELD_CHANNEL_LAYOUT,
+        FIELD_COLOR_PRIMARIES,
+        FIELD_COLOR_RANGE,
+        FIELD_COLOR_SPACE,
+        FIELD_COLOR_TRANSFER,
+        FIELD_DURATION,
+        FIELD_DURATION_TIME,
+        FIELD_PTS,
+        FIELD_PTS_TIME,
+        FIELD_SIDE_DATA_LIST
+    };
+
+    // Decoded frame tagged with its stream, owned by whoever holds it
+    struct DecodedFrame {
+        int streamIndex = -1;
+        AVFrame *frame = nullptr;
+    };
+
+    void demuxLoop(ZBoundedQueue<AVPacket *> &packets);
+    void decodeLoop(ZBoundedQueue<AVPacket *> &packets, ZBoundedQueue<DecodedFrame> &frames);
+    bool decodePacket(AVCodecContext *codecCtx, int streamIndex, const AVPacket *pkt,
+                      ZBoundedQueue<DecodedFrame> &frames);
+    QStringList frameToRow(int streamIndex, const AVFrame *frame) const;
+    bool frameInInterval(int streamIndex, const AVFrame *frame) const;
+    QString fieldValue(FrameField field, int streamIndex, const AVFrame *frame) const;
+
+    static const char *fieldName(FrameField field);
+
+private:
+    ZProbeEngine m_probe;
+    QMap<int, AVCodecContext *> m_decoders;
+    QVector<FrameField> m_fields;
+    int m_threadCount;
+    QString m_errorString;
+    // Written by the demux and decode threads only, read once both finished
+    QString m_demuxError;
+    QString m_decodeError;
+
+    QAtomicInt m_abort;
+};
+
+#endif // ZFRAMEENGINE_H
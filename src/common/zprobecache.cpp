@@ -0,0 +1,344 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "zprobecache.h"
+#include "common.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+#define PROBE_CACHE_DIR "probe_cache"
+#define PROBE_CACHE_SUFFIX ".zpc"
+#define PROBE_CACHE_MAGIC 0x5A504301
+#define PROBE_CACHE_VERSION 1
+#define PROBE_CACHE_SAMPLE_SIZE (64 * 1024)
+
+ZProbeCache::ZProbeCache()
+{
+}
+
+bool ZProbeCache::isEnabled() const
+{
+    return Common::instance()->getConfigValue(PROBE_CACHE_ENABLED_KEY, DEFAULT_PROBE_CACHE_ENABLED).toBool();
+}
+
+QString ZProbeCache::cacheDir() const
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)).filePath(PROBE_CACHE_DIR);
+}
+
+bool ZProbeCache::lookup(const QString &fileName, const QString &command, QByteArray &output)
+{
+    QByteArray payload;
+    if (!readEntry(fileName, command, ENTRY_JSON, payload)) {
+        return false;
+    }
+
+    output = payload;
+    return true;
+}
+
+void ZProbeCache::store(const QString &fileName, const QString &command, const QByteArray &output)
+{
+    writeEntry(fileName, command, ENTRY_JSON, output);
+}
+
+bool ZProbeCache::lookupTable(const QString &fileName, const QString &command,
+                              QStringList &headers, QList<QStringList> &rows)
+{
+    QByteArray payload;
+    if (!readEntry(fileName, command, ENTRY_TABLE, payload)) {
+        return false;
+    }
+
+    QDataStream stream(payload);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream >> headers >> rows;
+    return stream.status() == QDataStream::Ok;
+}
+
+void ZProbeCache::storeTable(const QString &fileName, const QString &command,
+                             const QStringList &headers, const QList<QStringList> &rows)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << headers << rows;
+
+    writeEntry(fileName, command, ENTRY_TABLE, payload);
+}
+
+void ZProbeCache::storeTable(const QString &fileName, const QString &command,
+                             const QStringList &headers, const TableWriter &writer)
+{
+    if (!writer.isValid()) {
+        return;
+    }
+
+    // same layout as headers << rows, the rows are serialized already
+    QByteArray payload;
+    payload.reserve(writer.m_rows.size() + 4096);
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << headers << writer.m_count;
+    stream.writeRawData(writer.m_rows.constData(), writer.m_rows.size());
+
+    writeEntry(fileName, command, ENTRY_TABLE, payload);
+}
+
+ZProbeCache::TableWriter::TableWriter()
+    : m_count(0)
+    // writeEntry() stores at most a quarter of the cache, the serialized rows are held
+    // to that size before compression so the writer never outgrows a storable entry
+    , m_maxBytes(ZProbeCache::instance().maxCacheBytes() / 4)
+    , m_valid(ZProbeCache::instance().isEnabled())
+{
+}
+
+void ZProbeCache::TableWriter::appendRows(const QList<QStringList> &rows)
+{
+    if (!m_valid) {
+        return;
+    }
+
+    QDataStream stream(&m_rows, QIODevice::WriteOnly | QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_12);
+    for (const QStringList &row : rows) {
+        stream << row;
+    }
+    m_count += static_cast<quint32>(rows.size());
+
+    if (m_rows.size() > m_maxBytes) {
+        qDebug() << "Streamed table too large for the probe cache:" << m_count << "rows";
+        m_rows = QByteArray();
+        m_valid = false;
+    }
+}
+
+bool ZProbeCache::TableWriter::isValid() const
+{
+    return m_valid;
+}
+
+void ZProbeCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    QDir dir(cacheDir());
+    for (const QFileInfo &info : dir.entryInfoList(QStringList{QString("*%1").arg(PROBE_CACHE_SUFFIX)}, QDir::Files)) {
+        QFile::remove(info.absoluteFilePath());
+    }
+}
+
+QByteArray ZProbeCache::fileIdentity(const QString &fileName)
+{
+    QFileInfo info(fileName);
+    if (!info.isFile()) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(info.absoluteFilePath()).constData(), &st) == 0) {
+        hash.addData(QByteArray::number(static_cast<qulonglong>(st.st_dev)));
+        hash.addData(QByteArray::number(static_cast<qulonglong>(st.st_ino)));
+    }
+#endif
+
+    if (!addSampledContent(hash, fileName)) {
+        return QByteArray();
+    }
+
+    return hash.result().toHex();
+}
+
+QByteArray ZProbeCache::contentIdentity(const QString &fileName)
+{
+    QFileInfo info(fileName);
+    if (!info.isFile()) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(info.size()));
+    if (!addSampledContent(hash, fileName)) {
+        return QByteArray();
+    }
+
+    return hash.result().toHex();
+}
+
+bool ZProbeCache::addSampledContent(QCryptographicHash &hash, const QString &fileName)
+{
+    // Sampled content: head, middle and tail
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 size = file.size();
+    qint64 lastOffset = qMax<qint64>(0, size - PROBE_CACHE_SAMPLE_SIZE);
+    const qint64 offsets[] = {0, lastOffset / 2, lastOffset};
+    for (qint64 offset : offsets) {
+        if (file.seek(offset)) {
+            hash.addData(file.read(PROBE_CACHE_SAMPLE_SIZE));
+        }
+    }
+    return true;
+}
+
+QString ZProbeCache::entryPath(const QString &fileName, const QString &command, QString *key) const
+{
+    QByteArray identity = fileIdentity(fileName);
+    if (identity.isEmpty()) {
+        return QString();
+    }
+
+    QString entryKey = QString("%1\n%2").arg(QString::fromLatin1(identity), command);
+    if (key) {
+        *key = entryKey;
+    }
+
+    QByteArray name = QCryptographicHash::hash(entryKey.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir(cacheDir()).filePath(QString::fromLatin1(name) + PROBE_CACHE_SUFFIX);
+}
+
+bool ZProbeCache::readEntry(const QString &fileName, const QString &command, EntryKind kind, QByteArray &payload)
+{
+    if (!isEnabled()) {
+        return false;
+    }
+
+    QString key;
+    QString path = entryPath(fileName, command, &key);
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint8 entryKind = 0;
+    QString storedKey;
+    QByteArray compressed;
+
+    stream >> magic >> version;
+    if (magic != PROBE_CACHE_MAGIC || version != PROBE_CACHE_VERSION) {
+        file.remove();
+        return false;
+    }
+
+    stream >> storedKey >> entryKind >> compressed;
+    if (stream.status() != QDataStream::Ok || storedKey != key || entryKind != kind) {
+        return false;
+    }
+
+    payload = qUncompress(compressed);
+    if (payload.isEmpty()) {
+        return false;
+    }
+
+    // Mark as recently used for eviction, best effort: a read-only or shared cache
+    // directory still serves hits, its entries just age by their write time
+    file.close();
+    QFile touch(path);
+    if (touch.open(QIODevice::ReadWrite)) {
+        touch.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    qDebug() << "Probe cache hit:" << fileName << command;
+    return true;
+}
+
+void ZProbeCache::writeEntry(const QString &fileName, const QString &command, EntryKind kind, const QByteArray &payload)
+{
+    if (payload.isEmpty() || !isEnabled()) {
+        return;
+    }
+
+    QString key;
+    QString path = entryPath(fileName, command, &key);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QByteArray compressed = qCompress(payload);
+    qint64 maxBytes = maxCacheBytes();
+
+    // A single entry should never push everything else out
+    if (compressed.size() > maxBytes / 4) {
+        qDebug() << "Probe result too large for the cache:" << compressed.size();
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    QDir().mkpath(cacheDir());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write probe cache entry:" << path;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << static_cast<quint32>(PROBE_CACHE_MAGIC)
+           << static_cast<quint16>(PROBE_CACHE_VERSION)
+           << key
+           << static_cast<quint8>(kind)
+           << compressed;
+
+    if (!file.commit()) {
+        qWarning() << "Could not commit probe cache entry:" << path;
+        return;
+    }
+
+    evict(maxBytes);
+}
+
+void ZProbeCache::evict(qint64 maxBytes)
+{
+    QDir dir(cacheDir());
+    QFileInfoList entries = dir.entryInfoList(QStringList{QString("*%1").arg(PROBE_CACHE_SUFFIX)},
+                                              QDir::Files, QDir::Time);
+
+    qint64 totalBytes = 0;
+    for (const QFileInfo &info : entries) {
+        totalBytes += info.size();
+    }
+
+    // entries are sorted newest first, drop from the back
+    while (totalBytes > maxBytes && !entries.isEmpty()) {
+        QFileInfo oldest = entries.takeLast();
+        if (QFile::remove(oldest.absoluteFilePath())) {
+            totalBytes -= oldest.size();
+        }
+    }
+}
+
+qint64 ZProbeCache::maxCacheBytes() const
+{
+    qint64 maxMB = Common::instance()->getConfigValue(PROBE_CACHE_MAX_SIZE_KEY, DEFAULT_PROBE_CACHE_MAX_SIZE).toLongLong();
+    return qMax<qint64>(1, maxMB) * 1024 * 1024;
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef ZPROBECACHE_H
+#define ZPROBECACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QMutex>
+#include <QCryptographicHash>
+
+#include "zsingleton.h"
+
+/**
+ * @brief Persistent probe result cache stored in the application config dir
+ *
+ * Entries are keyed by the file identity (path, size, mtime, inode and a hash
+ * of sampled content) plus the probe command, so a changed file is probed
+ * again while an unchanged one is answered from disk. Payloads are compressed
+ * and the directory is trimmed to the configured size, oldest access first.
+ */
+class ZProbeCache
+{
+    DECLARE_ZSINGLETON(ZProbeCache)
+
+public:
+    /**
+     * @brief Table entry serialized batch by batch while the rows stream in
+     *
+     * Only the serialized rows are kept, at most the quarter of the cache a
+     * single entry may take, and nothing once they outgrow it.
+     */
+    class TableWriter
+    {
+    public:
+        TableWriter();
+
+        void appendRows(const QList<QStringList> &rows);
+        bool isValid() const;
+
+    private:
+        friend class ZProbeCache;
+
+        QByteArray m_rows;
+        quint32 m_count;
+        qint64 m_maxBytes;
+        bool m_valid;
+    };
+
+    bool isEnabled() const;
+    QString cacheDir() const;
+
+    bool lookup(const QString &fileName, const QString &command, QByteArray &output);
+    void store(const QString &fileName, const QString &command, const QByteArray &output);
+
+    bool lookupTable(const QString &fileName, const QString &command,
+                     QStringList &headers, QList<QStringList> &rows);
+    void storeTable(const QString &fileName, const QString &command,
+                    const QStringList &headers, const QList<QStringList> &rows);
+    void storeTable(const QString &fileName, const QString &command,
+                    const QStringList &headers, const TableWriter &writer);
+
+    void clear();
+
+    // Identity of the file content, empty if the file can not be read
+    static QByteArray fileIdentity(const QString &fileName);
+    // Size and sampled content only, the same for a copy on another machine
+    static QByteArray contentIdentity(const QString &fileName);
+
+private:
+    enum EntryKind {
+        ENTRY_JSON = 0,
+        ENTRY_TABLE = 1
+    };
+
+    ZProbeCache();
+    ~ZProbeCache() = default;
+
+    static bool addSampledContent(QCryptographicHash &hash, const QString &fileName);
+    QString entryPath(const QString &fileName, const QString &command, QString *key) const;
+    bool readEntry(const QString &fileName, const QString &command, EntryKind kind, QByteArray &payload);
+    void writeEntry(const QString &fileName, const QString &command, EntryKind kind, const QByteArray &payload);
+    void evict(qint64 maxBytes);
+    qint64 maxCacheBytes() const;
+
+private:
+    QMutex m_mutex;
+};
+
+#endif // ZPROBECACHE_H
@@ -0,0 +1,821 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "zprobeengine.h"
+#include "zffprobe.h"
+#include "qtcompat.h"
+
+#include <QDebug>
+#include <QVector>
+#include <QJsonDocument>
+
+#include <cmath>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/avutil.h>
+#include <libavutil/pixdesc.h>
+#include <libavutil/samplefmt.h>
+#include <libavutil/channel_layout.h>
+}
+
+#ifndef AV_PROFILE_UNKNOWN
+#define AV_PROFILE_UNKNOWN FF_PROFILE_UNKNOWN
+#endif
+
+ZProbeEngine::ZProbeEngine()
+    : m_fmtCtx(nullptr)
+    , m_intervalStart(NAN)
+    , m_intervalEnd(NAN)
+{
+}
+
+ZProbeEngine::~ZProbeEngine()
+{
+    close();
+}
+
+bool ZProbeEngine::parseCommand(const QString &command, Sections *sections, QString *streamSpecifier)
+{
+    Sections tmpSections = SECTION_NONE;
+    QString tmpSpecifier;
+
+    QStringList args = command.split(" ", QT_SKIP_EMPTY_PARTS);
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+
+        if (arg == SHOW_FORMAT) {
+            tmpSections |= SECTION_FORMAT;
+        } else if (arg == SHOW_STREAMS) {
+            tmpSections |= SECTION_STREAMS;
+        } else if (arg == SHOW_CHAPTERS) {
+            tmpSections |= SECTION_CHAPTERS;
+        } else if (arg == SHOW_PROGRAMS) {
+            tmpSections |= SECTION_PROGRAMS;
+        } else if (arg == SHOW_PACKETS) {
+            tmpSections |= SECTION_PACKETS;
+        } else if (arg == SHOW_FRAMES) {
+            tmpSections |= SECTION_FRAMES;
+        } else if (arg == SELECT_STREAMS && i + 1 < args.size()) {
+            tmpSpecifier = args.at(++i);
+        } else {
+            // frames, entries, counters, versions ... are left to ffprobe
+            return false;
+        }
+    }
+
+    if (tmpSections == SECTION_NONE) {
+        return false;
+    }
+
+    if (sections) {
+        *sections = tmpSections;
+    }
+    if (streamSpecifier) {
+        *streamSpecifier = tmpSpecifier;
+    }
+
+    return true;
+}
+
+bool ZProbeEngine::canHandle(const QString &command)
+{
+    Sections sections;
+    if (!parseCommand(command, &sections, nullptr)) {
+        return false;
+    }
+
+    // frames are only produced as table rows by ZFrameEngine, json output stays with ffprobe
+    return !(sections & SECTION_FRAMES);
+}
+
+QString ZProbeEngine::buildCommand(Sections sections, const QString &streamSpecifier)
+{
+    QStringList args;
+    if (sections & SECTION_FORMAT) {
+        args << SHOW_FORMAT;
+    }
+    if (sections & SECTION_STREAMS) {
+        args << SHOW_STREAMS;
+    }
+    if (sections & SECTION_CHAPTERS) {
+        args << SHOW_CHAPTERS;
+    }
+    if (sections & SECTION_PROGRAMS) {
+        args << SHOW_PROGRAMS;
+    }
+    if (sections & SECTION_PACKETS) {
+        args << SHOW_PACKETS;
+    }
+    if (sections & SECTION_FRAMES) {
+        args << SHOW_FRAMES;
+    }
+    if (!streamSpecifier.isEmpty()) {
+        args << SELECT_STREAMS << streamSpecifier;
+    }
+
+    return args.join(" ");
+}
+
+QString ZProbeEngine::sectionName(Section section)
+{
+    switch (section) {
+    case SECTION_FORMAT:   return FORMAT;
+    case SECTION_STREAMS:  return "streams";
+    case SECTION_CHAPTERS: return "chapters";
+    case SECTION_PROGRAMS: return "programs";
+    case SECTION_PACKETS:  return "packets";
+    case SECTION_FRAMES:   return "frames";
+    default:               return QString();
+    }
+}
+
+bool ZProbeEngine::open(const QString &fileName)
+{
+    close();
+
+    m_fileName = fileName;
+    m_errorString.clear();
+
+    // Canceling the scheduler job aborts blocking reads of this context, also on the frame engine threads
+    m_cancelToken = ZProbeScheduler::currentToken();
+    m_fmtCtx = avformat_alloc_context();
+    if (!m_fmtCtx) {
+        m_errorString = "Could not allocate format context";
+        return false;
+    }
+    m_fmtCtx->interrupt_callback.callback = &ZProbeEngine::interruptCallback;
+    m_fmtCtx->interrupt_callback.opaque = this;
+
+    int ret = avformat_open_input(&m_fmtCtx, fileName.toUtf8().constData(), nullptr, nullptr);
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        m_errorString = QString("Could not open %1: %2").arg(fileName, errbuf);
+        m_fmtCtx = nullptr;
+        return false;
+    }
+
+    ret = avformat_find_stream_info(m_fmtCtx, nullptr);
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        m_errorString = QString("Could not find stream info of %1: %2").arg(fileName, errbuf);
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void ZProbeEngine::close()
+{
+    if (m_fmtCtx) {
+        avformat_close_input(&m_fmtCtx);
+        m_fmtCtx = nullptr;
+    }
+}
+
+void ZProbeEngine::setReadInterval(double startTime, double endTime)
+{
+    m_intervalStart = startTime;
+    m_intervalEnd = endTime;
+}
+
+void ZProbeEngine::clearReadInterval()
+{
+    m_intervalStart = NAN;
+    m_intervalEnd = NAN;
+}
+
+bool ZProbeEngine::hasReadInterval() const
+{
+    return !std::isnan(m_intervalStart) && !std::isnan(m_intervalEnd);
+}
+
+double ZProbeEngine::intervalStart() const
+{
+    return m_intervalStart;
+}
+
+double ZProbeEngine::intervalEnd() const
+{
+    return m_intervalEnd;
+}
+
+bool ZProbeEngine::seekToIntervalStart()
+{
+    if (!m_fmtCtx || !hasReadInterval()) {
+        return false;
+    }
+
+    int64_t target = static_cast<int64_t>(m_intervalStart * AV_TIME_BASE);
+    int ret = avformat_seek_file(m_fmtCtx, -1, INT64_MIN, target, target, 0);
+    if (ret < 0) {
+        // not seekable, read from the start and let the interval filter skip
+        qWarning() << "Seek to" << m_intervalStart << "failed in" << m_fileName;
+        return false;
+    }
+    return true;
+}
+
+double ZProbeEngine::timestampToSeconds(int64_t ts, AVRational timeBase)
+{
+    return ts == AV_NOPTS_VALUE ? NAN : ts * av_q2d(timeBase);
+}
+
+int ZProbeEngine::interruptCallback(void *opaque)
+{
+    ZProbeEngine *engine = static_cast<ZProbeEngine *>(opaque);
+    return ZProbeScheduler::isCanceled(engine->m_cancelToken) ? 1 : 0;
+}
+
+bool ZProbeEngine::isOpen() const
+{
+    return m_fmtCtx != nullptr;
+}
+
+bool ZProbeEngine::isCanceled() const
+{
+    return ZProbeScheduler::isCanceled(m_cancelToken);
+}
+
+QString ZProbeEngine::errorString() const
+{
+    return m_errorString;
+}
+
+AVFormatContext *ZProbeEngine::formatContext() const
+{
+    return m_fmtCtx;
+}
+
+QJsonObject ZProbeEngine::formatInfo() const
+{
+    QJsonObject format;
+    if (!m_fmtCtx) {
+        return format;
+    }
+
+    format.insert(FILENAME, m_fileName);
+    format.insert(NB_STREAMS, static_cast<int>(m_fmtCtx->nb_streams));
+    format.insert(NB_PROGRAMS, static_cast<int>(m_fmtCtx->nb_programs));
+    format.insert(FORMAT_NAME, m_fmtCtx->iformat->name);
+    if (m_fmtCtx->iformat->long_name) {
+        format.insert(FORMAT_LONG_NAME, m_fmtCtx->iformat->long_name);
+    }
+
+    if (m_fmtCtx->start_time != AV_NOPTS_VALUE) {
+        format.insert(START_TIME, timeToString(m_fmtCtx->start_time, AV_TIME_BASE_Q));
+    }
+    if (m_fmtCtx->duration != AV_NOPTS_VALUE) {
+        format.insert(DURATION, timeToString(m_fmtCtx->duration, AV_TIME_BASE_Q));
+    }
+
+    int64_t size = m_fmtCtx->pb ? avio_size(m_fmtCtx->pb) : -1;
+    if (size >= 0) {
+        format.insert(SIZE, QString::number(size));
+    }
+    if (m_fmtCtx->bit_rate > 0) {
+        format.insert(BIT_RATE, QString::number(m_fmtCtx->bit_rate));
+    }
+    format.insert(PROBE_SCORE, m_fmtCtx->probe_score);
+
+    QJsonObject tags = dictionaryToJson(m_fmtCtx->metadata);
+    if (!tags.isEmpty()) {
+        format.insert(TAGS, tags);
+    }
+
+    return format;
+}
+
+QJsonArray ZProbeEngine::streamsInfo(const QString &streamSpecifier) const
+{
+    QJsonArray streams;
+    if (!m_fmtCtx) {
+        return streams;
+    }
+
+    for (unsigned int i = 0; i < m_fmtCtx->nb_streams; ++i) {
+        AVStream *stream = m_fmtCtx->streams[i];
+        if (matchStream(stream, streamSpecifier)) {
+            streams.append(streamInfo(stream));
+        }
+    }
+
+    return streams;
+}
+
+QJsonArray ZProbeEngine::chaptersInfo() const
+{
+    QJsonArray chapters;
+    if (!m_fmtCtx) {
+        return chapters;
+    }
+
+    for (unsigned int i = 0; i < m_fmtCtx->nb_chapters; ++i) {
+        const AVChapter *chapter = m_fmtCtx->chapters[i];
+
+        QJsonObject obj;
+        obj.insert("id", static_cast<qint64>(chapter->id));
+        obj.insert("time_base", rationalToString(chapter->time_base));
+        obj.insert("start", static_cast<qint64>(chapter->start));
+        obj.insert("start_time", timeToString(chapter->start, chapter->time_base));
+        obj.insert("end", static_cast<qint64>(chapter->end));
+        obj.insert("end_time", timeToString(chapter->end, chapter->time_base));
+
+        QJsonObject tags = dictionaryToJson(chapter->metadata);
+        if (!tags.isEmpty()) {
+            obj.insert(TAGS, tags);
+        }
+        chapters.append(obj);
+    }
+
+    return chapters;
+}
+
+QJsonArray ZProbeEngine::programsInfo(const QString &streamSpecifier) const
+{
+    QJsonArray programs;
+    if (!m_fmtCtx) {
+        return programs;
+    }
+
+    for (unsigned int i = 0; i < m_fmtCtx->nb_programs; ++i) {
+        const AVProgram *program = m_fmtCtx->programs[i];
+
+        QJsonObject obj;
+        obj.insert("program_id", program->id);
+        obj.insert("program_num", program->program_num);
+        obj.insert("nb_streams", static_cast<int>(program->nb_stream_indexes));
+        obj.insert("pmt_pid", program->pmt_pid);
+        obj.insert("pcr_pid", program->pcr_pid);
+
+        QJsonObject tags = dictionaryToJson(program->metadata);
+        if (!tags.isEmpty()) {
+            obj.insert(TAGS, tags);
+        }
+
+        QJsonArray streams;
+        for (unsigned int j = 0; j < program->nb_stream_indexes; ++j) {
+            AVStream *stream = m_fmtCtx->streams[program->stream_index[j]];
+            if (matchStream(stream, streamSpecifier)) {
+                streams.append(streamInfo(stream));
+            }
+        }
+        obj.insert("streams", streams);
+
+        programs.append(obj);
+    }
+
+    return programs;
+}
+
+QJsonArray ZProbeEngine::packetsInfo(const QString &streamSpecifier, bool *ok)
+{
+    QJsonArray packets;
+
+    bool read = readPackets(streamSpecifier, [&](const PacketRecord &record) {
+        AVStream *stream = m_fmtCtx->streams[record.streamIndex];
+        const char *mediaType = av_get_media_type_string(stream->codecpar->codec_type);
+
+        QJsonObject obj;
+        obj.insert("codec_type", mediaType ? mediaType : "unknown");
+        obj.insert("stream_index", record.streamIndex);
+        if (record.pts != AV_NOPTS_VALUE) {
+            obj.insert("pts", static_cast<qint64>(record.pts));
+            obj.insert("pts_time", timeToString(record.pts, stream->time_base));
+        }
+        if (record.dts != AV_NOPTS_VALUE) {
+            obj.insert("dts", static_cast<qint64>(record.dts));
+            obj.insert("dts_time", timeToString(record.dts, stream->time_base));
+        }
+        obj.insert("duration", static_cast<qint64>(record.duration));
+        obj.insert("duration_time", timeToString(record.duration, stream->time_base));
+        obj.insert("size", QString::number(record.size));
+        if (record.pos != -1) {
+            obj.insert("pos", QString::number(record.pos));
+        }
+        obj.insert("flags", packetFlagsToString(record.flags));
+
+        packets.append(obj);
+        return true;
+    });
+
+    if (ok) {
+        *ok = read;
+    }
+    return packets;
+}
+
+bool ZProbeEngine::readPackets(const QString &streamSpecifier, const PacketCallback &callback)
+{
+    if (!m_fmtCtx) {
+        m_errorString = "No media file opened";
+        return false;
+    }
+
+    QVector<bool> selected(m_fmtCtx->nb_streams);
+    for (unsigned int i = 0; i < m_fmtCtx->nb_streams; ++i) {
+        selected[i] = matchStream(m_fmtCtx->streams[i], streamSpecifier);
+    }
+
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt) {
+        m_errorString = "Could not allocate packet";
+        return false;
+    }
+
+    bool interval = hasReadInterval();
+    if (interval) {
+        seekToIntervalStart();
+    }
+
+    PacketRecord record;
+    int ret = 0;
+    while ((ret = av_read_frame(m_fmtCtx, pkt)) >= 0) {
+        bool keepReading = true;
+        bool inInterval = true;
+
+        if (interval && pkt->stream_index >= 0 && pkt->stream_index < selected.size()) {
+            AVRational timeBase = m_fmtCtx->streams[pkt->stream_index]->time_base;
+            double time = timestampToSeconds(pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts, timeBase);
+
+            // reordered and interleaved packets may still follow shortly after endTime
+            if (!std::isnan(time) && time >= m_intervalEnd + READ_INTERVAL_MARGIN) {
+                av_packet_unref(pkt);
+                break;
+            }
+            inInterval = !std::isnan(time) && time >= m_intervalStart && time < m_intervalEnd;
+        }
+
+        if (inInterval && pkt->stream_index >= 0 && pkt->stream_index < selected.size()
+            && selected.at(pkt->stream_index)) {
+            record.streamIndex = pkt->stream_index;
+            record.pts = pkt->pts;
+            record.dts = pkt->dts;
+            record.duration = pkt->duration;
+            record.pos = pkt->pos;
+            record.size = pkt->size;
+            record.flags = pkt->flags;
+            record.sideDataCount = pkt->side_data_elems;
+
+            keepReading = callback(record);
+        }
+        av_packet_unref(pkt);
+
+        if (!keepReading) {
+            break;
+        }
+    }
+
+    av_packet_free(&pkt);
+
+    // a read error ends the table early, only the end of the file or a cancel is a clean stop
+    if (ret < 0 && ret != AVERROR_EOF
+        && !(ret == AVERROR_EXIT && isCanceled())) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        m_errorString = QString("Could not read packets: %1").arg(errbuf);
+        return false;
+    }
+    return true;
+}
+
+bool ZProbeEngine::packetsTable(const QString &streamSpecifier, QStringList &headers, QList<QStringList> &rows)
+{
+    headers = packetColumns();
+    rows.clear();
+
+    bool hasSideData = false;
+    QVector<int> sideDataCounts;
+
+    bool ok = readPackets(streamSpecifier, [&](const PacketRecord &record) {
+        rows.append(packetRecordToRow(record));
+        sideDataCounts.append(record.sideDataCount);
+        hasSideData |= record.sideDataCount > 0;
+        return true;
+    });
+
+    // side_data_list only shows up in ffprobe output when a packet carries side data
+    if (hasSideData) {
+        headers.append("side_data_list");
+        for (int i = 0; i < rows.size(); ++i) {
+            rows[i].append(sideDataCounts.at(i) > 0 ?
+                               QString("[%1 items]").arg(sideDataCounts.at(i)) : "");
+        }
+    }
+
+    return ok;
+}
+
+QStringList ZProbeEngine::packetRecordToRow(const PacketRecord &record) const
+{
+    AVStream *stream = m_fmtCtx->streams[record.streamIndex];
+    const char *mediaType = av_get_media_type_string(stream->codecpar->codec_type);
+    bool hasPts = record.pts != AV_NOPTS_VALUE;
+    bool hasDts = record.dts != AV_NOPTS_VALUE;
+
+    // Keep in sync with packetColumns()
+    return QStringList{
+        QString::number(record.streamIndex),
+        mediaType ? mediaType : "unknown",
+        hasDts ? QString::number(record.dts) : "",
+        hasDts ? timeToString(record.dts, stream->time_base) : "",
+        QString::number(record.duration),
+        timeToString(record.duration, stream->time_base),
+        packetFlagsToString(record.flags),
+        record.pos != -1 ? QString::number(record.pos) : "",
+        hasPts ? QString::number(record.pts) : "",
+        hasPts ? timeToString(record.pts, stream->time_base) : "",
+        QString::number(record.size)
+    };
+}
+
+QStringList ZProbeEngine::packetColumns()
+{
+    // Common fields first, then the remaining packet keys in sorted order,
+    // the same rule TabelFormatWG::loadJson applies to the json output
+    return QStringList{
+        "stream_index", "codec_type", "dts", "dts_time", "duration", "duration_time",
+        "flags", "pos", "pts", "pts_time", "size"
+    };
+}
+
+bool ZProbeEngine::probe(const QString &command, const QString &fileName, QByteArray &output)
+{
+    Sections sections = SECTION_NONE;
+    QString streamSpecifier;
+
+    if (!parseCommand(command, &sections, &streamSpecifier) || (sections & SECTION_FRAMES)) {
+        m_errorString = QString("Unsupported command: %1").arg(command);
+        return false;
+    }
+
+    if (!open(fileName)) {
+        return false;
+    }
+
+    QJsonObject root;
+    if (sections & SECTION_PACKETS) {
+        bool ok = false;
+        QJsonArray packets = packetsInfo(streamSpecifier, &ok);
+        if (!ok) {
+            // a truncated packet list must not be returned, and cached, as the probe result
+            close();
+            return false;
+        }
+        root.insert("packets", packets);
+    }
+    if (sections & SECTION_PROGRAMS) {
+        root.insert("programs", programsInfo(streamSpecifier));
+    }
+    if (sections & SECTION_STREAMS) {
+        root.insert("streams", streamsInfo(streamSpecifier));
+    }
+    if (sections & SECTION_CHAPTERS) {
+        root.insert("chapters", chaptersInfo());
+    }
+    if (sections & SECTION_FORMAT) {
+        root.insert(FORMAT, formatInfo());
+    }
+
+    close();
+
+    output = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    return true;
+}
+
+QString ZProbeEngine::timeToString(int64_t ts, AVRational timeBase)
+{
+    if (ts == AV_NOPTS_VALUE) {
+        return "N/A";
+    }
+
+    return QString::number(ts * av_q2d(timeBase), 'f', 6);
+}
+
+QString ZProbeEngine::rationalToString(AVRational rational, const char *separator)
+{
+    return QString("%1%2%3").arg(rational.num).arg(separator).arg(rational.den);
+}
+
+QString ZProbeEngine::packetFlagsToString(int flags)
+{
+    QString str;
+    str.append(flags & AV_PKT_FLAG_KEY ? 'K' : '_');
+    str.append(flags & AV_PKT_FLAG_DISCARD ? 'D' : '_');
+    str.append(flags & AV_PKT_FLAG_CORRUPT ? 'C' : '_');
+    return str;
+}
+
+bool ZProbeEngine::matchStream(AVStream *stream, const QString &specifier) const
+{
+    if (specifier.isEmpty()) {
+        return true;
+    }
+
+    int ret = avformat_match_stream_specifier(m_fmtCtx, stream, specifier.toUtf8().constData());
+    if (ret < 0) {
+        qWarning() << "Invalid stream specifier:" << specifier;
+        return false;
+    }
+
+    return ret > 0;
+}
+
+QJsonObject ZProbeEngine::streamInfo(AVStream *stream) const
+{
+    QJsonObject obj;
+    const AVCodecParameters *par = stream->codecpar;
+    const AVCodecDescriptor *desc = avcodec_descriptor_get(par->codec_id);
+
+    obj.insert("index", stream->index);
+    if (desc) {
+        obj.insert("codec_name", desc->name);
+        if (desc->long_name) {
+            obj.insert("codec_long_name", desc->long_name);
+        }
+    } else {
+        obj.insert("codec_name", "unknown");
+    }
+
+    const char *profile = avcodec_profile_name(par->codec_id, par->profile);
+    if (profile) {
+        obj.insert("profile", profile);
+    } else if (par->profile != AV_PROFILE_UNKNOWN) {
+        obj.insert("profile", QString::number(par->profile));
+    }
+
+    const char *mediaType = av_get_media_type_string(par->codec_type);
+    obj.insert("codec_type", mediaType ? mediaType : "unknown");
+
+    char tagbuf[AV_FOURCC_MAX_STRING_SIZE] = {0};
+    av_fourcc_make_string(tagbuf, par->codec_tag);
+    obj.insert("codec_tag_string", tagbuf);
+    obj.insert("codec_tag", QString("0x%1").arg(par->codec_tag, 4, 16, QChar('0')));
+
+    switch (par->codec_type) {
+    case AVMEDIA_TYPE_VIDEO: {
+        obj.insert("width", par->width);
+        obj.insert("height", par->height);
+        obj.insert("has_b_frames", par->video_delay);
+
+        AVRational sar = av_guess_sample_aspect_ratio(m_fmtCtx, stream, nullptr);
+        if (sar.num) {
+            AVRational dar;
+            av_reduce(&dar.num, &dar.den,
+                      static_cast<int64_t>(par->width) * sar.num,
+                      static_cast<int64_t>(par->height) * sar.den,
+                      1024 * 1024);
+            obj.insert("sample_aspect_ratio", rationalToString(sar, ":"));
+            obj.insert("display_aspect_ratio", rationalToString(dar, ":"));
+        }
+
+        const char *pixFmt = av_get_pix_fmt_name(static_cast<AVPixelFormat>(par->format));
+        if (pixFmt) {
+            obj.insert("pix_fmt", pixFmt);
+        }
+        obj.insert("level", par->level);
+
+        if (par->color_range != AVCOL_RANGE_UNSPECIFIED) {
+            obj.insert("color_range", av_color_range_name(par->color_range));
+        }
+        if (par->color_space != AVCOL_SPC_UNSPECIFIED) {
+            obj.insert("color_space", av_color_space_name(par->color_space));
+        }
+        if (par->color_trc != AVCOL_TRC_UNSPECIFIED) {
+            obj.insert("color_transfer", av_color_transfer_name(par->color_trc));
+        }
+        if (par->color_primaries != AVCOL_PRI_UNSPECIFIED) {
+            obj.insert("color_primaries", av_color_primaries_name(par->color_primaries));
+        }
+        if (par->chroma_location != AVCHROMA_LOC_UNSPECIFIED) {
+            obj.insert("chroma_location", av_chroma_location_name(par->chroma_location));
+        }
+
+        switch (par->field_order) {
+        case AV_FIELD_PROGRESSIVE: obj.insert("field_order", "progressive"); break;
+        case AV_FIELD_TT:          obj.insert("field_order", "tt"); break;
+        case AV_FIELD_BB:          obj.insert("field_order", "bb"); break;
+        case AV_FIELD_TB:          obj.insert("field_order", "tb"); break;
+        case AV_FIELD_BT:          obj.insert("field_order", "bt"); break;
+        default:                   break;
+        }
+        break;
+    }
+    case AVMEDIA_TYPE_AUDIO: {
+        const char *sampleFmt = av_get_sample_fmt_name(static_cast<AVSampleFormat>(par->format));
+        if (sampleFmt) {
+            obj.insert("sample_fmt", sampleFmt);
+        }
+        obj.insert("sample_rate", QString::number(par->sample_rate));
+
+        char layout[128] = {0};
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(59, 24, 100)
+        // new api（FFmpeg 5.1+）
+        obj.insert("channels", par->ch_layout.nb_channels);
+        if (par->ch_layout.order != AV_CHANNEL_ORDER_UNSPEC
+            && av_channel_layout_describe(&par->ch_layout, layout, sizeof(layout)) > 0) {
+            obj.insert("channel_layout", layout);
+        }
+#else
+        obj.insert("channels", par->channels);
+        if (par->channel_layout) {
+            av_get_channel_layout_string(layout, sizeof(layout), par->channels, par->channel_layout);
+            obj.insert("channel_layout", layout);
+        }
+#endif
+        obj.insert("bits_per_sample", av_get_bits_per_sample(par->codec_id));
+        obj.insert("initial_padding", par->initial_padding);
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (m_fmtCtx->iformat->flags & AVFMT_SHOW_IDS) {
+        obj.insert("id", QString("0x%1").arg(stream->id, 0, 16));
+    }
+
+    obj.insert("r_frame_rate", rationalToString(stream->r_frame_rate));
+    obj.insert("avg_frame_rate", rationalToString(stream->avg_frame_rate));
+    obj.insert("time_base", rationalToString(stream->time_base));
+
+    if (stream->start_time != AV_NOPTS_VALUE) {
+        obj.insert("start_pts", static_cast<qint64>(stream->start_time));
+        obj.insert("start_time", timeToString(stream->start_time, stream->time_base));
+    }
+    if (stream->duration != AV_NOPTS_VALUE) {
+        obj.insert("duration_ts", static_cast<qint64>(stream->duration));
+        obj.insert("duration", timeToString(stream->duration, stream->time_base));
+    }
+    if (par->bit_rate > 0) {
+        obj.insert("bit_rate", QString::number(par->bit_rate));
+    }
+    if (par->bits_per_raw_sample > 0) {
+        obj.insert("bits_per_raw_sample", QString::number(par->bits_per_raw_sample));
+    }
+    if (stream->nb_frames > 0) {
+        obj.insert("nb_frames", QString::number(stream->nb_frames));
+    }
+    if (par->extradata_size > 0) {
+        obj.insert("extradata_size", par->extradata_size);
+    }
+
+    obj.insert("disposition", dispositionToJson(stream->disposition));
+
+    QJsonObject tags = dictionaryToJson(stream->metadata);
+    if (!tags.isEmpty()) {
+        obj.insert(TAGS, tags);
+    }
+
+    return obj;
+}
+
+QJsonObject ZProbeEngine::dictionaryToJson(const AVDictionary *dict)
+{
+    QJsonObject obj;
+    const AVDictionaryEntry *entry = nullptr;
+
+    while ((entry = av_dict_get(dict, "", entry, AV_DICT_IGNORE_SUFFIX))) {
+        obj.insert(QString::fromUtf8(entry->key), QString::fromUtf8(entry->value));
+    }
+
+    return obj;
+}
+
+QJsonObject ZProbeEngine::dispositionToJson(int disposition)
+{
+    static const QList<QPair<int, const char *>> dispositions = {
+        {AV_DISPOSITION_DEFAULT,          "default"},
+        {AV_DISPOSITION_DUB,              "dub"},
+        {AV_DISPOSITION_ORIGINAL,         "original"},
+        {AV_DISPOSITION_COMMENT,          "comment"},
+        {AV_DISPOSITION_LYRICS,           "lyrics"},
+        {AV_DISPOSITION_KARAOKE,          "karaoke"},
+        {AV_DISPOSITION_FORCED,           "forced"},
+        {AV_DISPOSITION_HEARING_IMPAIRED, "hearing_impaired"},
+        {AV_DISPOSITION_VISUAL_IMPAIRED,  "visual_impaired"},
+        {AV_DISPOSITION_CLEAN_EFFECTS,    "clean_effects"},
+        {AV_DISPOSITION_ATTACHED_PIC,     "attached_pic"},
+        {AV_DISPOSITION_TIMED_THUMBNAILS, "timed_thumbnails"},
+#ifdef AV_DISPOSITION_NON_DIEGETIC
+        {AV_DISPOSITION_NON_DIEGETIC,     "non_diegetic"},
+#endif
+        {AV_DISPOSITION_CAPTIONS,         "captions"},
+        {AV_DISPOSITION_DESCRIPTIONS,     "descriptions"},
+        {AV_DISPOSITION_METADATA,         "metadata"},
+        {AV_DISPOSITION_DEPENDENT,        "dependent"},
+#ifdef AV_DISPOSITION_STILL_IMAGE
+        {AV_DISPOSITION_STILL_IMAGE,      "still_image"},
+#endif
+    };
+
+    QJsonObject obj;
+    for (const auto &it : dispositions) {
+        obj.insert(it.second, (disposition & it.first) ? 1 : 0);
+    }
+
+    return obj;
+}
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef ZPROBEENGINE_H
+#define ZPROBEENGINE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFlags>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <functional>
+
+#include "zprobescheduler.h"
+
+// Seconds read past the end of a read interval, packets are reordered and interleaved
+#define READ_INTERVAL_MARGIN 2.0
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+/**
+ * @brief In-process probe engine built on libavformat
+ *
+ * Opens the media file once with avformat_open_input/avformat_find_stream_info
+ * and produces the same sections as the ffprobe json writer, so the output can
+ * be consumed by the existing JsonFormatWG/TabelFormatWG code unchanged.
+ */
+class ZProbeEngine
+{
+public:
+    enum Section {
+        SECTION_NONE     = 0x00,
+        SECTION_FORMAT   = 0x01,
+        SECTION_STREAMS  = 0x02,
+        SECTION_CHAPTERS = 0x04,
+        SECTION_PROGRAMS = 0x08,
+        SECTION_PACKETS  = 0x10,
+        SECTION_FRAMES   = 0x20
+    };
+    Q_DECLARE_FLAGS(Sections, Section)
+
+    // Typed packet record, filled straight from AVPacket without any text round trip
+    struct PacketRecord {
+        int streamIndex = -1;
+        int64_t pts = AV_NOPTS_VALUE;
+        int64_t dts = AV_NOPTS_VALUE;
+        int64_t duration = 0;
+        int64_t pos = -1;
+        int size = 0;
+        int flags = 0;
+        int sideDataCount = 0;
+    };
+
+    // Return false from the callback to stop reading
+    using PacketCallback = std::function<bool(const PacketRecord &record)>;
+
+    ZProbeEngine();
+    ~ZProbeEngine();
+
+    ZProbeEngine(const ZProbeEngine&) = delete;
+    ZProbeEngine& operator=(const ZProbeEngine&) = delete;
+
+    /**
+     * @brief Parse an ffprobe style command line (e.g. "-show_packets -select_streams 0")
+     * @param command Command string as passed to ZFfprobe::getMediaInfoJsonFormat
+     * @param sections Receives the requested sections
+     * @param streamSpecifier Receives the -select_streams argument, if any
+     * @return false if the command contains options the engine can not serve
+     */
+    static bool parseCommand(const QString &command, Sections *sections, QString *streamSpecifier);
+    static bool canHandle(const QString &command);
+
+    // Inverse of parseCommand()
+    static QString buildCommand(Sections sections, const QString &streamSpecifier = QString());
+    // Json key of a section in ffprobe output, e.g. "streams"
+    static QString sectionName(Section section);
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const;
+    // True once the scheduler job that opened the file was canceled
+    bool isCanceled() const;
+    QString errorString() const;
+    AVFormatContext *formatContext() const;
+
+    /**
+     * @brief Restrict reading to a time window, used by paged tables
+     *
+     * Times are on the pts_time scale. readPackets() seeks to the keyframe before
+     * startTime, skips packets outside [startTime, endTime) and stops once the
+     * packets are well past endTime.
+     */
+    void setReadInterval(double startTime, double endTime);
+    void clearReadInterval();
+    bool hasReadInterval() const;
+    double intervalStart() const;
+    double intervalEnd() const;
+    bool seekToIntervalStart();
+
+    // Timestamp in seconds on the pts_time scale, NAN when unset
+    static double timestampToSeconds(int64_t ts, AVRational timeBase);
+    bool matchStream(AVStream *stream, const QString &specifier) const;
+
+    QJsonObject formatInfo() const;
+    QJsonArray streamsInfo(const QString &streamSpecifier = QString()) const;
+    QJsonArray chaptersInfo() const;
+    QJsonArray programsInfo(const QString &streamSpecifier = QString()) const;
+    // ok is false when the demuxer stopped on an error, the array then holds a truncated list
+    QJsonArray packetsInfo(const QString &streamSpecifier, bool *ok);
+
+    /**
+     * @brief Demux the packets of the selected streams with av_read_frame
+     * @param streamSpecifier ffprobe stream specifier, empty selects all streams
+     * @param callback Invoked once per packet in file order
+     * @return false if the file is not open or av_read_frame failed before the end of the file
+     */
+    bool readPackets(const QString &streamSpecifier, const PacketCallback &callback);
+
+    /**
+     * @brief Build the packet table directly from typed records
+     *
+     * The columns are the ones TabelFormatWG derives from the -show_packets json,
+     * so both paths produce the same table.
+     */
+    bool packetsTable(const QString &streamSpecifier, QStringList &headers, QList<QStringList> &rows);
+    QStringList packetRecordToRow(const PacketRecord &record) const;
+    static QStringList packetColumns();
+
+    /**
+     * @brief Run an ffprobe style command in-process
+     * @param command Command string, see parseCommand()
+     * @param fileName Media file to probe
+     * @param output Receives the json document
+     * @return true on success, false if the command is unsupported or the file can not be opened
+     */
+    bool probe(const QString &command, const QString &fileName, QByteArray &output);
+
+    static QString timeToString(int64_t ts, AVRational timeBase);
+    static QString rationalToString(AVRational rational, const char *separator = "/");
+    static QString packetFlagsToString(int flags);
+
+private:
+    QJsonObject streamInfo(AVStream *stream) const;
+    static int interruptCallback(void *opaque);
+    static QJsonObject dictionaryToJson(const AVDictionary *dict);
+    static QJsonObject dispositionToJson(int disposition);
+
+private:
+    AVFormatContext *m_fmtCtx;
+    ZProbeScheduler::CancelToken m_cancelToken;
+    double m_intervalStart;
+    double m_intervalEnd;
+    QString m_fileName;
+    QString m_errorString;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ZProbeEngine::Sections)
+
+#endif // ZPROBEENGINE_H
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "zproberesultcache.h"
+#include "common.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+
+#include <limits>
+
+int ZProbeResult::costKB() const
+{
+    qint64 bytes = json.size();
+    for (const QString &header : headers) {
+        bytes += header.size() * 2;
+    }
+    if (!rows.isEmpty()) {
+        // every cell is a QString with ~16 bytes of payload on average
+        bytes += static_cast<qint64>(rows.size()) * (rows.first().size() * 40 + 24);
+    }
+
+    return static_cast<int>(qMin<qint64>(bytes / 1024 + 1, std::numeric_limits<int>::max()));
+}
+
+ZProbeResultCache::ZProbeResultCache()
+{
+    m_cache.setMaxCost(maxCostKB());
+}
+
+ZProbeResult ZProbeResultCache::fetch(const QString &fileName, const QString &command, const Producer &producer)
+{
+    QString key = cacheKey(fileName, command);
+    QSharedPointer<InFlight> inFlight;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        forever {
+            if (ZProbeResult *hit = m_cache.object(key)) {
+                return *hit;
+            }
+
+            inFlight = m_inFlight.value(key);
+            if (!inFlight) {
+                break;
+            }
+
+            // Someone is already probing this, share its result
+            while (!inFlight->done) {
+                m_finished.wait(&m_mutex);
+            }
+            if (inFlight->result.ok) {
+                return inFlight->result;
+            }
+            // The producer failed or its job was canceled, probe again rather than share nothing
+        }
+
+        inFlight = QSharedPointer<InFlight>::create();
+        m_inFlight.insert(key, inFlight);
+    }
+
+    ZProbeResult result = producer();
+
+    QMutexLocker locker(&m_mutex);
+    inFlight->result = result;
+    inFlight->done = true;
+    m_inFlight.remove(key);
+
+    if (result.ok) {
+        m_cache.setMaxCost(maxCostKB());
+        m_cache.insert(key, new ZProbeResult(result), result.costKB());
+    }
+    m_finished.wakeAll();
+
+    return result;
+}
+
+bool ZProbeResultCache::lookup(const QString &fileName, const QString &command, ZProbeResult &result)
+{
+    QMutexLocker locker(&m_mutex);
+
+    ZProbeResult *hit = m_cache.object(cacheKey(fileName, command));
+    if (!hit) {
+        return false;
+    }
+
+    result = *hit;
+    return true;
+}
+
+void ZProbeResultCache::insert(const QString &fileName, const QString &command, const ZProbeResult &result)
+{
+    if (!result.ok) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.setMaxCost(maxCostKB());
+    m_cache.insert(cacheKey(fileName, command), new ZProbeResult(result), result.costKB());
+}
+
+void ZProbeResultCache::remove(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QString prefix = QFileInfo(fileName).absoluteFilePath() + '\n';
+    for (const QString &key : m_cache.keys()) {
+        if (key.startsWith(prefix)) {
+            m_cache.remove(key);
+        }
+    }
+}
+
+void ZProbeResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+QString ZProbeResultCache::cacheKey(const QString &fileName, const QString &command)
+{
+    // size and mtime make a changed file miss the cache
+    QFileInfo info(fileName);
+    return QString("%1\n%2\n%3\n%4")
+        .arg(info.absoluteFilePath())
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch())
+        .arg(command);
+}
+
+int ZProbeResultCache::maxCostKB() const
+{
+    int maxMB = Common::instance()->getConfigValue(PROBE_MEMORY_CACHE_SIZE_KEY, DEFAULT_PROBE_MEMORY_CACHE_SIZE).toInt();
+    return qMax(1, maxMB) * 1024;
+}
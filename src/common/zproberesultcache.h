@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef ZPROBERESULTCACHE_H
+#define ZPROBERESULTCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSharedPointer>
+
+#include <functional>
+
+#include "zsingleton.h"
+
+// Result of one probe request, either json text or table rows
+struct ZProbeResult
+{
+    bool ok = false;
+    QByteArray json;
+    QStringList headers;
+    QList<QStringList> rows;
+
+    // Rough memory footprint in KB, used as QCache cost
+    int costKB() const;
+};
+
+/**
+ * @brief Process-wide in-memory LRU cache in front of ZFfprobe
+ *
+ * Shared by every ZFfprobe instance (main window, media properties, stream
+ * menus). Concurrent requests for the same file/command are coalesced: the
+ * first caller runs the probe, the others wait for and share its result.
+ */
+class ZProbeResultCache
+{
+    DECLARE_ZSINGLETON(ZProbeResultCache)
+
+public:
+    using Producer = std::function<ZProbeResult()>;
+
+    /**
+     * @brief Return the cached result or run the producer once for all concurrent callers
+     * @param fileName Media file, its size and mtime are part of the key
+     * @param command Probe command or any other request discriminator
+     * @param producer Runs the probe on a cache miss
+     */
+    ZProbeResult fetch(const QString &fileName, const QString &command, const Producer &producer);
+
+    // Plain lookup/insert for callers that produce results incrementally
+    bool lookup(const QString &fileName, const QString &command, ZProbeResult &result);
+    void insert(const QString &fileName, const QString &command, const ZProbeResult &result);
+
+    void remove(const QString &fileName);
+    void clear();
+
+private:
+    struct InFlight {
+        bool done = false;
+        ZProbeResult result;
+    };
+
+    ZProbeResultCache();
+    ~ZProbeResultCache() = default;
+
+    static QString cacheKey(const QString &fileName, const QString &command);
+    int maxCostKB() const;
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_finished;
+    QCache<QString, ZProbeResult> m_cache;
+    QHash<QString, QSharedPointer<InFlight>> m_inFlight;
+};
+
+#endif // ZPROBERESULTCACHE_H
@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "zprobescheduler.h"
+#include "common.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QDebug>
+
+namespace {
+
+thread_local ZProbeScheduler::CancelToken t_currentToken;
+
+class ZProbeJobRunnable : public QRunnable
+{
+public:
+    explicit ZProbeJobRunnable(const std::function<void()> &function)
+        : m_function(function)
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        m_function();
+    }
+
+private:
+    std::function<void()> m_function;
+};
+
+}
+
+ZProbeScheduler::ZProbeScheduler()
+{
+    m_lanes[LANE_PROBE].maxConcurrency = qMax(1, Common::instance()->getConfigValue(PROBE_MAX_JOBS_KEY, DEFAULT_PROBE_MAX_JOBS).toInt());
+    m_lanes[LANE_TABLE].maxConcurrency = qMax(1, QThread::idealThreadCount());
+
+    for (Lane &lane : m_lanes) {
+        lane.pool.setMaxThreadCount(lane.maxConcurrency);
+    }
+}
+
+ZProbeScheduler::CancelToken ZProbeScheduler::submit(const QObject *owner, Priority priority, const Job &job, const Job &dropped)
+{
+    return enqueue(LANE_PROBE, owner, priority, job, dropped);
+}
+
+ZProbeScheduler::CancelToken ZProbeScheduler::submitTable(const QObject *owner, Priority priority, const Job &job, const Job &dropped)
+{
+    return enqueue(LANE_TABLE, owner, priority, job, dropped);
+}
+
+ZProbeScheduler::CancelToken ZProbeScheduler::enqueue(LaneId lane, const QObject *owner, Priority priority,
+                                                      const Job &job, const Job &dropped)
+{
+    EntryPtr entry = EntryPtr::create();
+    entry->owner = owner;
+    entry->lane = lane;
+    entry->priority = priority;
+    entry->job = job;
+    entry->dropped = dropped;
+    entry->token = CancelToken::create(0);
+
+    QList<Job> droppedJobs;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        supersede(owner, droppedJobs);
+
+        // keep submission order within a priority
+        QList<EntryPtr> &pending = m_lanes[lane].pending;
+        int index = 0;
+        while (index < pending.size() && pending.at(index)->priority >= priority) {
+            ++index;
+        }
+        pending.insert(index, entry);
+    }
+
+    for (const Job &droppedJob : droppedJobs) {
+        droppedJob();
+    }
+
+    schedule(lane);
+    return entry->token;
+}
+
+void ZProbeScheduler::cancel(const QObject *owner)
+{
+    if (!owner) {
+        return;
+    }
+
+    QList<Job> droppedJobs;
+    {
+        QMutexLocker locker(&m_mutex);
+        supersede(owner, droppedJobs);
+    }
+
+    for (const Job &droppedJob : droppedJobs) {
+        droppedJob();
+    }
+}
+
+void ZProbeScheduler::cancel(const CancelToken &token)
+{
+    if (token) {
+        token->storeRelease(1);
+    }
+}
+
+void ZProbeScheduler::setMaxConcurrency(int maxConcurrency)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        Lane &lane = m_lanes[LANE_PROBE];
+        lane.maxConcurrency = qMax(1, maxConcurrency);
+        lane.pool.setMaxThreadCount(lane.maxConcurrency);
+    }
+
+    schedule(LANE_PROBE);
+}
+
+int ZProbeScheduler::maxConcurrency() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lanes[LANE_PROBE].maxConcurrency;
+}
+
+ZProbeScheduler::CancelToken ZProbeScheduler::currentToken()
+{
+    return t_currentToken;
+}
+
+bool ZProbeScheduler::isCanceled()
+{
+    return isCanceled(t_currentToken);
+}
+
+bool ZProbeScheduler::isCanceled(const CancelToken &token)
+{
+    return token && token->loadAcquire();
+}
+
+void ZProbeScheduler::supersede(const QObject *owner, QList<Job> &droppedJobs)
+{
+    if (!owner) {
+        return;
+    }
+
+    for (Lane &lane : m_lanes) {
+        for (int i = lane.pending.size() - 1; i >= 0; --i) {
+            const EntryPtr &pending = lane.pending.at(i);
+            if (pending->owner == owner) {
+                pending->token->storeRelease(1);
+                if (pending->dropped) {
+                    droppedJobs.prepend(pending->dropped);
+                }
+                lane.pending.removeAt(i);
+            }
+        }
+
+        for (const EntryPtr &running : lane.running) {
+            if (running->owner == owner) {
+                running->token->storeRelease(1);
+            }
+        }
+    }
+}
+
+void ZProbeScheduler::schedule(LaneId laneId)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Lane &lane = m_lanes[laneId];
+    while (lane.running.size() < lane.maxConcurrency && !lane.pending.isEmpty()) {
+        EntryPtr entry = lane.pending.takeFirst();
+        lane.running.append(entry);
+        lane.pool.start(new ZProbeJobRunnable([this, entry]() {
+            run(entry);
+        }));
+    }
+}
+
+void ZProbeScheduler::run(const EntryPtr &entry)
+{
+    t_currentToken = entry->token;
+    if (!isCanceled()) {
+        entry->job();
+    } else {
+        qDebug() << "Skip canceled probe job";
+        if (entry->dropped) {
+            entry->dropped();
+        }
+    }
+    t_currentToken.reset();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_lanes[entry->lane].running.removeOne(entry);
+    }
+
+    schedule(entry->lane);
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef ZPROBESCHEDULER_H
+#define ZPROBESCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QSharedPointer>
+
+#include <functional>
+
+#include "zsingleton.h"
+
+/**
+ * @brief Prioritized, cancellable scheduler for probe jobs
+ *
+ * Jobs run on private thread pools, so stale probes never fill the global
+ * QThreadPool. Probe jobs share a lane capped at a few threads to bound the
+ * I/O and ffprobe processes, CPU-bound table work (filters, copies, spills,
+ * sessions, charts) has its own lane sized to the CPU count, so neither waits
+ * behind the other. Interactive jobs are started before background ones. A
+ * new job for the same owner supersedes the previous one in either lane: a
+ * pending job is dropped, a running one is canceled. Canceling kills the
+ * ffprobe subprocess or interrupts the libav demuxer of the running job.
+ */
+class ZProbeScheduler
+{
+    DECLARE_ZSINGLETON(ZProbeScheduler)
+
+public:
+    enum Priority {
+        PRIORITY_BACKGROUND = 0,
+        PRIORITY_INTERACTIVE = 1
+    };
+
+    using CancelToken = QSharedPointer<QAtomicInt>;
+    using Job = std::function<void()>;
+
+    /**
+     * @brief Queue a probe job
+     * @param owner Jobs of the same owner coalesce, nullptr never supersedes anything
+     * @param priority Interactive jobs start first
+     * @param job Runs on a scheduler thread, use isCanceled() to bail out early
+     * @param dropped Called instead of the job if it is canceled before it started, from any thread
+     * @return Token to cancel this job
+     */
+    CancelToken submit(const QObject *owner, Priority priority, const Job &job, const Job &dropped = Job());
+
+    // Queue CPU-bound work on an already loaded table, same rules as submit()
+    CancelToken submitTable(const QObject *owner, Priority priority, const Job &job, const Job &dropped = Job());
+
+    // Cancel the pending and running jobs of an owner
+    void cancel(const QObject *owner);
+    static void cancel(const CancelToken &token);
+
+    // Limit of the probe lane, the table lane follows QThread::idealThreadCount()
+    void setMaxConcurrency(int maxConcurrency);
+    int maxConcurrency() const;
+
+    // Token of the job running on the calling thread, null outside of scheduler jobs
+    static CancelToken currentToken();
+    static bool isCanceled();
+    static bool isCanceled(const CancelToken &token);
+
+private:
+    enum LaneId {
+        LANE_PROBE = 0,
+        LANE_TABLE,
+        LANE_COUNT
+    };
+
+    struct Entry {
+        const QObject *owner = nullptr;
+        LaneId lane = LANE_PROBE;
+        Priority priority = PRIORITY_BACKGROUND;
+        Job job;
+        Job dropped;
+        CancelToken token;
+    };
+    using EntryPtr = QSharedPointer<Entry>;
+
+    struct Lane {
+        QThreadPool pool;
+        QList<EntryPtr> pending;
+        QList<EntryPtr> running;
+        int maxConcurrency = 1;
+    };
+
+    ZProbeScheduler();
+    ~ZProbeScheduler() = default;
+
+    CancelToken enqueue(LaneId lane, const QObject *owner, Priority priority, const Job &job, const Job &dropped);
+    void supersede(const QObject *owner, QList<Job> &droppedJobs);
+    void schedule(LaneId lane);
+    void run(const EntryPtr &entry);
+
+private:
+    mutable QMutex m_mutex;
+    Lane m_lanes[LANE_COUNT];
+};
+
+#endif // ZPROBESCHEDULER_H
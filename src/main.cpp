@@ -124,7 +124,8 @@ int commandConfig(const QApplication& app) {
 
     parser.process(app);
 
-    QString streamType, frameType, filePath, mediaCmd;
+    QString streamType, frameType, filePath, mediaCmd, streamSpecifier;
+    ZProbeEngine::Sections sections = ZProbeEngine::SECTION_NONE;
 
     // media info
     if (parser.isSet(mediaInfoOption)) {
@@ -153,27 +154,30 @@ int commandConfig(const QApplication& app) {
                 return 1;
             }
             if (frameType.startsWith("f")) {
-                frameType = SHOW_FRAMES;
+                sections |= ZProbeEngine::SECTION_FRAMES;
             } else {
-                frameType = SHOW_PACKETS;
+                sections |= ZProbeEngine::SECTION_PACKETS;
             }
 
-            mediaCmd = QString("%1 -select_streams %2:0").arg(frameType).arg(streamType);
+            streamSpecifier = QString("%1:0").arg(streamType);
         }
 
         if (parser.isSet(mediaInfoStreamsOption)) {
-            mediaCmd.append(SHOW_STREAMS + QString(" "));
+            sections |= ZProbeEngine::SECTION_STREAMS;
         }
 
         if (parser.isSet(mediaInfoFormatOption)) {
-            mediaCmd.append(SHOW_FORMAT + QString(" "));
+            sections |= ZProbeEngine::SECTION_FORMAT;
         }
 
+        mediaCmd = ZProbeEngine::buildCommand(sections, streamSpecifier);
+
         // cli options
         if (parser.isSet(cliOption)) {
             ZFfprobe ffprobe;
 
-            QString mediaInfo = ffprobe.getMediaInfoJsonFormat(mediaCmd, filePath);
+            // all requested sections from a single probe
+            QByteArray mediaInfo = ffprobe.probeSections(sections, filePath, streamSpecifier).toJson();
             if (mediaInfo.isEmpty()) {
                 qDebug() << "Error: Media file information cannot be obtained. "
                             "Please check if the file path is correct";
@@ -181,7 +185,7 @@ int commandConfig(const QApplication& app) {
                 return 1;
             }
 
-            printf("\nMedai Info:\n%s", mediaInfo.toUtf8().data());
+            printf("\nMedai Info:\n%s", mediaInfo.data());
             return 0;
         }
     }
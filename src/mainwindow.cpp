@@ -7,6 +7,8 @@
 #include <QFileInfo>
 #include <QTabWidget>
 #include <QTimer>
+#include <QPointer>
+#include <QSharedPointer>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -94,6 +96,7 @@ QList<QAction *> MainWindow::getFilesAvailableAction()
     tmpActions << ui->actionOpen;
     tmpActions << ui->actionOpen_Files;
     tmpActions << ui->actionOpen_Folder;
+    tmpActions << ui->actionOpen_Session;
     tmpActions << ui->actionExport;
 
     return tmpActions;
@@ -132,20 +135,91 @@ void MainWindow::showMediaInfo(const QString fileName, const QString &function,
     progressDlg->setAutoClose(true);
 
     progressDlg->start();
-    QtConcurrent::run([=](){
-        QString formats = m_probe.getMediaInfoJsonFormat(function, fileName);
-        bool ok = QMetaObject::invokeMethod(this, "popMediaInfoWindow",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(QString, windwowTitle),
-                                  Q_ARG(QString, formats),
-                                  Q_ARG(ZExtraInfo, extrainfo)
-                                  );
-        qDebug() << "Media info query: " << ok;
+
+    // Interactive job without an owner: several media info windows may load side by side.
+    // The dialog is not modal any more, Cancel kills ffprobe or interrupts the demuxer.
+    ZProbeScheduler::CancelToken token = ZProbeScheduler::instance().submit(nullptr, ZProbeScheduler::PRIORITY_INTERACTIVE, [=](){
+        ZProbeScheduler::CancelToken jobToken = ZProbeScheduler::currentToken();
+
+        // Packet/frame tables are streamed into the window while the file is still being read
+        struct StreamTarget {
+            bool opened = false;
+            QPointer<TabelFormatWG> window;
+        };
+        QSharedPointer<StreamTarget> target = QSharedPointer<StreamTarget>::create();
+        qint64 records = 0;
+
+        // Long files are paged by time window, only the rows around the visible ones stay in memory
+        double startTime = 0.0;
+        double duration = 0.0;
+        double pagedMinDuration = Common::instance()->getConfigValue(PAGED_TABLE_MIN_DURATION_KEY, DEFAULT_PAGED_TABLE_MIN_DURATION).toDouble();
+        ZProbeEngine::Sections sections;
+        if (extrainfo.formatKey == FORMAT_TABLE && pagedMinDuration > 0
+            && ZProbeEngine::parseCommand(function, &sections, nullptr)
+            && (sections == ZProbeEngine::SECTION_PACKETS || sections == ZProbeEngine::SECTION_FRAMES)
+            && m_probe.getMediaTimeRange(fileName, &startTime, &duration)
+            && duration >= pagedMinDuration) {
+            QMetaObject::invokeMethod(this, [=]() {
+                popMediaPagedWindow(windwowTitle, function, fileName, startTime, duration, extrainfo);
+            }, Qt::QueuedConnection);
+
+            emit progressDlg->toFinish();
+            progressDlg->deleteLater();
+            return;
+        }
+
+        bool streamed = extrainfo.formatKey == FORMAT_TABLE &&
+            m_probe.streamMediaInfoTable(function, fileName, [&](const QStringList &headers, const QList<QStringList> &rows) {
+                records += rows.size();
+                QMetaObject::invokeMethod(this, [=]() {
+                    if (!target->opened) {
+                        target->opened = true;
+                        target->window = popMediaTableWindow(windwowTitle, headers, rows, extrainfo);
+                        target->window->setSourceFile(fileName);
+                    } else if (target->window) {
+                        target->window->appendTable(headers, rows);
+                    } else {
+                        // window closed while streaming
+                        ZProbeScheduler::cancel(jobToken);
+                    }
+                }, Qt::QueuedConnection);
+
+                emit progressDlg->messageChanged(tr("Parsed %1 records...").arg(records));
+                return !ZProbeScheduler::isCanceled();
+            });
+
+        if (!streamed && records > 0 && !ZProbeScheduler::isCanceled()) {
+            // the read failed after rows were shown, the window must not pass for the whole table
+            QMetaObject::invokeMethod(this, [=]() {
+                if (target->window) {
+                    target->window->setWindowTitle(target->window->windowTitle() + tr(" [incomplete]"));
+                    QMessageBox::warning(target->window, tr("Warning"),
+                                         tr("Reading %1 stopped on an error, the table is incomplete.").arg(fileName));
+                }
+            }, Qt::QueuedConnection);
+        } else if (!streamed && !ZProbeScheduler::isCanceled()) {
+            QString formats = m_probe.getMediaInfoJsonFormat(function, fileName);
+            if (!ZProbeScheduler::isCanceled()) {
+                bool ok = QMetaObject::invokeMethod(this, "popMediaInfoWindow",
+                                          Qt::QueuedConnection,
+                                          Q_ARG(QString, windwowTitle),
+                                          Q_ARG(QString, formats),
+                                          Q_ARG(ZExtraInfo, extrainfo)
+                                          );
+                qDebug() << "Media info query: " << ok;
+            }
+        }
         emit progressDlg->messageChanged("Finsh parse");
         emit progressDlg->toFinish();
         progressDlg->deleteLater();
+    }, [=]() {
+        emit progressDlg->toFinish();
+        progressDlg->deleteLater();
+    });
+
+    connect(progressDlg, &ProgressDialog::canceled, this, [token]() {
+        ZProbeScheduler::cancel(token);
     });
-    progressDlg->exec();
 }
 
 void MainWindow::InitConnectation()
@@ -220,6 +294,38 @@ void MainWindow::popMediaInfoWindow(QString title, const QString &info, const ZE
     qDebug() << title << info.size();
 }
 
+TabelFormatWG *MainWindow::popMediaTableWindow(const QString &title, const QStringList &headers, const QList<QStringList> &rows, const ZExtraInfo &extrainfo)
+{
+    TabelFormatWG *mediaInfoWindow = new TabelFormatWG;
+    mediaInfoWindow->setExtraInfo(extrainfo);
+
+    mediaInfoWindow->setWindowTitle(title);
+    mediaInfoWindow->setAttribute(Qt::WA_DeleteOnClose);
+    mediaInfoWindow->show();
+    ZWindowHelper::centerToParent(mediaInfoWindow);
+    mediaInfoWindow->loadTable(headers, rows);
+
+    qDebug() << title << rows.size();
+    return mediaInfoWindow;
+}
+
+TabelFormatWG *MainWindow::popMediaPagedWindow(const QString &title, const QString &command, const QString &fileName,
+                                               double startTime, double duration, const ZExtraInfo &extrainfo)
+{
+    TabelFormatWG *mediaInfoWindow = new TabelFormatWG;
+    mediaInfoWindow->setExtraInfo(extrainfo);
+
+    mediaInfoWindow->setWindowTitle(title);
+    mediaInfoWindow->setAttribute(Qt::WA_DeleteOnClose);
+    mediaInfoWindow->show();
+    ZWindowHelper::centerToParent(mediaInfoWindow);
+    mediaInfoWindow->setSourceFile(fileName);
+    mediaInfoWindow->loadPaged(command, fileName, startTime, duration);
+
+    qDebug() << title << "paged" << duration;
+    return mediaInfoWindow;
+}
+
 void MainWindow::popMediaPropsWindow(const QString &fileName)
 {
     // Update content if a valid file is provided
@@ -513,6 +619,36 @@ void MainWindow::slotMenuFileTriggered(QAction *action)
 
         return;
     }
+    if (ui->actionOpen_Session == action) {
+        QString fileName = QFileDialog::getOpenFileName(
+            nullptr,
+            tr("Open Session"),
+            QDir::homePath(),
+            tr("Table Sessions (*%1)").arg(SESSION_FILE_SUFFIX)
+            );
+
+        if (!fileName.isEmpty()) {
+            TabelFormatWG *sessionWindow = new TabelFormatWG;
+            sessionWindow->setWindowTitle(QFileInfo(fileName).fileName());
+            sessionWindow->setAttribute(Qt::WA_DeleteOnClose);
+            sessionWindow->show();
+            ZWindowHelper::centerToParent(sessionWindow);
+            sessionWindow->loadSession(fileName);
+        }
+
+        return;
+    }
+
+    if (ui->actionCompare_Tables == action) {
+        TableDiffWG *diffWindow = new TableDiffWG;
+        diffWindow->setWindowTitle(tr("Compare Tables"));
+        diffWindow->setAttribute(Qt::WA_DeleteOnClose);
+        diffWindow->show();
+        ZWindowHelper::centerToParent(diffWindow);
+
+        return;
+    }
+
     if (ui->actionExport == action) {
         ExportWG *exportDlg = new ExportWG;
         exportDlg->setWindowTitle(tr("Export Files"));
@@ -867,7 +1003,7 @@ void MainWindow::slotDynamicStreamActionTriggered()
         QString codecType = parts[2]; // "Video" or "Audio"
         QString streamIndex = parts[3]; // "0"
         // Build the ffprobe command for default actions (use first stream of type)
-        QString command = QString("%1 %2 %3").arg(SHOW_FRAMES)
+        QString command = QString("%1 %2 %3").arg(type == "Packets" ? SHOW_PACKETS : SHOW_FRAMES)
                               .arg(SELECT_STREAMS)
                               // .arg(0)
                               .arg(streamIndex);
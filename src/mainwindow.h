@@ -15,6 +15,7 @@
 #include <QFile>
 
 #include "common/zffprobe.h"
+#include "common/zprobescheduler.h"
 #include "common/zwindowhelper.h"
 #include "common/common.h"
 #include "common/zlogger.h"
@@ -24,6 +25,7 @@
 #include "widgets/jsonfmtwg.h"
 #include "widgets/globalconfingwg.h"
 #include "widgets/tabelfmtwg.h"
+#include "widgets/tablediffwg.h"
 #include "widgets/logwg.h"
 #include "widgets/fileswg.h"
 #include "widgets/progressdlg.h"
@@ -61,6 +63,9 @@ private slots:
     void InitConnectation();
     void popBasicInfoWindow(QString title, const QString &info, const ZExtraInfo &extrainfo);
     void popMediaInfoWindow(QString title, const QString &info, const ZExtraInfo &extrainfo);
+    TabelFormatWG *popMediaTableWindow(const QString &title, const QStringList &headers, const QList<QStringList> &rows, const ZExtraInfo &extrainfo);
+    TabelFormatWG *popMediaPagedWindow(const QString &title, const QString &command, const QString &fileName,
+                                       double startTime, double duration, const ZExtraInfo &extrainfo);
     void popMediaPropsWindow(const QString &fileName);
     void loadMediaProperties(const QString &fileName);
     void loadMediaPropertiesAsync(const QString &fileName);
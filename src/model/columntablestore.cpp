@@ -0,0 +1,1227 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "columntablestore.h"
+
+#include <QThread>
+#include <QtConcurrent>
+#include <QTemporaryFile>
+#include <QDir>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#define DECIMAL_MAX_DIGITS 9        // digits after the point kept in a decimal column
+#define EXCEPTION_MIN_COUNT 64      // a numeric column turns into strings once it has more odd cells
+#define EXCEPTION_MAX_RATIO 16      // ... than this and more than one cell in EXCEPTION_MAX_RATIO
+#define DICTIONARY_MIN_SIZE 4096    // a dictionary column turns into plain text once it has more values
+#define DICTIONARY_MAX_RATIO 2      // ... than this and more than one value per DICTIONARY_MAX_RATIO cells
+#define SORT_MIN_CHUNK 16384        // rows per thread below which a sort stays on one thread
+#define SPILL_FILE_TEMPLATE "media-debuger-table-XXXXXX.spill"
+
+namespace {
+
+const qint64 NULL_NUMBER = std::numeric_limits<qint64>::min();
+const qint64 EXCEPTION_NUMBER = std::numeric_limits<qint64>::min() + 1;
+
+const qint64 POW10[DECIMAL_MAX_DIGITS + 1] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL
+};
+
+// "-12.0400" -> mantissa -120400, 4 decimals. No exponent, no '+', no leading zeros.
+bool parseDecimal(const QString &text, int *decimals, qint64 *mantissa)
+{
+    int point = text.indexOf('.');
+    if (point < 0 || point != text.lastIndexOf('.')) {
+        return false;
+    }
+
+    int begin = text.startsWith('-') ? 1 : 0;
+    int fraction = text.size() - point - 1;
+    if (point == begin || fraction < 1 || fraction > DECIMAL_MAX_DIGITS) {
+        return false;
+    }
+    if (point - begin > 1 && text.at(begin) == '0') {
+        return false;
+    }
+
+    for (int i = begin; i < text.size(); ++i) {
+        if (i != point && !text.at(i).isDigit()) {
+            return false;
+        }
+    }
+
+    bool ok = false;
+    qint64 value = (text.mid(begin, point - begin) + text.mid(point + 1)).toLongLong(&ok);
+    if (!ok || value == NULL_NUMBER || value == EXCEPTION_NUMBER) {
+        return false;
+    }
+
+    *decimals = fraction;
+    *mantissa = begin ? -value : value;
+    return true;
+}
+
+bool parseInteger(const QString &text, qint64 *value)
+{
+    bool ok = false;
+    qint64 number = text.toLongLong(&ok);
+    if (!ok || number == NULL_NUMBER || number == EXCEPTION_NUMBER || QString::number(number) != text) {
+        return false;
+    }
+
+    *value = number;
+    return true;
+}
+
+template <typename T>
+QVector<T> permuted(const QVector<T> &values, const QVector<int> &order)
+{
+    QVector<T> result;
+    result.reserve(order.size());
+    for (int row : order) {
+        result.append(values.at(row));
+    }
+    return result;
+}
+
+// Drops the listed rows (ascending) and moves the kept ones up, each cell moves at most once
+template <typename T>
+void compacted(QVector<T> &values, const QVector<int> &rows)
+{
+    if (rows.isEmpty()) {
+        return;
+    }
+
+    T *data = values.data();
+    int size = values.size();
+    int write = rows.first();
+    for (int i = 0; i < rows.size(); ++i) {
+        int end = i + 1 < rows.size() ? rows.at(i + 1) : size;
+        for (int read = rows.at(i) + 1; read < end; ++read) {
+            data[write++] = std::move(data[read]);
+        }
+    }
+    values.resize(write);
+}
+
+// Sorted runs per thread, then neighbouring runs are merged pairwise until one is left
+template <typename Less>
+void parallelStableSort(int *rows, int count, const Less &less)
+{
+    int chunks = qBound(1, QThread::idealThreadCount(), count / SORT_MIN_CHUNK);
+    if (chunks == 1) {
+        std::stable_sort(rows, rows + count, less);
+        return;
+    }
+
+    QVector<int> bounds(chunks + 1);
+    for (int i = 0; i <= chunks; ++i) {
+        bounds[i] = static_cast<int>(qint64(count) * i / chunks);
+    }
+
+    QVector<int> runs(chunks);
+    std::iota(runs.begin(), runs.end(), 0);
+    QtConcurrent::blockingMap(runs, [&](int run) {
+        std::stable_sort(rows + bounds.at(run), rows + bounds.at(run + 1), less);
+    });
+
+    // std::merge takes the left run first on ties, the sort stays stable
+    QVector<int> buffer(count);
+    int *from = rows;
+    int *to = buffer.data();
+    for (int width = 1; width < chunks; width *= 2) {
+        QVector<int> merges;
+        for (int run = 0; run < chunks; run += 2 * width) {
+            merges.append(run);
+        }
+        QtConcurrent::blockingMap(merges, [&](int run) {
+            int begin = bounds.at(run);
+            int middle = bounds.at(qMin(run + width, chunks));
+            int end = bounds.at(qMin(run + 2 * width, chunks));
+            std::merge(from + begin, from + middle, from + middle, from + end, to + begin, less);
+        });
+        std::swap(from, to);
+    }
+
+    if (from != rows) {
+        std::copy(from, from + count, rows);
+    }
+}
+
+template <typename Less>
+void sortTail(QVector<int> &rows, int sortedCount, const Less &less)
+{
+    int *data = rows.data();
+    parallelStableSort(data + sortedCount, rows.size() - sortedCount, less);
+    if (sortedCount > 0 && sortedCount < rows.size()) {
+        std::inplace_merge(data, data + sortedCount, data + rows.size(), less);
+    }
+}
+
+template <typename Less>
+void sortRows(QVector<int> &rows, int sortedCount, Qt::SortOrder order, const Less &less)
+{
+    if (order == Qt::DescendingOrder) {
+        // swapped arguments, equal rows still keep their order
+        sortTail(rows, sortedCount, [&less](int left, int right) { return less(right, left); });
+    } else {
+        sortTail(rows, sortedCount, less);
+    }
+}
+
+}
+
+/*
+ * Mapped cells of a spilled column, never written once mapped so snapshots share
+ * it freely. TYPE_TEXT: rows + 1 qint64 offsets into the UTF-16 text after them.
+ * The file is removed with the last column that refers to it.
+ */
+struct ColumnTableStore::SpillBlock {
+    QTemporaryFile file;
+    const uchar *data = nullptr;
+    int rows = 0;
+};
+
+ColumnTableStore::ColumnTableStore()
+    : m_rowCount(0)
+    , m_revision(0)
+    , m_version(0)
+{
+}
+
+int ColumnTableStore::rowCount() const
+{
+    return m_rowCount;
+}
+
+int ColumnTableStore::columnCount() const
+{
+    return m_columns.size();
+}
+
+void ColumnTableStore::clear()
+{
+    m_rowCount = 0;
+    m_columns.clear();
+    ++m_revision;
+    ++m_version;
+}
+
+void ColumnTableStore::setColumnCount(int count)
+{
+    m_columns.resize(qMax(0, count));
+    ++m_version;
+}
+
+void ColumnTableStore::appendRow(const QStringList &row)
+{
+    if (row.size() > m_columns.size()) {
+        setColumnCount(row.size());
+    }
+
+    for (int i = 0; i < m_columns.size(); ++i) {
+        appendCell(m_columns[i], i < row.size() ? row.at(i) : QString());
+    }
+    ++m_rowCount;
+    ++m_version;
+}
+
+void ColumnTableStore::appendRows(const QList<QStringList> &rows)
+{
+    int size = m_rowCount + rows.size();
+    for (Column &column : m_columns) {
+        restoreColumn(column);
+        switch (column.type) {
+        case TYPE_INT64:
+        case TYPE_DECIMAL:
+        case TYPE_BOOL:
+            column.numbers.reserve(size);
+            break;
+        case TYPE_DICTIONARY:
+            if (column.codeWidth == 1) {
+                column.codes8.reserve(size);
+            } else if (column.codeWidth == 2) {
+                column.codes16.reserve(size);
+            } else {
+                column.codes32.reserve(size);
+            }
+            break;
+        case TYPE_TEXT:
+            column.texts.reserve(size);
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (const QStringList &row : rows) {
+        appendRow(row);
+    }
+}
+
+void ColumnTableStore::removeRows(int row, int count)
+{
+    if (row < 0 || count <= 0 || row >= m_rowCount) {
+        return;
+    }
+    count = qMin(count, m_rowCount - row);
+
+    for (Column &column : m_columns) {
+        restoreColumn(column);
+        switch (column.type) {
+        case TYPE_EMPTY:
+            break;
+        case TYPE_DICTIONARY:
+            if (column.codeWidth == 1) {
+                column.codes8.remove(row, count);
+            } else if (column.codeWidth == 2) {
+                column.codes16.remove(row, count);
+            } else {
+                column.codes32.remove(row, count);
+            }
+            break;
+        case TYPE_TEXT:
+            column.texts.remove(row, count);
+            break;
+        default:
+            column.numbers.remove(row, count);
+            break;
+        }
+
+        if (!column.exceptions.isEmpty()) {
+            QHash<int, QString> exceptions;
+            for (auto it = column.exceptions.constBegin(); it != column.exceptions.constEnd(); ++it) {
+                if (it.key() < row) {
+                    exceptions.insert(it.key(), it.value());
+                } else if (it.key() >= row + count) {
+                    exceptions.insert(it.key() - count, it.value());
+                }
+            }
+            column.exceptions = exceptions;
+        }
+    }
+    m_rowCount -= count;
+    ++m_version;
+}
+
+void ColumnTableStore::removeRows(const QVector<int> &rows)
+{
+    if (rows.isEmpty() || rows.first() < 0 || rows.last() >= m_rowCount) {
+        return;
+    }
+
+    // columns are independent, each one is compacted on its own thread
+    QVector<int> columns(m_columns.size());
+    std::iota(columns.begin(), columns.end(), 0);
+    Column *data = m_columns.data();
+    QtConcurrent::blockingMap(columns, [data, &rows](int column) {
+        compactColumn(data[column], rows);
+    });
+    m_rowCount -= rows.size();
+    ++m_version;
+}
+
+QString ColumnTableStore::text(int row, int column) const
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) {
+        return QString();
+    }
+
+    const Column &entry = m_columns.at(column);
+    switch (entry.type) {
+    case TYPE_EMPTY:
+        return QString();
+    case TYPE_DICTIONARY:
+        return entry.dictionary.at(codeAt(entry, row));
+    case TYPE_TEXT:
+        return textAt(entry, row);
+    default:
+        break;
+    }
+
+    qint64 value = numberData(entry)[row];
+    if (value == NULL_NUMBER) {
+        return QString();
+    }
+    if (value == EXCEPTION_NUMBER) {
+        return entry.exceptions.value(row);
+    }
+    return formatNumber(entry, value);
+}
+
+QStringList ColumnTableStore::rowData(int row) const
+{
+    QStringList data;
+    if (row < 0 || row >= m_rowCount) {
+        return data;
+    }
+
+    data.reserve(m_columns.size());
+    for (int i = 0; i < m_columns.size(); ++i) {
+        data.append(text(row, i));
+    }
+    return data;
+}
+
+QList<QStringList> ColumnTableStore::rows() const
+{
+    QList<QStringList> data;
+    data.reserve(m_rowCount);
+    for (int i = 0; i < m_rowCount; ++i) {
+        data.append(rowData(i));
+    }
+    return data;
+}
+
+void ColumnTableStore::setText(int row, int column, const QString &text)
+{
+    if (row < 0 || row >= m_rowCount || column < 0) {
+        return;
+    }
+    if (column >= m_columns.size()) {
+        setColumnCount(column + 1);
+    }
+
+    setCell(m_columns[column], row, text);
+    ++m_version;
+}
+
+bool ColumnTableStore::isNull(int row, int column) const
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) {
+        return true;
+    }
+
+    const Column &entry = m_columns.at(column);
+    switch (entry.type) {
+    case TYPE_EMPTY:
+        return true;
+    case TYPE_DICTIONARY:
+        return codeAt(entry, row) == 0;
+    case TYPE_TEXT:
+        return textAt(entry, row).isEmpty();
+    default:
+        return numberData(entry)[row] == NULL_NUMBER;
+    }
+}
+
+ColumnTableStore::ColumnType ColumnTableStore::columnType(int column) const
+{
+    return column >= 0 && column < m_columns.size() ? m_columns.at(column).type : TYPE_EMPTY;
+}
+
+bool ColumnTableStore::numberValue(int row, int column, double *value) const
+{
+    if (row < 0 || row >= m_rowCount || column < 0 || column >= m_columns.size()) {
+        return false;
+    }
+
+    const Column &entry = m_columns.at(column);
+    if (entry.type != TYPE_INT64 && entry.type != TYPE_DECIMAL && entry.type != TYPE_BOOL) {
+        return false;
+    }
+
+    qint64 number = numberData(entry)[row];
+    if (number == NULL_NUMBER || number == EXCEPTION_NUMBER) {
+        return false;
+    }
+
+    if (value) {
+        *value = entry.type == TYPE_DECIMAL ? static_cast<double>(number) / POW10[entry.decimals]
+                                            : static_cast<double>(number);
+    }
+    return true;
+}
+
+const qint64 *ColumnTableStore::numbers(int column) const
+{
+    ColumnType type = columnType(column);
+    if (type != TYPE_INT64 && type != TYPE_DECIMAL && type != TYPE_BOOL) {
+        return nullptr;
+    }
+    return numberData(m_columns.at(column));
+}
+
+int ColumnTableStore::decimals(int column) const
+{
+    return columnType(column) == TYPE_DECIMAL ? m_columns.at(column).decimals : 0;
+}
+
+qint64 ColumnTableStore::scale(int decimals)
+{
+    return POW10[qBound(0, decimals, DECIMAL_MAX_DIGITS)];
+}
+
+bool ColumnTableStore::scaleNumber(const QString &text, int decimals, qint64 *raw, bool *exact)
+{
+    decimals = qBound(0, decimals, DECIMAL_MAX_DIGITS);
+
+    QString digits = text.trimmed();
+    bool negative = digits.startsWith('-');
+    if (negative || digits.startsWith('+')) {
+        digits.remove(0, 1);
+    }
+    int point = digits.indexOf('.');
+    QString whole = point < 0 ? digits : digits.left(point);
+    QString fraction = point < 0 ? QString() : digits.mid(point + 1);
+
+    bool plain = !whole.isEmpty() || !fraction.isEmpty();
+    for (const QString &part : {whole, fraction}) {
+        for (QChar ch : part) {
+            plain = plain && ch >= '0' && ch <= '9';
+        }
+    }
+
+    qint64 value = 0;
+    bool dropped = false;
+    if (plain) {
+        // shift the point by decimals digits in the text, no rounding on the way
+        QString kept = whole + fraction.left(decimals).leftJustified(decimals, '0');
+        for (QChar ch : fraction.mid(decimals)) {
+            dropped = dropped || ch != '0';
+        }
+
+        bool ok = false;
+        value = kept.isEmpty() ? 0 : kept.toLongLong(&ok);
+        if (!kept.isEmpty() && !ok) {
+            return false;
+        }
+        if (negative) {
+            value = dropped ? -value - 1 : -value;
+        }
+    } else {
+        // exponent notation, exact enough for the few literals written that way
+        bool ok = false;
+        double number = text.toDouble(&ok);
+        double scaled = number * static_cast<double>(POW10[decimals]);
+        if (!ok || !(std::abs(scaled) < 9.0e18)) {
+            return false;
+        }
+        double down = std::floor(scaled);
+        value = static_cast<qint64>(down);
+        dropped = down != scaled;
+    }
+
+    // keep the sentinels free and room for the next integer above
+    if (value <= EXCEPTION_NUMBER || value == std::numeric_limits<qint64>::max()) {
+        return false;
+    }
+
+    *raw = value;
+    *exact = !dropped;
+    return true;
+}
+
+int ColumnTableStore::maxTextLength(int column) const
+{
+    return column >= 0 && column < m_columns.size() ? m_columns.at(column).maxLength : 0;
+}
+
+bool ColumnTableStore::isDictionary(int column) const
+{
+    return columnType(column) == TYPE_DICTIONARY;
+}
+
+quint32 ColumnTableStore::code(int row, int column) const
+{
+    if (row < 0 || row >= m_rowCount || !isDictionary(column)) {
+        return 0;
+    }
+    return codeAt(m_columns.at(column), row);
+}
+
+int ColumnTableStore::dictionarySize(int column) const
+{
+    return isDictionary(column) ? m_columns.at(column).dictionary.size() : 0;
+}
+
+QString ColumnTableStore::dictionaryValue(int column, quint32 code) const
+{
+    if (!isDictionary(column) || code >= static_cast<quint32>(m_columns.at(column).dictionary.size())) {
+        return QString();
+    }
+    return m_columns.at(column).dictionary.at(code);
+}
+
+void ColumnTableStore::codes(int column, int first, int count, quint32 *out) const
+{
+    if (!isDictionary(column) || first < 0 || count <= 0 || first + count > m_rowCount) {
+        return;
+    }
+
+    // one switch per batch, the copy loops stay tight
+    const Column &entry = m_columns.at(column);
+    const uchar *spilled = entry.spill ? entry.spill->data : nullptr;
+    switch (entry.codeWidth) {
+    case 1: {
+        const quint8 *codes = spilled ? spilled : entry.codes8.constData();
+        std::copy(codes + first, codes + first + count, out);
+        break;
+    }
+    case 2: {
+        const quint16 *codes = spilled ? reinterpret_cast<const quint16 *>(spilled) : entry.codes16.constData();
+        std::copy(codes + first, codes + first + count, out);
+        break;
+    }
+    default: {
+        const quint32 *codes = spilled ? reinterpret_cast<const quint32 *>(spilled) : entry.codes32.constData();
+        std::copy(codes + first, codes + first + count, out);
+        break;
+    }
+    }
+}
+
+QVector<int> ColumnTableStore::dictionaryRanks(int column) const
+{
+    if (!isDictionary(column)) {
+        return QVector<int>();
+    }
+
+    const QStringList &dictionary = m_columns.at(column).dictionary;
+    QVector<quint32> order(dictionary.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<quint32>(i);
+    }
+    std::sort(order.begin(), order.end(), [&dictionary](quint32 left, quint32 right) {
+        return dictionary.at(left) < dictionary.at(right);
+    });
+
+    // equal strings can not occur, every value is interned once
+    QVector<int> ranks(order.size());
+    for (int i = 0; i < order.size(); ++i) {
+        ranks[order.at(i)] = i;
+    }
+    return ranks;
+}
+
+QVector<int> ColumnTableStore::sortedRows(int column, Qt::SortOrder order, int sortedCount) const
+{
+    QVector<int> rows(m_rowCount);
+    std::iota(rows.begin(), rows.end(), 0);
+    if (column < 0 || column >= m_columns.size() || m_rowCount < 2) {
+        return rows;
+    }
+    sortedCount = qBound(0, sortedCount, m_rowCount);
+
+    const Column &entry = m_columns.at(column);
+    switch (entry.type) {
+    case TYPE_EMPTY:
+        break;
+    case TYPE_DICTIONARY: {
+        // one rank per row, the comparisons never touch the strings
+        QVector<int> ranks = dictionaryRanks(column);
+        QVector<int> keys(m_rowCount);
+        for (int row = 0; row < m_rowCount; ++row) {
+            keys[row] = ranks.at(codeAt(entry, row));
+        }
+        const int *key = keys.constData();
+        sortRows(rows, sortedCount, order, [key](int left, int right) {
+            return key[left] < key[right];
+        });
+        break;
+    }
+    case TYPE_TEXT: {
+        // a spilled column is sorted on a heap copy of its strings
+        QVector<QString> restored;
+        if (entry.spill) {
+            restored.resize(m_rowCount);
+            for (int row = 0; row < m_rowCount; ++row) {
+                restored[row] = textAt(entry, row);
+            }
+        }
+        const QString *texts = entry.spill ? restored.constData() : entry.texts.constData();
+        sortRows(rows, sortedCount, order, [texts](int left, int right) {
+            return texts[left] < texts[right];
+        });
+        break;
+    }
+    default: {
+        // decimals share one scale, the mantissas order like the values. Nulls come
+        // first, then the cells that did not fit the type, by text.
+        const qint64 *numbers = numberData(entry);
+        const QHash<int, QString> &exceptions = entry.exceptions;
+        sortRows(rows, sortedCount, order, [numbers, &exceptions](int left, int right) {
+            if (numbers[left] == EXCEPTION_NUMBER && numbers[right] == EXCEPTION_NUMBER) {
+                return exceptions.value(left) < exceptions.value(right);
+            }
+            return numbers[left] < numbers[right];
+        });
+        break;
+    }
+    }
+    return rows;
+}
+
+void ColumnTableStore::permuteRows(const QVector<int> &order)
+{
+    if (order.size() != m_rowCount) {
+        return;
+    }
+
+    QVector<int> inverse(m_rowCount);
+    for (int i = 0; i < order.size(); ++i) {
+        inverse[order.at(i)] = i;
+    }
+
+    // columns are independent, each one is moved on its own thread
+    QVector<int> columns(m_columns.size());
+    std::iota(columns.begin(), columns.end(), 0);
+    Column *data = m_columns.data();
+    QtConcurrent::blockingMap(columns, [data, &order, &inverse](int column) {
+        permuteColumn(data[column], order, inverse);
+    });
+    ++m_version;
+}
+
+quint64 ColumnTableStore::revision() const
+{
+    return m_revision;
+}
+
+qint64 ColumnTableStore::memoryUsage() const
+{
+    qint64 bytes = 0;
+    for (int column = 0; column < m_columns.size(); ++column) {
+        bytes += memoryUsage(column);
+    }
+    return bytes;
+}
+
+qint64 ColumnTableStore::memoryUsage(int column) const
+{
+    if (column < 0 || column >= m_columns.size()) {
+        return 0;
+    }
+
+    const Column &entry = m_columns.at(column);
+    qint64 bytes = entry.numbers.capacity() * qint64(sizeof(qint64));
+    bytes += entry.codes8.capacity() + entry.codes16.capacity() * 2 + entry.codes32.capacity() * 4;
+    for (const QString &value : entry.texts) {
+        bytes += value.capacity() * 2 + 24;
+    }
+    for (const QString &value : entry.dictionary) {
+        // string data plus its node in the dictionary and in the index
+        bytes += value.capacity() * 2 + 64;
+    }
+    bytes += entry.exceptions.size() * 64;
+    return bytes;
+}
+
+ColumnTableStore ColumnTableStore::withSpilledColumns(const QList<int> &columns) const
+{
+    ColumnTableStore spilled = *this;
+    for (int column : columns) {
+        if (column < 0 || column >= m_columns.size() || isSpilled(column)
+            || m_columns.at(column).type == TYPE_EMPTY || m_rowCount == 0) {
+            continue;
+        }
+
+        QSharedPointer<const SpillBlock> block = spillColumn(m_columns.at(column), m_rowCount);
+        if (!block) {
+            continue;
+        }
+
+        Column &entry = spilled.m_columns[column];
+        entry.spill = block;
+        entry.numbers = QVector<qint64>();
+        entry.codes8 = QVector<quint8>();
+        entry.codes16 = QVector<quint16>();
+        entry.codes32 = QVector<quint32>();
+        entry.texts = QVector<QString>();
+    }
+    return spilled;
+}
+
+bool ColumnTableStore::adoptSpilledColumns(const ColumnTableStore &spilled)
+{
+    if (spilled.m_version != m_version || spilled.m_columns.size() != m_columns.size()) {
+        return false;
+    }
+
+    // same cells, only where they live changes, so the version stays
+    for (int column = 0; column < m_columns.size(); ++column) {
+        if (spilled.m_columns.at(column).spill && !m_columns.at(column).spill) {
+            m_columns[column] = spilled.m_columns.at(column);
+        }
+    }
+    return true;
+}
+
+bool ColumnTableStore::isSpilled(int column) const
+{
+    return column >= 0 && column < m_columns.size() && m_columns.at(column).spill;
+}
+
+ColumnTableStore::ColumnType ColumnTableStore::detectType(const QString &text, int *decimals)
+{
+    qint64 value = 0;
+
+    if (text.isEmpty()) {
+        return TYPE_EMPTY;
+    }
+    if (text == QLatin1String("true") || text == QLatin1String("false")) {
+        return TYPE_BOOL;
+    }
+    if (parseInteger(text, &value)) {
+        return TYPE_INT64;
+    }
+    if (parseDecimal(text, decimals, &value)) {
+        return TYPE_DECIMAL;
+    }
+    return TYPE_DICTIONARY;
+}
+
+bool ColumnTableStore::encodeNumber(const Column &column, const QString &text, qint64 *value)
+{
+    switch (column.type) {
+    case TYPE_INT64:
+        return parseInteger(text, value);
+    case TYPE_DECIMAL: {
+        int decimals = 0;
+        // "-0.0" has no int64 form, it stays an exception
+        return parseDecimal(text, &decimals, value) && decimals == column.decimals
+               && formatNumber(column, *value) == text;
+    }
+    case TYPE_BOOL:
+        if (text == QLatin1String("true") || text == QLatin1String("false")) {
+            *value = text == QLatin1String("true") ? 1 : 0;
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+QString ColumnTableStore::formatNumber(const Column &column, qint64 value)
+{
+    switch (column.type) {
+    case TYPE_BOOL:
+        return value ? QStringLiteral("true") : QStringLiteral("false");
+    case TYPE_DECIMAL: {
+        quint64 magnitude = value < 0 ? 0 - static_cast<quint64>(value) : static_cast<quint64>(value);
+        quint64 scale = static_cast<quint64>(POW10[column.decimals]);
+        QString text = QString::number(magnitude / scale) + QLatin1Char('.')
+                       + QString::number(magnitude % scale).rightJustified(column.decimals, QLatin1Char('0'));
+        return value < 0 ? text.prepend(QLatin1Char('-')) : text;
+    }
+    default:
+        return QString::number(value);
+    }
+}
+
+void ColumnTableStore::setCell(Column &column, int row, const QString &text)
+{
+    restoreColumn(column);
+    column.maxLength = qMax(column.maxLength, text.size());
+
+    if (column.type == TYPE_EMPTY) {
+        if (text.isEmpty()) {
+            return;
+        }
+        initializeColumn(column, text);
+    }
+
+    if (column.type == TYPE_TEXT) {
+        column.texts[row] = text;
+        return;
+    }
+
+    if (column.type == TYPE_DICTIONARY) {
+        setCodeAt(column, row, text.isEmpty() ? 0 : intern(column, text));
+
+        // mostly unique values, codes and the index only add overhead
+        if (column.dictionary.size() > DICTIONARY_MIN_SIZE
+            && column.dictionary.size() * DICTIONARY_MAX_RATIO > codeCount(column)) {
+            convertToText(column);
+        }
+        return;
+    }
+
+    column.exceptions.remove(row);
+
+    qint64 value = NULL_NUMBER;
+    if (!text.isEmpty() && !encodeNumber(column, text, &value)) {
+        value = EXCEPTION_NUMBER;
+        column.exceptions.insert(row, text);
+    }
+    column.numbers[row] = value;
+
+    if (column.exceptions.size() > EXCEPTION_MIN_COUNT
+        && column.exceptions.size() * EXCEPTION_MAX_RATIO > column.numbers.size()) {
+        convertToDictionary(column);
+    }
+}
+
+void ColumnTableStore::appendCell(Column &column, const QString &text)
+{
+    restoreColumn(column);
+    column.maxLength = qMax(column.maxLength, text.size());
+
+    if (column.type == TYPE_EMPTY) {
+        if (text.isEmpty()) {
+            return;
+        }
+        initializeColumn(column, text);
+    }
+
+    if (column.type == TYPE_TEXT) {
+        column.texts.append(text);
+    } else if (column.type == TYPE_DICTIONARY) {
+        appendCode(column, 0);
+        setCell(column, codeCount(column) - 1, text);
+    } else {
+        column.numbers.append(NULL_NUMBER);
+        setCell(column, column.numbers.size() - 1, text);
+    }
+}
+
+void ColumnTableStore::initializeColumn(Column &column, const QString &text)
+{
+    column.type = detectType(text, &column.decimals);
+
+    // cells before the first value are null
+    if (column.type == TYPE_DICTIONARY) {
+        column.dictionary = QStringList{QString()};
+        column.codeWidth = 1;
+        column.codes8.fill(0, m_rowCount);
+    } else {
+        column.numbers.fill(NULL_NUMBER, m_rowCount);
+    }
+}
+
+void ColumnTableStore::convertToDictionary(Column &column)
+{
+    Column converted;
+    converted.type = TYPE_DICTIONARY;
+    converted.dictionary = QStringList{QString()};
+    converted.codes8.reserve(column.numbers.size());
+
+    for (int row = 0; row < column.numbers.size(); ++row) {
+        qint64 value = column.numbers.at(row);
+        if (value == NULL_NUMBER) {
+            appendCode(converted, 0);
+        } else if (value == EXCEPTION_NUMBER) {
+            appendCode(converted, intern(converted, column.exceptions.value(row)));
+        } else {
+            appendCode(converted, intern(converted, formatNumber(column, value)));
+        }
+    }
+
+    converted.maxLength = column.maxLength;
+    column = converted;
+    ++m_revision;
+}
+
+void ColumnTableStore::convertToText(Column &column)
+{
+    Column converted;
+    converted.type = TYPE_TEXT;
+    converted.texts.reserve(codeCount(column));
+
+    for (int row = 0; row < codeCount(column); ++row) {
+        converted.texts.append(column.dictionary.at(codeAt(column, row)));
+    }
+
+    converted.maxLength = column.maxLength;
+    column = converted;
+    ++m_revision;
+}
+
+quint32 ColumnTableStore::intern(Column &column, const QString &text)
+{
+    auto it = column.dictionaryIndex.constFind(text);
+    if (it != column.dictionaryIndex.constEnd()) {
+        return it.value();
+    }
+
+    quint32 code = static_cast<quint32>(column.dictionary.size());
+    column.dictionary.append(text);
+    column.dictionaryIndex.insert(text, code);
+    return code;
+}
+
+void ColumnTableStore::permuteColumn(Column &column, const QVector<int> &order, const QVector<int> &inverse)
+{
+    restoreColumn(column);
+    switch (column.type) {
+    case TYPE_EMPTY:
+        return;
+    case TYPE_DICTIONARY:
+        if (column.codeWidth == 1) {
+            column.codes8 = permuted(column.codes8, order);
+        } else if (column.codeWidth == 2) {
+            column.codes16 = permuted(column.codes16, order);
+        } else {
+            column.codes32 = permuted(column.codes32, order);
+        }
+        break;
+    case TYPE_TEXT:
+        column.texts = permuted(column.texts, order);
+        break;
+    default:
+        column.numbers = permuted(column.numbers, order);
+        break;
+    }
+
+    if (!column.exceptions.isEmpty()) {
+        QHash<int, QString> exceptions;
+        for (auto it = column.exceptions.constBegin(); it != column.exceptions.constEnd(); ++it) {
+            exceptions.insert(inverse.at(it.key()), it.value());
+        }
+        column.exceptions = exceptions;
+    }
+}
+
+void ColumnTableStore::compactColumn(Column &column, const QVector<int> &rows)
+{
+    restoreColumn(column);
+    switch (column.type) {
+    case TYPE_EMPTY:
+        return;
+    case TYPE_DICTIONARY:
+        if (column.codeWidth == 1) {
+            compacted(column.codes8, rows);
+        } else if (column.codeWidth == 2) {
+            compacted(column.codes16, rows);
+        } else {
+            compacted(column.codes32, rows);
+        }
+        break;
+    case TYPE_TEXT:
+        compacted(column.texts, rows);
+        break;
+    default:
+        compacted(column.numbers, rows);
+        break;
+    }
+
+    if (!column.exceptions.isEmpty()) {
+        QHash<int, QString> exceptions;
+        for (auto it = column.exceptions.constBegin(); it != column.exceptions.constEnd(); ++it) {
+            auto removed = std::lower_bound(rows.constBegin(), rows.constEnd(), it.key());
+            if (removed == rows.constEnd() || *removed != it.key()) {
+                exceptions.insert(it.key() - int(removed - rows.constBegin()), it.value());
+            }
+        }
+        column.exceptions = exceptions;
+    }
+}
+
+QSharedPointer<const ColumnTableStore::SpillBlock> ColumnTableStore::spillColumn(const Column &column, int rows)
+{
+    QSharedPointer<SpillBlock> block(new SpillBlock());
+    block->rows = rows;
+    block->file.setFileTemplate(QDir(QDir::tempPath()).filePath(SPILL_FILE_TEMPLATE));
+    if (!block->file.open()) {
+        qWarning() << "Failed to create table spill file:" << block->file.errorString();
+        return QSharedPointer<const SpillBlock>();
+    }
+
+    auto write = [&block](const void *data, qint64 size) {
+        return size == 0 || block->file.write(static_cast<const char *>(data), size) == size;
+    };
+
+    bool ok = true;
+    switch (column.type) {
+    case TYPE_DICTIONARY:
+        if (column.codeWidth == 1) {
+            ok = write(column.codes8.constData(), rows);
+        } else if (column.codeWidth == 2) {
+            ok = write(column.codes16.constData(), rows * qint64(sizeof(quint16)));
+        } else {
+            ok = write(column.codes32.constData(), rows * qint64(sizeof(quint32)));
+        }
+        break;
+    case TYPE_TEXT: {
+        QVector<qint64> offsets(rows + 1);
+        offsets[0] = 0;
+        for (int row = 0; row < rows; ++row) {
+            offsets[row + 1] = offsets.at(row) + column.texts.at(row).size();
+        }
+        ok = write(offsets.constData(), offsets.size() * qint64(sizeof(qint64)));
+        for (int row = 0; row < rows && ok; ++row) {
+            const QString &text = column.texts.at(row);
+            ok = write(text.constData(), text.size() * qint64(sizeof(QChar)));
+        }
+        break;
+    }
+    default:
+        ok = write(column.numbers.constData(), rows * qint64(sizeof(qint64)));
+        break;
+    }
+
+    // a text column of empty strings still has its offsets, the file is never empty
+    if (ok && block->file.flush()) {
+        block->data = block->file.map(0, block->file.size());
+    }
+    if (!block->data) {
+        qWarning() << "Failed to spill table column to" << block->file.fileName() << ":" << block->file.errorString();
+        return QSharedPointer<const SpillBlock>();
+    }
+    return block;
+}
+
+void ColumnTableStore::restoreColumn(Column &column)
+{
+    if (!column.spill) {
+        return;
+    }
+
+    const uchar *data = column.spill->data;
+    int rows = column.spill->rows;
+    switch (column.type) {
+    case TYPE_DICTIONARY:
+        if (column.codeWidth == 1) {
+            column.codes8.resize(rows);
+            std::copy(data, data + rows, column.codes8.begin());
+        } else if (column.codeWidth == 2) {
+            const quint16 *codes = reinterpret_cast<const quint16 *>(data);
+            column.codes16.resize(rows);
+            std::copy(codes, codes + rows, column.codes16.begin());
+        } else {
+            const quint32 *codes = reinterpret_cast<const quint32 *>(data);
+            column.codes32.resize(rows);
+            std::copy(codes, codes + rows, column.codes32.begin());
+        }
+        break;
+    case TYPE_TEXT: {
+        QVector<QString> texts(rows);
+        for (int row = 0; row < rows; ++row) {
+            texts[row] = textAt(column, row);
+        }
+        column.texts = texts;
+        break;
+    }
+    default: {
+        const qint64 *numbers = reinterpret_cast<const qint64 *>(data);
+        column.numbers.resize(rows);
+        std::copy(numbers, numbers + rows, column.numbers.begin());
+        break;
+    }
+    }
+    column.spill.reset();
+}
+
+const qint64 *ColumnTableStore::numberData(const Column &column)
+{
+    return column.spill ? reinterpret_cast<const qint64 *>(column.spill->data) : column.numbers.constData();
+}
+
+QString ColumnTableStore::textAt(const Column &column, int row)
+{
+    if (!column.spill) {
+        return column.texts.at(row);
+    }
+
+    const qint64 *offsets = reinterpret_cast<const qint64 *>(column.spill->data);
+    const QChar *text = reinterpret_cast<const QChar *>(offsets + column.spill->rows + 1);
+    return QString(text + offsets[row], static_cast<int>(offsets[row + 1] - offsets[row]));
+}
+
+int ColumnTableStore::codeCount(const Column &column)
+{
+    if (column.spill) {
+        return column.spill->rows;
+    }
+
+    switch (column.codeWidth) {
+    case 1:
+        return column.codes8.size();
+    case 2:
+        return column.codes16.size();
+    default:
+        return column.codes32.size();
+    }
+}
+
+quint32 ColumnTableStore::codeAt(const Column &column, int row)
+{
+    if (column.spill) {
+        const uchar *codes = column.spill->data;
+        switch (column.codeWidth) {
+        case 1:
+            return codes[row];
+        case 2:
+            return reinterpret_cast<const quint16 *>(codes)[row];
+        default:
+            return reinterpret_cast<const quint32 *>(codes)[row];
+        }
+    }
+
+    switch (column.codeWidth) {
+    case 1:
+        return column.codes8.at(row);
+    case 2:
+        return column.codes16.at(row);
+    default:
+        return column.codes32.at(row);
+    }
+}
+
+void ColumnTableStore::setCodeAt(Column &column, int row, quint32 code)
+{
+    if (code > 0xFFFF) {
+        widenCodes(column, 4);
+    } else if (code > 0xFF) {
+        widenCodes(column, 2);
+    }
+
+    switch (column.codeWidth) {
+    case 1:
+        column.codes8[row] = static_cast<quint8>(code);
+        break;
+    case 2:
+        column.codes16[row] = static_cast<quint16>(code);
+        break;
+    default:
+        column.codes32[row] = code;
+        break;
+    }
+}
+
+void ColumnTableStore::appendCode(Column &column, quint32 code)
+{
+    switch (column.codeWidth) {
+    case 1:
+        column.codes8.append(0);
+        break;
+    case 2:
+        column.codes16.append(0);
+        break;
+    default:
+        column.codes32.append(0);
+        break;
+    }
+    setCodeAt(column, codeCount(column) - 1, code);
+}
+
+void ColumnTableStore::widenCodes(Column &column, int width)
+{
+    if (width <= column.codeWidth) {
+        return;
+    }
+
+    QVector<quint32> codes;
+    codes.reserve(codeCount(column));
+    for (int row = 0; row < codeCount(column); ++row) {
+        codes.append(codeAt(column, row));
+    }
+
+    QVector<quint8>().swap(column.codes8);
+    QVector<quint16>().swap(column.codes16);
+
+    if (width == 2) {
+        column.codes16.reserve(codes.size());
+        for (quint32 code : codes) {
+            column.codes16.append(static_cast<quint16>(code));
+        }
+    } else {
+        column.codes32 = codes;
+    }
+    column.codeWidth = width;
+}
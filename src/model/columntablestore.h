@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef COLUMNTABLESTORE_H
+#define COLUMNTABLESTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+
+#include <limits>
+
+/**
+ * @brief Column oriented storage for the text tables shown by InfoWidgets
+ *
+ * Every column picks the narrowest type that reproduces its text exactly:
+ * integers and fixed point decimals such as pts_time are kept as int64,
+ * "true"/"false" as bool. Strings are dictionary encoded: each distinct value
+ * (codec_type, pict_type, pix_fmt, flags...) is stored once and the cells hold
+ * 8, 16 or 32 bit codes, widened as the dictionary grows. Columns with mostly
+ * unique strings fall back to plain text. Text is only rebuilt for the cells
+ * that are asked for.
+ *
+ * Empty and missing cells are the same null value. Reads are safe from
+ * several threads as long as nobody writes.
+ *
+ * Cold columns can be spilled to a memory mapped temp file. Their cells are
+ * read from the mapping, so the OS pages them in and out as needed; a write
+ * to a spilled column first restores it to the heap.
+ */
+class ColumnTableStore
+{
+public:
+    enum ColumnType {
+        TYPE_EMPTY = 0,     // no value seen yet
+        TYPE_INT64,
+        TYPE_DECIMAL,       // int64 mantissa with a fixed number of digits after the point
+        TYPE_BOOL,
+        TYPE_DICTIONARY,    // codes into a table of distinct strings
+        TYPE_TEXT           // high cardinality strings
+    };
+
+    ColumnTableStore();
+
+    int rowCount() const;
+    int columnCount() const;
+
+    void clear();
+    void setColumnCount(int count);
+
+    void appendRow(const QStringList &row);
+    void appendRows(const QList<QStringList> &rows);
+    void removeRows(int row, int count);
+    // Removes every listed row in one pass, rows must be ascending and unique
+    void removeRows(const QVector<int> &rows);
+
+    QString text(int row, int column) const;
+    QStringList rowData(int row) const;
+    QList<QStringList> rows() const;
+    void setText(int row, int column, const QString &text);
+
+    bool isNull(int row, int column) const;
+    ColumnType columnType(int column) const;
+
+    // Longest text stored in a column so far, removed rows do not shrink it
+    int maxTextLength(int column) const;
+
+    // Numeric value of a cell, false for null cells and non numeric columns
+    bool numberValue(int row, int column, double *value) const;
+
+    /**
+     * Raw cells of TYPE_INT64, TYPE_DECIMAL and TYPE_BOOL columns for batch
+     * evaluation, null for other types. Decimal cells are value * 10^decimals,
+     * bools 0 and 1. hasNumber() is false for null cells and for cells that
+     * did not fit the type.
+     */
+    const qint64 *numbers(int column) const;
+    int decimals(int column) const;
+    static bool hasNumber(qint64 raw) { return raw > std::numeric_limits<qint64>::min() + 1; }
+    // 10^decimals, the factor between a decimal value and its raw cell
+    static qint64 scale(int decimals);
+    /**
+     * Raw cell of a number literal at the given decimals, rounded down when the
+     * literal has more digits after the point. exact is false if a non zero digit
+     * was dropped. False for text that is not a number or does not fit a cell.
+     */
+    static bool scaleNumber(const QString &text, int decimals, qint64 *raw, bool *exact);
+
+    // Dictionary columns, code 0 is the null cell
+    bool isDictionary(int column) const;
+    quint32 code(int row, int column) const;
+    int dictionarySize(int column) const;
+    QString dictionaryValue(int column, quint32 code) const;
+    // Codes of count rows starting at first, whatever width the column uses
+    void codes(int column, int first, int count, quint32 *out) const;
+    // Position of every code in the sorted dictionary, compare ranks instead of strings
+    QVector<int> dictionaryRanks(int column) const;
+
+    /**
+     * Stable order of the rows by one column: numbers compare numerically, strings
+     * by text, null cells first. The first sortedCount rows must already be in that
+     * order, only the rows after them are sorted and then merged in.
+     * Runs on the global thread pool for long tables.
+     */
+    QVector<int> sortedRows(int column, Qt::SortOrder order, int sortedCount = 0) const;
+    // Row i takes the cells of row order[i], order must be a permutation of all rows
+    void permuteRows(const QVector<int> &order);
+
+    // Changes whenever existing codes may stand for other values, e.g. after clear()
+    quint64 revision() const;
+
+    // Approximate heap size of the stored cells, spilled cells do not count
+    qint64 memoryUsage() const;
+    qint64 memoryUsage(int column) const;
+
+    /**
+     * Copy of this store with the given columns written to memory mapped temp
+     * files, meant for a worker thread working on a snapshot. Columns whose
+     * file can not be written stay on the heap.
+     */
+    ColumnTableStore withSpilledColumns(const QList<int> &columns) const;
+    // Takes the spilled columns of a withSpilledColumns() copy, false if the cells changed since
+    bool adoptSpilledColumns(const ColumnTableStore &spilled);
+    bool isSpilled(int column) const;
+
+private:
+    // reads and rebuilds the columns of session snapshot files
+    friend class TableSnapshot;
+
+    struct SpillBlock;
+
+    struct Column {
+        ColumnType type = TYPE_EMPTY;
+        int decimals = 0;
+        QVector<qint64> numbers;            // TYPE_INT64, TYPE_DECIMAL, TYPE_BOOL
+        int codeWidth = 1;                  // TYPE_DICTIONARY, only one code vector is used
+        QVector<quint8> codes8;
+        QVector<quint16> codes16;
+        QVector<quint32> codes32;
+        QStringList dictionary;
+        QHash<QString, quint32> dictionaryIndex;
+        QHash<int, QString> exceptions;     // numeric column cells that do not fit the type
+        QVector<QString> texts;             // TYPE_TEXT
+        int maxLength = 0;                  // longest text ever stored
+        QSharedPointer<const SpillBlock> spill; // cells of a spilled column, the vectors above are then empty
+    };
+
+    static ColumnType detectType(const QString &text, int *decimals);
+    static bool encodeNumber(const Column &column, const QString &text, qint64 *value);
+    static QString formatNumber(const Column &column, qint64 value);
+
+    void setCell(Column &column, int row, const QString &text);
+    void appendCell(Column &column, const QString &text);
+    void initializeColumn(Column &column, const QString &text);
+    void convertToDictionary(Column &column);
+    void convertToText(Column &column);
+    quint32 intern(Column &column, const QString &text);
+
+    static void permuteColumn(Column &column, const QVector<int> &order, const QVector<int> &inverse);
+    static void compactColumn(Column &column, const QVector<int> &rows);
+
+    static QSharedPointer<const SpillBlock> spillColumn(const Column &column, int rows);
+    static void restoreColumn(Column &column);
+    static const qint64 *numberData(const Column &column);
+    static QString textAt(const Column &column, int row);
+
+    static int codeCount(const Column &column);
+    static quint32 codeAt(const Column &column, int row);
+    static void setCodeAt(Column &column, int row, quint32 code);
+    static void appendCode(Column &column, quint32 code);
+    static void widenCodes(Column &column, int width);
+
+private:
+    int m_rowCount;
+    quint64 m_revision;
+    quint64 m_version;                      // bumped by every write, spilled copies must match it
+    QVector<Column> m_columns;
+};
+
+#endif // COLUMNTABLESTORE_H
@@ -2,11 +2,29 @@
 // SPDX-License-Identifier: MIT
 
 #include "mediainfotabelmodel.h"
+#include "tablememorybudget.h"
+
+#include <QApplication>
+#include <QPointer>
+
+#include <algorithm>
+#include <numeric>
+
+#define REMOVE_MAX_RANGES 256   // separate row ranges removed with their own signals, more reset the model
 
 MediaInfoTabelModel::MediaInfoTabelModel(QObject *parent) : QAbstractTableModel(parent),
-    row(0), column(0), m_header(nullptr), m_data(nullptr)
+    row(0), column(0), m_header(nullptr)
 {
+    TableMemoryBudget::instance().addModel(this);
+}
 
+MediaInfoTabelModel::~MediaInfoTabelModel()
+{
+    TableMemoryBudget::instance().removeModel(this);
+    ZProbeScheduler::instance().cancel(this);
+    for (const Page &page : qAsConst(m_pages)) {
+        ZProbeScheduler::cancel(page.token);
+    }
 }
 
 int MediaInfoTabelModel::rowCount(const QModelIndex &parent) const
@@ -21,13 +39,34 @@ int MediaInfoTabelModel::columnCount(const QModelIndex &parent) const
 
 QVariant MediaInfoTabelModel::data(const QModelIndex &index, int role) const
 {
+    if(m_paged && (role == Qt::DisplayRole || role == Qt::EditRole))
+    {
+        if (!index.isValid() || index.row() >= row) {
+            return QVariant();
+        }
+
+        int page = pageOfRow(index.row());
+        if (page < 0) {
+            return QVariant();
+        }
+
+        const Page &entry = m_pages.at(page);
+        if (!entry.loaded) {
+            // scrolled straight into an evicted page
+            requestPage(page, ZProbeScheduler::PRIORITY_INTERACTIVE);
+            return QVariant();
+        }
+
+        return entry.rows.text(index.row() - entry.firstRow, index.column());
+    }
+
     if(role == Qt::DisplayRole || role == Qt::EditRole)
     {
-        if (!m_data || !index.isValid() || index.row() >= m_data->size() || 
-            index.column() >= m_data->at(index.row()).size()) {
+        if (!index.isValid() || index.row() >= m_store.rowCount()) {
             return QVariant();
         }
-        return (*m_data)[index.row()][index.column()];
+        // only the visible cells are turned back into text
+        return m_store.text(index.row(), index.column());
     }
 
     if(role == Qt::TextAlignmentRole)
@@ -46,8 +85,9 @@ QVariant MediaInfoTabelModel::data(const QModelIndex &index, int role) const
 QVariant MediaInfoTabelModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (role == Qt::DisplayRole && orientation == Qt::Horizontal) {
-        if(m_header && section >= 0 && section < m_header->count())
-            return m_header->at(section);
+        const QList<QString> *header = m_paged ? &m_pagedHeaders : m_header;
+        if(header && section >= 0 && section < header->count())
+            return header->at(section);
     }
 
     if (orientation == Qt::Vertical && role == Qt::DisplayRole) {
@@ -75,11 +115,12 @@ QVariant MediaInfoTabelModel::headerData(int section, Qt::Orientation orientatio
 bool MediaInfoTabelModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
     if (role == Qt::EditRole) {
-        if (!checkIndex(index) || !m_data)
+        if (!checkIndex(index) || m_paged)
             return false;
 
         //save value from editor to member m_gridData
-        (*m_data)[index.row()][index.column()] = value.toString();
+        m_store.setText(index.row(), index.column(), value.toString());
+        TableMemoryBudget::instance().touch(this);
         emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
         return true;
     }
@@ -88,6 +129,9 @@ bool MediaInfoTabelModel::setData(const QModelIndex &index, const QVariant &valu
 
 Qt::ItemFlags MediaInfoTabelModel::flags(const QModelIndex &index) const
 {
+    if (m_paged) {
+        return QAbstractTableModel::flags(index);
+    }
     return Qt::ItemIsEditable | QAbstractTableModel::flags(index);
 }
 
@@ -109,12 +153,548 @@ void MediaInfoTabelModel::setTableHeader(QList<QString> *header)
 }
 
 void MediaInfoTabelModel::setTableData(QList<QStringList> *data)
+{
+    setTableData(data ? *data : QList<QStringList>());
+}
+
+void MediaInfoTabelModel::setTableData(const QList<QStringList> &data)
+{
+    beginResetModel();
+    leavePagedMode();
+    m_store.clear();
+    m_store.setColumnCount(column);
+    m_store.appendRows(data);
+    row = m_store.rowCount();
+
+    m_loadOrder.resize(row);
+    std::iota(m_loadOrder.begin(), m_loadOrder.end(), 0);
+    m_nextLoadPosition = row;
+    if (m_sortColumn >= 0) {
+        permuteStoredRows(sortedOrder(0));
+    }
+    endResetModel();
+    TableMemoryBudget::instance().touch(this);
+}
+
+void MediaInfoTabelModel::setTableStore(const ColumnTableStore &store)
+{
+    beginResetModel();
+    leavePagedMode();
+    m_store = store;
+    if (m_store.columnCount() < column) {
+        m_store.setColumnCount(column);
+    }
+    row = m_store.rowCount();
+
+    m_loadOrder.resize(row);
+    std::iota(m_loadOrder.begin(), m_loadOrder.end(), 0);
+    m_nextLoadPosition = row;
+    if (m_sortColumn >= 0) {
+        permuteStoredRows(sortedOrder(0));
+    }
+    endResetModel();
+    TableMemoryBudget::instance().touch(this);
+}
+
+void MediaInfoTabelModel::appendTableData(const QList<QStringList> &rows)
+{
+    if (m_paged || rows.isEmpty())
+        return;
+
+    int sortedCount = row;
+    beginInsertRows(QModelIndex(), row, row + rows.size() - 1);
+    m_store.appendRows(rows);
+    row = m_store.rowCount();
+    while (m_loadOrder.size() < row) {
+        m_loadOrder.append(m_nextLoadPosition++);
+    }
+    endInsertRows();
+
+    // only the new rows are sorted, then merged into the sorted ones
+    if (m_sortColumn >= 0) {
+        applyRowOrder(sortedOrder(sortedCount));
+    }
+    TableMemoryBudget::instance().touch(this);
+}
+
+void MediaInfoTabelModel::appendTableHeader(const QStringList &headers)
+{
+    if (!m_header || headers.isEmpty())
+        return;
+
+    beginInsertColumns(QModelIndex(), column, column + headers.size() - 1);
+    m_header->append(headers);
+    column += headers.size();
+    endInsertColumns();
+}
+
+void MediaInfoTabelModel::setPagedSource(const QStringList &headers, int pageCount, const PageLoader &loader)
 {
     beginResetModel();
-    m_data = data;
+    leavePagedMode();
+
+    m_store.clear();
+    m_loadOrder.clear();
+    m_nextLoadPosition = 0;
+    m_paged = true;
+    m_pageLoader = loader;
+    m_pagedHeaders = headers;
+    m_pages.resize(qMax(0, pageCount));
+    row = 0;
+    column = m_pagedHeaders.size();
+
     endResetModel();
 }
 
+bool MediaInfoTabelModel::isPaged() const
+{
+    return m_paged;
+}
+
+QStringList MediaInfoTabelModel::pagedHeaders() const
+{
+    return m_pagedHeaders;
+}
+
+void MediaInfoTabelModel::setVisibleRows(int first, int last)
+{
+    if (!m_paged || m_knownPages == 0) {
+        return;
+    }
+
+    m_visibleFirst = qBound(0, first, qMax(0, row - 1));
+    m_visibleLast = qBound(m_visibleFirst, last, qMax(0, row - 1));
+
+    int firstPage = qMax(0, pageOfRow(m_visibleFirst));
+    int lastPage = qMax(firstPage, pageOfRow(m_visibleLast));
+
+    for (int page = firstPage; page <= lastPage; ++page) {
+        requestPage(page, ZProbeScheduler::PRIORITY_INTERACTIVE);
+    }
+
+    // prefetch one page each way so slow scrolling never hits an empty page
+    if (firstPage > 0) {
+        requestPage(firstPage - 1, ZProbeScheduler::PRIORITY_BACKGROUND);
+    }
+    if (lastPage + 1 < m_knownPages) {
+        requestPage(lastPage + 1, ZProbeScheduler::PRIORITY_BACKGROUND);
+    }
+
+    for (int page = 0; page < m_knownPages; ++page) {
+        if (page >= firstPage - PAGE_KEEP && page <= lastPage + PAGE_KEEP) {
+            continue;
+        }
+
+        Page &entry = m_pages[page];
+        if (entry.loading) {
+            ZProbeScheduler::cancel(entry.token);
+            entry.loading = false;
+        }
+        if (entry.loaded) {
+            entry.loaded = false;
+            entry.rows.clear();
+        }
+    }
+}
+
+QStringList MediaInfoTabelModel::rowData(int row) const
+{
+    if (!m_paged) {
+        return m_store.rowData(row);
+    }
+
+    int page = pageOfRow(row);
+    if (page < 0 || !m_pages.at(page).loaded) {
+        return QStringList();
+    }
+    return m_pages.at(page).rows.rowData(row - m_pages.at(page).firstRow);
+}
+
+bool MediaInfoTabelModel::ensureRowLoaded(int row) const
+{
+    if (row < 0 || row >= this->row) {
+        return false;
+    }
+    if (!m_paged) {
+        return true;
+    }
+
+    int page = pageOfRow(row);
+    if (page < 0) {
+        return false;
+    }
+    if (!m_pages.at(page).loaded) {
+        requestPage(page, ZProbeScheduler::PRIORITY_INTERACTIVE);
+        return false;
+    }
+    return true;
+}
+
+const ColumnTableStore &MediaInfoTabelModel::store() const
+{
+    return m_store;
+}
+
+bool MediaInfoTabelModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (m_paged || parent.isValid() || row < 0 || count <= 0 || row + count > m_store.rowCount()) {
+        return false;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row + count - 1);
+    m_store.removeRows(row, count);
+    m_loadOrder.remove(row, count);
+    this->row = m_store.rowCount();
+    endRemoveRows();
+    TableMemoryBudget::instance().touch(this);
+    return true;
+}
+
+bool MediaInfoTabelModel::removeRowList(const QVector<int> &rows)
+{
+    if (m_paged || rows.isEmpty()) {
+        return false;
+    }
+
+    QVector<int> sorted = rows;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (sorted.first() < 0 || sorted.last() >= m_store.rowCount()) {
+        return false;
+    }
+
+    // first row and count of every run of neighbouring rows
+    QVector<QPair<int, int>> ranges;
+    for (int row : qAsConst(sorted)) {
+        if (!ranges.isEmpty() && ranges.last().first + ranges.last().second == row) {
+            ++ranges.last().second;
+        } else {
+            ranges.append(qMakePair(row, 1));
+        }
+    }
+
+    if (ranges.size() == 1) {
+        return removeRows(ranges.first().first, ranges.first().second);
+    }
+
+    if (ranges.size() > REMOVE_MAX_RANGES) {
+        // each range costs the views and the proxy a pass over their rows, one compaction of the store instead
+        beginResetModel();
+        m_store.removeRows(sorted);
+        int write = sorted.first();
+        for (int read = sorted.first(), next = 0; read < m_loadOrder.size(); ++read) {
+            if (next < sorted.size() && sorted.at(next) == read) {
+                ++next;
+            } else {
+                m_loadOrder[write++] = m_loadOrder.at(read);
+            }
+        }
+        m_loadOrder.resize(write);
+        this->row = m_store.rowCount();
+        endResetModel();
+        TableMemoryBudget::instance().touch(this);
+        return true;
+    }
+
+    // from the bottom up, the rows of the ranges above keep their numbers and the cells
+    // always match the signal being delivered
+    for (int i = ranges.size() - 1; i >= 0; --i) {
+        const int first = ranges.at(i).first;
+        const int count = ranges.at(i).second;
+        beginRemoveRows(QModelIndex(), first, first + count - 1);
+        m_store.removeRows(first, count);
+        m_loadOrder.remove(first, count);
+        this->row = m_store.rowCount();
+        endRemoveRows();
+    }
+    TableMemoryBudget::instance().touch(this);
+    return true;
+}
+
+void MediaInfoTabelModel::sort(int column, Qt::SortOrder order)
+{
+    if (m_paged) {
+        return;
+    }
+
+    m_sortColumn = qMax(-1, column);
+    m_sortOrder = order;
+    applyRowOrder(sortedOrder(0));
+    TableMemoryBudget::instance().touch(this);
+}
+
+int MediaInfoTabelModel::sortColumn() const
+{
+    return m_sortColumn;
+}
+
+void MediaInfoTabelModel::spillColumns(const QList<int> &columns)
+{
+    if (m_paged || columns.isEmpty()) {
+        return;
+    }
+
+    // implicitly shared snapshot, the files are written without blocking the view
+    ColumnTableStore store = m_store;
+    QPointer<MediaInfoTabelModel> guard(this);
+    ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_BACKGROUND, [guard, store, columns]() {
+        ColumnTableStore spilled = store.withSpilledColumns(columns);
+        if (ZProbeScheduler::isCanceled()) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(qApp, [guard, spilled]() {
+            if (guard && !guard->m_paged && !guard->m_store.adoptSpilledColumns(spilled)) {
+                qDebug() << "Table changed while spilling, columns stay on the heap";
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+bool MediaInfoTabelModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!m_paged || parent.isValid() || m_knownPages >= m_pages.size()) {
+        return false;
+    }
+    return !m_pages.at(m_knownPages).loading;
+}
+
+void MediaInfoTabelModel::fetchMore(const QModelIndex &parent)
+{
+    if (canFetchMore(parent)) {
+        requestPage(m_knownPages, ZProbeScheduler::PRIORITY_INTERACTIVE);
+    }
+}
+
+int MediaInfoTabelModel::pageOfRow(int row) const
+{
+    if (row < 0 || row >= this->row || m_knownPages == 0) {
+        return -1;
+    }
+
+    // last known page starting at or before row, empty pages share the start of the next one
+    auto begin = m_pages.constBegin();
+    auto it = std::upper_bound(begin, begin + m_knownPages, row, [](int value, const Page &page) {
+        return value < page.firstRow;
+    });
+    if (it == begin) {
+        return -1;
+    }
+
+    int page = static_cast<int>(it - begin) - 1;
+    const Page &entry = m_pages.at(page);
+    return row < entry.firstRow + entry.rowCount ? page : -1;
+}
+
+void MediaInfoTabelModel::requestPage(int page, ZProbeScheduler::Priority priority) const
+{
+    if (page < 0 || page >= m_pages.size() || page > m_knownPages) {
+        return;
+    }
+
+    Page &entry = m_pages[page];
+    if (entry.loading || entry.loaded) {
+        return;
+    }
+    entry.loading = true;
+
+    QPointer<MediaInfoTabelModel> guard(const_cast<MediaInfoTabelModel *>(this));
+    PageLoader loader = m_pageLoader;
+    int generation = m_generation;
+
+    entry.token = ZProbeScheduler::instance().submit(nullptr, priority, [guard, loader, generation, page]() {
+        QStringList headers;
+        QList<QStringList> rows;
+        bool ok = loader(page, headers, rows);
+        if (ZProbeScheduler::isCanceled()) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(qApp, [guard, generation, page, ok, headers, rows]() {
+            if (guard) {
+                guard->onPageLoaded(generation, page, ok, headers, rows);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MediaInfoTabelModel::onPageLoaded(int generation, int page, bool ok, const QStringList &headers, const QList<QStringList> &rows)
+{
+    if (!m_paged || generation != m_generation || page >= m_pages.size()) {
+        return;
+    }
+
+    Page &entry = m_pages[page];
+    if (!entry.loading) {
+        // evicted while it was read
+        return;
+    }
+    entry.loading = false;
+    entry.token.reset();
+
+    if (!ok) {
+        // one failed probe must not leave a permanent hole, the page stays unloaded
+        qWarning() << "Failed to load table page" << page;
+        emit pageLoadFailed(page);
+        return;
+    }
+
+    // columns are matched by name, a later page may reveal new keys
+    QVector<int> columnMap(headers.size());
+    QStringList added;
+    for (int i = 0; i < headers.size(); ++i) {
+        int index = m_pagedHeaders.indexOf(headers.at(i));
+        if (index < 0) {
+            int addedIndex = added.indexOf(headers.at(i));
+            if (addedIndex < 0) {
+                addedIndex = added.size();
+                added.append(headers.at(i));
+            }
+            index = m_pagedHeaders.size() + addedIndex;
+        }
+        columnMap[i] = index;
+    }
+    if (!added.isEmpty()) {
+        beginInsertColumns(QModelIndex(), column, column + added.size() - 1);
+        m_pagedHeaders.append(added);
+        column = m_pagedHeaders.size();
+        endInsertColumns();
+    }
+
+    bool identity = true;
+    for (int i = 0; i < columnMap.size(); ++i) {
+        identity = identity && columnMap.at(i) == i;
+    }
+
+    QList<QStringList> mapped;
+    if (identity) {
+        mapped = rows;
+    } else {
+        mapped.reserve(rows.size());
+        for (const QStringList &line : rows) {
+            QStringList cells;
+            for (int i = 0; i < line.size() && i < columnMap.size(); ++i) {
+                while (cells.size() <= columnMap.at(i)) {
+                    cells.append(QString());
+                }
+                cells[columnMap.at(i)] = line.at(i);
+            }
+            mapped.append(cells);
+        }
+    }
+
+    if (page == m_knownPages) {
+        // next page of the fetchMore() chain
+        entry.firstRow = row;
+        entry.rowCount = mapped.size();
+        entry.rows.clear();
+        entry.rows.appendRows(mapped);
+        entry.loaded = true;
+        ++m_knownPages;
+
+        if (entry.rowCount > 0) {
+            beginInsertRows(QModelIndex(), row, row + entry.rowCount - 1);
+            row += entry.rowCount;
+            endInsertRows();
+        } else if (m_knownPages < m_pages.size()) {
+            // gaps in the file give empty pages, the view only asks again after new rows
+            fetchMore(QModelIndex());
+        }
+        return;
+    }
+
+    // reloaded page, keep the row count the view already knows
+    while (mapped.size() < entry.rowCount) {
+        mapped.append(QStringList());
+    }
+    entry.rows.clear();
+    entry.rows.appendRows(mapped.mid(0, entry.rowCount));
+    entry.loaded = true;
+
+    if (entry.rowCount > 0) {
+        emit dataChanged(index(entry.firstRow, 0), index(entry.firstRow + entry.rowCount - 1, column - 1),
+                         {Qt::DisplayRole, Qt::EditRole});
+    }
+}
+
+void MediaInfoTabelModel::leavePagedMode()
+{
+    for (const Page &page : qAsConst(m_pages)) {
+        ZProbeScheduler::cancel(page.token);
+    }
+
+    ++m_generation;
+    m_paged = false;
+    m_knownPages = 0;
+    m_visibleFirst = 0;
+    m_visibleLast = -1;
+    m_pagedHeaders.clear();
+    m_pageLoader = PageLoader();
+    m_pages.clear();
+}
+
+QVector<int> MediaInfoTabelModel::sortedOrder(int sortedCount) const
+{
+    if (m_sortColumn >= 0) {
+        return m_store.sortedRows(m_sortColumn, m_sortOrder, sortedCount);
+    }
+
+    QVector<int> order(m_store.rowCount());
+    std::iota(order.begin(), order.end(), 0);
+    if (m_loadOrder.size() == order.size() && !std::is_sorted(m_loadOrder.constBegin(), m_loadOrder.constEnd())) {
+        const int *position = m_loadOrder.constData();
+        std::sort(order.begin(), order.end(), [position](int left, int right) {
+            return position[left] < position[right];
+        });
+    }
+    return order;
+}
+
+void MediaInfoTabelModel::applyRowOrder(const QVector<int> &order)
+{
+    bool identity = true;
+    for (int i = 0; i < order.size() && identity; ++i) {
+        identity = order.at(i) == i;
+    }
+    if (identity || order.size() != m_store.rowCount()) {
+        return;
+    }
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+    QVector<int> inverse(order.size());
+    for (int i = 0; i < order.size(); ++i) {
+        inverse[order.at(i)] = i;
+    }
+
+    // selections and the current index follow their rows
+    QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &persistent : qAsConst(from)) {
+        to.append(index(inverse.at(persistent.row()), persistent.column()));
+    }
+
+    permuteStoredRows(order);
+    changePersistentIndexList(from, to);
+    emit rowsPermuted(order);
+
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+void MediaInfoTabelModel::permuteStoredRows(const QVector<int> &order)
+{
+    m_store.permuteRows(order);
+
+    if (m_loadOrder.size() == order.size()) {
+        QVector<int> loadOrder(order.size());
+        for (int i = 0; i < order.size(); ++i) {
+            loadOrder[i] = m_loadOrder.at(order.at(i));
+        }
+        m_loadOrder = loadOrder;
+    }
+}
+
 void MediaInfoTabelModel::SlotUpdateTable()
 {
     emit dataChanged(createIndex(0, 0), createIndex(row, column), {Qt::DisplayRole});
@@ -9,12 +9,23 @@
 #include <QColor>
 #include <QBrush>
 #include <QFont>
+#include <QVector>
+
+#include <functional>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+// Pages kept loaded on each side of the visible ones, the rest is evicted
+#define PAGE_KEEP 2
 
 class MediaInfoTabelModel: public QAbstractTableModel
 {
     Q_OBJECT
 public:
     MediaInfoTabelModel(QObject *parent = nullptr);
+    ~MediaInfoTabelModel();
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -33,19 +44,123 @@ public:
 
     void setTableHeader(QList<QString> *header);
 
+    // The rows are copied into a typed ColumnTableStore, the list is not kept
     void setTableData(QList<QStringList> *data);
+    void setTableData(const QList<QStringList> &data);
+    // Takes the cells of an already built store, e.g. a loaded session
+    void setTableStore(const ColumnTableStore &store);
+
+    // Append rows/columns without resetting the view
+    void appendTableData(const QList<QStringList> &rows);
+    void appendTableHeader(const QStringList &headers);
+
+    /**
+     * @brief Paged mode for tables too long to keep in memory
+     *
+     * The table is split into pages (e.g. time windows of a packet list). Pages are
+     * appended through canFetchMore()/fetchMore() as the view scrolls down, and only
+     * the pages around the visible rows keep their rows. Evicted pages keep their
+     * row count and are read again by the loader when they become visible.
+     * The loader runs on a ZProbeScheduler thread, setTableData() leaves paged mode.
+     */
+    using PageLoader = std::function<bool(int page, QStringList &headers, QList<QStringList> &rows)>;
+    void setPagedSource(const QStringList &headers, int pageCount, const PageLoader &loader);
+    bool isPaged() const;
+    QStringList pagedHeaders() const;
+
+    // Source rows shown by the view, loads the pages around them and evicts the others
+    void setVisibleRows(int first, int last);
+
+    // Row of either mode, empty for rows of an evicted page
+    QStringList rowData(int row) const;
+    // False for a row of a page that is not loaded, the page is then requested
+    bool ensureRowLoaded(int row) const;
+    const ColumnTableStore &store() const;
+
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    /**
+     * @brief Removes any set of rows with one pass over the store
+     *
+     * Neighbouring rows are merged into one range, the ranges are announced
+     * and compacted from the bottom up inside their own removal signals, so
+     * selection and scroll position survive. More than a few hundred ranges
+     * reset the model instead and compact the store in one pass.
+     */
+    bool removeRowList(const QVector<int> &rows);
+
+    /**
+     * @brief Reorders the stored rows by one column, column -1 restores the load order
+     *
+     * The permutation comes from ColumnTableStore::sortedRows(), so numeric columns
+     * sort by value and the view only sees one layout change. New and appended rows
+     * are kept in the same order. Does nothing in paged mode.
+     */
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    int sortColumn() const;
+
+    /**
+     * @brief Moves the cells of some columns to memory mapped temp files
+     *
+     * The files are written from a snapshot on a ZProbeScheduler thread and
+     * only taken if the rows did not change meanwhile. Called by
+     * TableMemoryBudget, every change of the rows reports to it.
+     */
+    void spillColumns(const QList<int> &columns);
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
 signals:
     void editCompleted(const QString &);
+    // Emitted by sort() between the layout signals, row i now holds the old row order[i]
+    void rowsPermuted(const QVector<int> &order);
+    // A page could not be read, it stays unloaded and is requested again when it is needed
+    void pageLoadFailed(int page);
 
 public slots:
     void SlotUpdateTable();
+private:
+    struct Page {
+        int firstRow = 0;
+        int rowCount = 0;
+        bool loading = false;
+        bool loaded = false;
+        ColumnTableStore rows;
+        ZProbeScheduler::CancelToken token;
+    };
+
+    int pageOfRow(int row) const;
+    void requestPage(int page, ZProbeScheduler::Priority priority) const;
+    void onPageLoaded(int generation, int page, bool ok, const QStringList &headers, const QList<QStringList> &rows);
+    void leavePagedMode();
+
+    QVector<int> sortedOrder(int sortedCount) const;
+    void applyRowOrder(const QVector<int> &order);
+    void permuteStoredRows(const QVector<int> &order);
+
 private:
     int row = 0;
     int column = 0;
 
     QList<QString> *m_header;
-    QList<QStringList> *m_data;
+    ColumnTableStore m_store;
+
+    // load position of every stored row, restores the order after a sort
+    QVector<int> m_loadOrder;
+    int m_nextLoadPosition = 0;
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+
+    // paged mode
+    bool m_paged = false;
+    int m_generation = 0;
+    int m_knownPages = 0;
+    int m_visibleFirst = 0;
+    int m_visibleLast = -1;
+    QStringList m_pagedHeaders;
+    PageLoader m_pageLoader;
+    mutable QVector<Page> m_pages;
 };
 
 #endif // MediaInfoTabelModel_H
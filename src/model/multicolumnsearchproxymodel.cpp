@@ -2,17 +2,103 @@
 // SPDX-License-Identifier: MIT
 
 #include "multicolumnsearchproxymodel.h"
+#include "mediainfotabelmodel.h"
+#include <QApplication>
+#include <QPointer>
 #include <QDebug>
 
+#include <common/common.h>
+
+#define INDEX_BUILD_DELAY 500       // ms without row changes before the search index is built
+
 MultiColumnSearchProxyModel::MultiColumnSearchProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent)
     , m_caseSensitive(false)
     , m_wholeWords(false)
     , m_useRegex(false)
+    , m_useExpression(false)
     , m_searchInSelectedColumns(false)
+    , m_hasResult(false)
+    , m_filterGeneration(0)
+    , m_filtering(false)
+    , m_changedFirst(0)
+    , m_changedEnd(0)
+    , m_indexGeneration(0)
+    , m_indexTimer(new QTimer(this))
 {
     // Default to case insensitive filtering
     setFilterCaseSensitivity(Qt::CaseInsensitive);
+
+    m_indexTimer->setSingleShot(true);
+    m_indexTimer->setInterval(INDEX_BUILD_DELAY);
+    connect(m_indexTimer, &QTimer::timeout, this, &MultiColumnSearchProxyModel::startIndexBuild);
+}
+
+MultiColumnSearchProxyModel::~MultiColumnSearchProxyModel()
+{
+    ZProbeScheduler::instance().cancel(this);
+    ZProbeScheduler::cancel(m_indexToken);
+}
+
+void MultiColumnSearchProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    for (const QMetaObject::Connection &connection : qAsConst(m_sourceConnections)) {
+        disconnect(connection);
+    }
+    m_sourceConnections.clear();
+
+    ZProbeScheduler::instance().cancel(this);
+    ++m_filterGeneration;
+    m_filtering = false;
+    m_hasResult = false;
+    m_acceptedRows.clear();
+    m_changedFirst = m_changedEnd = 0;
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    invalidateIndex();
+    if (!sourceModel) {
+        return;
+    }
+
+    // connected after the base class, the proxy has already updated its own mapping
+    m_sourceConnections << connect(sourceModel, &QAbstractItemModel::rowsInserted, this,
+                                   [this](const QModelIndex &parent, int first, int last) {
+        if (parent.isValid()) {
+            return;
+        }
+        // MediaInfoTabelModel only appends, the new rows are hidden until they are searched
+        if (m_hasResult) {
+            m_acceptedRows.resize(this->sourceModel()->rowCount());
+        }
+        invalidateIndex();
+        searchChangedRows(first, last + 1);
+    });
+    m_sourceConnections << connect(sourceModel, &QAbstractItemModel::rowsRemoved, this,
+                                   [this](const QModelIndex &parent, int first, int last) {
+        if (!parent.isValid()) {
+            invalidateIndex();
+            onSourceRowsRemoved(first, last);
+        }
+    });
+    m_sourceConnections << connect(sourceModel, &QAbstractItemModel::dataChanged, this,
+                                   [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        invalidateIndex();
+        searchChangedRows(topLeft.row(), bottomRight.row() + 1);
+    });
+    m_sourceConnections << connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+        m_hasResult = false;
+        m_acceptedRows.clear();
+    });
+    m_sourceConnections << connect(sourceModel, &QAbstractItemModel::modelReset, this, [this]() {
+        invalidateIndex();
+        startBackgroundFilter();
+    });
+
+    MediaInfoTabelModel *model = qobject_cast<MediaInfoTabelModel *>(sourceModel);
+    if (model) {
+        m_sourceConnections << connect(model, &MediaInfoTabelModel::rowsPermuted,
+                                       this, &MultiColumnSearchProxyModel::onSourceRowsPermuted);
+    }
 }
 
 void MultiColumnSearchProxyModel::setSearchText(const QString &text)
@@ -20,7 +106,7 @@ void MultiColumnSearchProxyModel::setSearchText(const QString &text)
     if (m_searchText != text) {
         m_searchText = text;
         updateRegularExpression();
-        invalidateFilter();
+        updateFilter();
     }
 }
 
@@ -44,7 +130,7 @@ void MultiColumnSearchProxyModel::setSearchColumns(const QStringList &columnName
         }
         
         qDebug() << "Search columns set:" << columnNames << "-> indices:" << m_searchColumnIndices;
-        invalidateFilter();
+        updateFilter();
     }
 }
 
@@ -65,7 +151,7 @@ void MultiColumnSearchProxyModel::setSearchColumns(const QList<int> &columnIndic
         }
         
         qDebug() << "Search column indices set:" << columnIndices << "-> names:" << m_searchColumnNames;
-        invalidateFilter();
+        updateFilter();
     }
 }
 
@@ -75,7 +161,7 @@ void MultiColumnSearchProxyModel::setCaseSensitive(bool caseSensitive)
         m_caseSensitive = caseSensitive;
         setFilterCaseSensitivity(caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
         updateRegularExpression();
-        invalidateFilter();
+        updateFilter();
     }
 }
 
@@ -84,7 +170,7 @@ void MultiColumnSearchProxyModel::setMatchWholeWords(bool wholeWords)
     if (m_wholeWords != wholeWords) {
         m_wholeWords = wholeWords;
         updateRegularExpression();
-        invalidateFilter();
+        updateFilter();
     }
 }
 
@@ -93,7 +179,16 @@ void MultiColumnSearchProxyModel::setUseRegularExpression(bool useRegex)
     if (m_useRegex != useRegex) {
         m_useRegex = useRegex;
         updateRegularExpression();
-        invalidateFilter();
+        updateFilter();
+    }
+}
+
+void MultiColumnSearchProxyModel::setUseFilterExpression(bool useExpression)
+{
+    if (m_useExpression != useExpression) {
+        m_useExpression = useExpression;
+        m_expressionError.clear();
+        updateFilter();
     }
 }
 
@@ -101,7 +196,7 @@ void MultiColumnSearchProxyModel::setSearchMode(bool searchInSelectedColumns)
 {
     if (m_searchInSelectedColumns != searchInSelectedColumns) {
         m_searchInSelectedColumns = searchInSelectedColumns;
-        invalidateFilter();
+        updateFilter();
     }
 }
 
@@ -113,11 +208,13 @@ void MultiColumnSearchProxyModel::resetFilters()
     m_caseSensitive = false;
     m_wholeWords = false;
     m_useRegex = false;
+    m_useExpression = false;
     m_searchInSelectedColumns = false;
+    m_expressionError.clear();
     
     setFilterCaseSensitivity(Qt::CaseInsensitive);
     updateRegularExpression();
-    invalidateFilter();
+    updateFilter();
 }
 
 bool MultiColumnSearchProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
@@ -131,6 +228,16 @@ bool MultiColumnSearchProxyModel::filterAcceptsRow(int source_row, const QModelI
     if (!sourceModel()) {
         return false;
     }
+
+    // Matched by the background search, the previous result stays until a new one is done
+    if (columnModel()) {
+        return !m_hasResult || (source_row < m_acceptedRows.size() && m_acceptedRows.testBit(source_row));
+    }
+
+    // expressions are evaluated on a column store only
+    if (m_useExpression) {
+        return true;
+    }
     
     // Determine which columns to search
     QList<int> columnsToSearch;
@@ -160,69 +267,342 @@ bool MultiColumnSearchProxyModel::filterAcceptsRow(int source_row, const QModelI
     return false; // No match found in any searched column
 }
 
-void MultiColumnSearchProxyModel::updateRegularExpression()
+void MultiColumnSearchProxyModel::sort(int column, Qt::SortOrder order)
 {
-    if (m_searchText.isEmpty()) {
-        m_regex = QRegularExpression();
+    MediaInfoTabelModel *model = qobject_cast<MediaInfoTabelModel *>(sourceModel());
+    if (!model || model->isPaged()) {
+        QSortFilterProxyModel::sort(column, order);
         return;
     }
-    
-    QString pattern = m_searchText;
-    
-    // Escape special regex characters if not using regex mode
-    if (!m_useRegex) {
-        pattern = escapeRegexSpecialChars(pattern);
+
+    // one typed permutation in the source instead of a lessThan() call per comparison
+    QSortFilterProxyModel::sort(-1, order);
+    model->sort(column, order);
+}
+
+bool MultiColumnSearchProxyModel::isFiltering() const
+{
+    return m_filtering;
+}
+
+QVector<int> MultiColumnSearchProxyModel::matchedRows() const
+{
+    QVector<int> rows;
+    for (int row = 0; row < m_acceptedRows.size(); ++row) {
+        if (m_acceptedRows.testBit(row)) {
+            rows.append(row);
+        }
     }
-    
-    // Add word boundaries for whole word matching
-    if (m_wholeWords) {
-        pattern = QString("\\b%1\\b").arg(pattern);
+    return rows;
+}
+
+bool MultiColumnSearchProxyModel::hasMatchedRows() const
+{
+    return m_hasResult;
+}
+
+MediaInfoTabelModel *MultiColumnSearchProxyModel::columnModel() const
+{
+    MediaInfoTabelModel *model = qobject_cast<MediaInfoTabelModel *>(sourceModel());
+    return model && !model->isPaged() ? model : nullptr;
+}
+
+void MultiColumnSearchProxyModel::updateFilter()
+{
+    if (columnModel() && !m_searchText.isEmpty()) {
+        startBackgroundFilter();
+        return;
     }
-    
-    // Set case sensitivity
-    QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
-    if (!m_caseSensitive) {
-        options |= QRegularExpression::CaseInsensitiveOption;
+
+    ZProbeScheduler::instance().cancel(this);
+    ++m_filterGeneration;
+    m_filtering = false;
+    m_hasResult = false;
+    m_acceptedRows.clear();
+    m_changedFirst = m_changedEnd = 0;
+    invalidateFilter();
+    scheduleIndexBuild();
+}
+
+bool MultiColumnSearchProxyModel::prepareEngine(TableFilterEngine *engine)
+{
+    MediaInfoTabelModel *model = columnModel();
+
+    *engine = m_engine;
+    if (m_searchInSelectedColumns && !m_searchColumnIndices.isEmpty()) {
+        engine->setColumns(m_searchColumnIndices);
     }
-    
-    // Note: OptimizeOnFirstUsageOption was removed in Qt6 as the regex engine is optimized by default
-    
-    m_regex.setPattern(pattern);
-    m_regex.setPatternOptions(options);
-    
-    if (!m_regex.isValid()) {
-        qWarning() << "Invalid regular expression:" << pattern << "Error:" << m_regex.errorString();
-        // Fallback to escaped pattern
-        m_regex.setPattern(escapeRegexSpecialChars(m_searchText));
-        m_regex.setPatternOptions(options);
+
+    if (m_useExpression) {
+        // parsed per search, the headers may have grown since the text was set
+        QStringList headers;
+        for (int col = 0; col < model->columnCount(); ++col) {
+            headers.append(model->headerData(col, Qt::Horizontal, Qt::DisplayRole).toString());
+        }
+
+        QSharedPointer<const TableFilterExpression> expression = TableFilterExpression::parse(m_searchText, headers, &m_expressionError);
+        if (!expression) {
+            qWarning() << "Invalid filter expression:" << m_searchText << "Error:" << m_expressionError;
+            return false;
+        }
+        engine->setExpression(expression);
     }
+    return true;
 }
 
-bool MultiColumnSearchProxyModel::matchesInColumn(const QString &text, int column) const
+void MultiColumnSearchProxyModel::startBackgroundFilter()
 {
-    Q_UNUSED(column) // Column-specific logic can be added here if needed
-    
-    if (m_searchText.isEmpty()) {
-        return true;
+    MediaInfoTabelModel *model = columnModel();
+    if (!model || m_searchText.isEmpty()) {
+        return;
     }
-    
-    if (m_useRegex || m_wholeWords) {
-        return m_regex.match(text).hasMatch();
+
+    int generation = ++m_filterGeneration;
+    m_filtering = true;
+    // the snapshot below holds every row changed so far
+    m_changedFirst = m_changedEnd = 0;
+    scheduleIndexBuild();
+
+    TableFilterEngine engine;
+    if (!prepareEngine(&engine)) {
+        onBackgroundFilterFinished(generation, QVector<int>());
+        return;
+    }
+
+    // implicitly shared snapshot, edits on the GUI thread detach from it
+    ColumnTableStore store = model->store();
+    QSharedPointer<const TrigramIndex> index = m_index;
+    QPointer<MultiColumnSearchProxyModel> guard(this);
+
+    // a newer search of the same proxy cancels this one
+    ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, engine, store, index, generation]() {
+        QVector<int> rows;
+        if (!engine.filter(store, &rows, ZProbeScheduler::currentToken(), index.data())) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(qApp, [guard, generation, rows]() {
+            if (guard) {
+                guard->onBackgroundFilterFinished(generation, rows);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MultiColumnSearchProxyModel::onBackgroundFilterFinished(int generation, const QVector<int> &rows)
+{
+    if (generation != m_filterGeneration || !sourceModel()) {
+        return;
+    }
+
+    int rowCount = sourceModel()->rowCount();
+    m_acceptedRows = QBitArray(rowCount);
+    for (int row : rows) {
+        if (row < rowCount) {
+            m_acceptedRows.setBit(row);
+        }
+    }
+    m_hasResult = true;
+    m_filtering = false;
+
+    invalidateFilter();
+    emit filterFinished(rows.size());
+
+    // rows appended or edited while the snapshot was searched
+    startRangeFilter();
+}
+
+void MultiColumnSearchProxyModel::searchChangedRows(int first, int end)
+{
+    if (!columnModel() || m_searchText.isEmpty() || first >= end) {
+        return;
+    }
+
+    if (m_changedFirst < m_changedEnd) {
+        m_changedFirst = qMin(m_changedFirst, first);
+        m_changedEnd = qMax(m_changedEnd, end);
     } else {
-        // Simple substring search
-        return text.contains(m_searchText, m_caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+        m_changedFirst = first;
+        m_changedEnd = end;
+    }
+
+    // a running search takes the rows once it is done
+    if (m_filtering) {
+        return;
+    }
+    if (m_hasResult) {
+        startRangeFilter();
+    } else {
+        startBackgroundFilter();
     }
 }
 
-QString MultiColumnSearchProxyModel::escapeRegexSpecialChars(const QString &text) const
+void MultiColumnSearchProxyModel::startRangeFilter()
 {
-    QString result = text;
-    
-    // Escape regex special characters
-    static const QString specialChars = "\\^$.*+?()[]{}|";
-    for (const QChar &ch : specialChars) {
-        result.replace(ch, QString("\\%1").arg(ch));
+    MediaInfoTabelModel *model = columnModel();
+    int first = m_changedFirst;
+    int end = model ? qMin(m_changedEnd, model->store().rowCount()) : 0;
+    m_changedFirst = m_changedEnd = 0;
+    if (!model || m_searchText.isEmpty() || first >= end) {
+        return;
     }
-    
-    return result;
+
+    int generation = ++m_filterGeneration;
+    m_filtering = true;
+
+    TableFilterEngine engine;
+    if (!prepareEngine(&engine)) {
+        onRangeFilterFinished(generation, first, end, QVector<int>());
+        return;
+    }
+
+    ColumnTableStore store = model->store();
+    QPointer<MultiColumnSearchProxyModel> guard(this);
+
+    ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, engine, store, first, end, generation]() {
+        QVector<int> rows;
+        if (!engine.filterRange(store, first, end, &rows, ZProbeScheduler::currentToken())) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(qApp, [guard, generation, first, end, rows]() {
+            if (guard) {
+                guard->onRangeFilterFinished(generation, first, end, rows);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MultiColumnSearchProxyModel::onRangeFilterFinished(int generation, int first, int end, const QVector<int> &rows)
+{
+    if (generation != m_filterGeneration || !sourceModel()) {
+        return;
+    }
+
+    // rows were only appended or edited meanwhile, removals and sorts start a full search
+    end = qMin(end, m_acceptedRows.size());
+    for (int row = first; row < end; ++row) {
+        m_acceptedRows.clearBit(row);
+    }
+    for (int row : rows) {
+        if (row < end) {
+            m_acceptedRows.setBit(row);
+        }
+    }
+    m_filtering = false;
+
+    invalidateFilter();
+    emit filterFinished(m_acceptedRows.count(true));
+
+    startRangeFilter();
+}
+
+void MultiColumnSearchProxyModel::onSourceRowsPermuted(const QVector<int> &order)
+{
+    invalidateIndex();
+
+    // emitted before layoutChanged(), the proxy rebuilds its mapping from the moved bits
+    if (m_hasResult && m_acceptedRows.size() == order.size()) {
+        QBitArray accepted(order.size());
+        for (int row = 0; row < order.size(); ++row) {
+            accepted.setBit(row, m_acceptedRows.testBit(order.at(row)));
+        }
+        m_acceptedRows = accepted;
+    }
+
+    // the running search and the changed rows use the old row order
+    if (m_filtering || m_changedFirst < m_changedEnd) {
+        startBackgroundFilter();
+    }
+}
+
+void MultiColumnSearchProxyModel::onSourceRowsRemoved(int first, int last)
+{
+    if (m_hasResult && first < m_acceptedRows.size()) {
+        int count = qMin(last, m_acceptedRows.size() - 1) - first + 1;
+        for (int row = first; row + count < m_acceptedRows.size(); ++row) {
+            m_acceptedRows.setBit(row, m_acceptedRows.testBit(row + count));
+        }
+        m_acceptedRows.resize(m_acceptedRows.size() - count);
+    }
+
+    if (m_filtering || m_changedFirst < m_changedEnd) {
+        startBackgroundFilter();
+    }
+}
+
+void MultiColumnSearchProxyModel::invalidateIndex()
+{
+    ZProbeScheduler::cancel(m_indexToken);
+    m_indexToken.reset();
+    m_index.reset();
+    ++m_indexGeneration;
+    m_indexTimer->stop();
+
+    scheduleIndexBuild();
+}
+
+void MultiColumnSearchProxyModel::scheduleIndexBuild()
+{
+    // built for the first search only, small tables are scanned fast enough, 0 turns the index off
+    MediaInfoTabelModel *model = columnModel();
+    int minRows = Common::instance()->getConfigValue(SEARCH_INDEX_MIN_ROWS_KEY, DEFAULT_SEARCH_INDEX_MIN_ROWS).toInt();
+    if (!model || m_searchText.isEmpty() || minRows <= 0 || model->store().rowCount() < minRows) {
+        m_indexTimer->stop();
+        return;
+    }
+
+    // restarted by every row change, the build waits until the rows settle
+    if (!m_index && !m_indexToken) {
+        m_indexTimer->start();
+    }
+}
+
+void MultiColumnSearchProxyModel::startIndexBuild()
+{
+    MediaInfoTabelModel *model = columnModel();
+    if (!model) {
+        return;
+    }
+
+    int generation = m_indexGeneration;
+    ColumnTableStore store = model->store();
+    QPointer<MultiColumnSearchProxyModel> guard(this);
+
+    // no owner, a search of this proxy must not supersede the build
+    m_indexToken = ZProbeScheduler::instance().submitTable(nullptr, ZProbeScheduler::PRIORITY_BACKGROUND, [guard, store, generation]() {
+        QSharedPointer<const TrigramIndex> index = TrigramIndex::build(store, ZProbeScheduler::currentToken());
+        if (!index) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(qApp, [guard, generation, index]() {
+            if (guard) {
+                guard->onIndexBuilt(generation, index);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MultiColumnSearchProxyModel::onIndexBuilt(int generation, const QSharedPointer<const TrigramIndex> &index)
+{
+    if (generation != m_indexGeneration) {
+        return;
+    }
+
+    m_index = index;
+    m_indexToken.reset();
+    qDebug() << "Search index built for" << index->rowCount() << "rows," << index->memoryUsage() / 1024 << "KB";
+}
+
+void MultiColumnSearchProxyModel::updateRegularExpression()
+{
+    m_engine.setSearch(m_searchText, m_caseSensitive, m_wholeWords, m_useRegex);
+}
+
+bool MultiColumnSearchProxyModel::matchesInColumn(const QString &text, int column) const
+{
+    Q_UNUSED(column) // Column-specific logic can be added here if needed
+
+    return m_engine.matches(text);
 }
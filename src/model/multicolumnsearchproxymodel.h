@@ -6,29 +6,57 @@
 
 #include <QSortFilterProxyModel>
 #include <QStringList>
-#include <QRegularExpression>
+#include <QBitArray>
+#include <QVector>
+#include <QMetaObject>
+#include <QSharedPointer>
+#include <QTimer>
 
+#include "tablefilterengine.h"
+
+class MediaInfoTabelModel;
+
+/**
+ * @brief Search proxy of the info tables
+ *
+ * With a MediaInfoTabelModel source the rows are matched by a TableFilterEngine
+ * job on ZProbeScheduler that scans a snapshot of the column store in parallel
+ * chunks, a newer search cancels the running one. Until the job is done the view
+ * keeps the previous result and filterAcceptsRow() only looks up matched rows.
+ * Appended and edited rows are searched on their own and merged into the result.
+ * Searches of tables with many rows also get a TrigramIndex, built in the
+ * background once the rows stop changing, that narrows literal searches to
+ * candidate rows. Other source models are filtered row by row.
+ */
 class MultiColumnSearchProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
 
 public:
     explicit MultiColumnSearchProxyModel(QObject *parent = nullptr);
+    ~MultiColumnSearchProxyModel();
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
 
     // Search configuration
     void setSearchText(const QString &text);
     void setSearchColumns(const QStringList &columnNames);
     void setSearchColumns(const QList<int> &columnIndices);
-    
+
     // Match control options
     void setCaseSensitive(bool caseSensitive);
     void setMatchWholeWords(bool wholeWords);
     void setUseRegularExpression(bool useRegex);
-    
+    // The search text is a TableFilterExpression such as "pkt_size > 200000 && flags contains K"
+    void setUseFilterExpression(bool useExpression);
+
     // Filter configuration
     void setSearchMode(bool searchInSelectedColumns);
     void resetFilters();
 
+    // A MediaInfoTabelModel sorts its own rows, the proxy then keeps the source order
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
     // Getters
     QString getSearchText() const { return m_searchText; }
     QStringList getSearchColumns() const { return m_searchColumnNames; }
@@ -36,29 +64,80 @@ public:
     bool isCaseSensitive() const { return m_caseSensitive; }
     bool isMatchWholeWords() const { return m_wholeWords; }
     bool isUseRegularExpression() const { return m_useRegex; }
+    bool isUseFilterExpression() const { return m_useExpression; }
+    // Why the last search text is not a valid expression, empty if it is
+    QString getExpressionError() const { return m_expressionError; }
     bool isSearchInSelectedColumns() const { return m_searchInSelectedColumns; }
 
+    // Background search of the current settings still running
+    bool isFiltering() const;
+    // Source rows matched by the last finished background search
+    QVector<int> matchedRows() const;
+    // false while every row passes, matchedRows() is then empty
+    bool hasMatchedRows() const;
+
+signals:
+    void filterFinished(int matchedRows);
+
 protected:
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
 
 private:
     void updateRegularExpression();
+    void updateFilter();
     bool matchesInColumn(const QString &text, int column) const;
-    QString escapeRegexSpecialChars(const QString &text) const;
+
+    // Non paged MediaInfoTabelModel source, filtered in the background
+    MediaInfoTabelModel *columnModel() const;
+    // Engine of the current settings, false if the search text is not a valid expression
+    bool prepareEngine(TableFilterEngine *engine);
+    void startBackgroundFilter();
+    void onBackgroundFilterFinished(int generation, const QVector<int> &rows);
+    // Searches the rows first <= row < end again once no search is running
+    void searchChangedRows(int first, int end);
+    void startRangeFilter();
+    void onRangeFilterFinished(int generation, int first, int end, const QVector<int> &rows);
+    void onSourceRowsPermuted(const QVector<int> &order);
+    void onSourceRowsRemoved(int first, int last);
+
+    // Drops the index of the old rows and schedules a new one
+    void invalidateIndex();
+    // Only searched tables with enough rows get an index
+    void scheduleIndexBuild();
+    void startIndexBuild();
+    void onIndexBuilt(int generation, const QSharedPointer<const TrigramIndex> &index);
 
 private:
     QString m_searchText;
     QStringList m_searchColumnNames;
     QList<int> m_searchColumnIndices;
-    
+
     // Match control options
     bool m_caseSensitive;
     bool m_wholeWords;
     bool m_useRegex;
+    bool m_useExpression;
     bool m_searchInSelectedColumns;
-    
-    // Compiled regular expression for performance
-    QRegularExpression m_regex;
+    QString m_expressionError;
+
+    // Compiled search, copied into the background jobs
+    TableFilterEngine m_engine;
+
+    // Last background result, one bit per source row. Every row passes before the first one.
+    QBitArray m_acceptedRows;
+    bool m_hasResult;
+    int m_filterGeneration;
+    bool m_filtering;
+    // Rows changed since the running search started, first == end when there are none
+    int m_changedFirst;
+    int m_changedEnd;
+    QList<QMetaObject::Connection> m_sourceConnections;
+
+    // Trigram index of the current source rows, null while it is (re)built
+    QSharedPointer<const TrigramIndex> m_index;
+    ZProbeScheduler::CancelToken m_indexToken;
+    int m_indexGeneration;
+    QTimer *m_indexTimer;
 };
 
 #endif // MULTICOLUMNSEARCHPROXYMODEL_H
@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "rawtextmodel.h"
+
+RawTextModel::RawTextModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+RawTextModel::~RawTextModel()
+{
+    for (const QMetaObject::Connection &connection : qAsConst(m_sourceConnections)) {
+        disconnect(connection);
+    }
+}
+
+void RawTextModel::setSourceModel(MediaInfoTabelModel *model)
+{
+    beginResetModel();
+
+    for (const QMetaObject::Connection &connection : qAsConst(m_sourceConnections)) {
+        disconnect(connection);
+    }
+    m_sourceConnections.clear();
+    m_model = model;
+
+    if (model) {
+        // source row r is line r + 1, line 0 is the header
+        m_sourceConnections << connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this,
+                                       [this](const QModelIndex &, int first, int last) {
+                                           beginInsertRows(QModelIndex(), first + 1, last + 1);
+                                       });
+        m_sourceConnections << connect(model, &QAbstractItemModel::rowsInserted, this, [this]() {
+            endInsertRows();
+        });
+        m_sourceConnections << connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+                                       [this](const QModelIndex &, int first, int last) {
+                                           beginRemoveRows(QModelIndex(), first + 1, last + 1);
+                                       });
+        m_sourceConnections << connect(model, &QAbstractItemModel::rowsRemoved, this, [this]() {
+            endRemoveRows();
+        });
+        m_sourceConnections << connect(model, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+            beginResetModel();
+        });
+        m_sourceConnections << connect(model, &QAbstractItemModel::modelReset, this, [this]() {
+            endResetModel();
+        });
+        m_sourceConnections << connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, [this]() {
+            emit layoutAboutToBeChanged();
+        });
+        m_sourceConnections << connect(model, &QAbstractItemModel::layoutChanged, this, [this]() {
+            emit layoutChanged();
+        });
+        // sent between the layout signals of a sort
+        m_sourceConnections << connect(model, &MediaInfoTabelModel::rowsPermuted, this, &RawTextModel::onSourceRowsPermuted);
+        m_sourceConnections << connect(model, &QAbstractItemModel::dataChanged, this, &RawTextModel::onSourceDataChanged);
+        m_sourceConnections << connect(model, &QAbstractItemModel::columnsInserted, this, &RawTextModel::onSourceColumnsChanged);
+        m_sourceConnections << connect(model, &QAbstractItemModel::columnsRemoved, this, &RawTextModel::onSourceColumnsChanged);
+        m_sourceConnections << connect(model, &QAbstractItemModel::headerDataChanged, this, &RawTextModel::onSourceColumnsChanged);
+    }
+
+    endResetModel();
+}
+
+MediaInfoTabelModel *RawTextModel::sourceModel() const
+{
+    return m_model;
+}
+
+void RawTextModel::setSeparator(const QString &separator)
+{
+    if (m_separator == separator) {
+        return;
+    }
+
+    m_separator = separator;
+    if (rowCount() > 0) {
+        emit dataChanged(index(0), index(rowCount() - 1), {Qt::DisplayRole});
+    }
+}
+
+QString RawTextModel::separator() const
+{
+    return m_separator;
+}
+
+int RawTextModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !m_model) {
+        return 0;
+    }
+    return m_model->rowCount() + 1;
+}
+
+QVariant RawTextModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole) {
+        return lineText(index.row());
+    }
+
+    return QVariant();
+}
+
+QString RawTextModel::lineText(int line) const
+{
+    if (!m_model || line < 0 || line >= rowCount()) {
+        return QString();
+    }
+
+    if (line == 0) {
+        QStringList headers;
+        for (int col = 0; col < m_model->columnCount(); ++col) {
+            headers.append(m_model->headerData(col, Qt::Horizontal, Qt::DisplayRole).toString());
+        }
+        return headers.join(m_separator);
+    }
+
+    // a paged model reports the loaded page with dataChanged, the line is then painted again
+    if (!m_model->ensureRowLoaded(line - 1)) {
+        return QString();
+    }
+    return m_model->rowData(line - 1).join(m_separator);
+}
+
+void RawTextModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    int last = qMin(bottomRight.row() + 1, rowCount() - 1);
+    if (topLeft.row() + 1 <= last) {
+        emit dataChanged(index(topLeft.row() + 1), index(last), {Qt::DisplayRole});
+    }
+}
+
+void RawTextModel::onSourceColumnsChanged()
+{
+    // every line gets or loses cells, the view only rebuilds the visible ones
+    if (rowCount() > 0) {
+        emit dataChanged(index(0), index(rowCount() - 1), {Qt::DisplayRole});
+    }
+}
+
+void RawTextModel::onSourceRowsPermuted(const QVector<int> &order)
+{
+    QModelIndexList from = persistentIndexList();
+    if (from.isEmpty()) {
+        return;
+    }
+
+    // line r + 1 moves with source row r, the header line stays
+    QVector<int> inverse(order.size());
+    for (int i = 0; i < order.size(); ++i) {
+        inverse[order.at(i)] = i;
+    }
+
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &persistent : qAsConst(from)) {
+        int line = persistent.row();
+        if (line > 0 && line - 1 < inverse.size()) {
+            line = inverse.at(line - 1) + 1;
+        }
+        to.append(index(line, persistent.column()));
+    }
+    changePersistentIndexList(from, to);
+}
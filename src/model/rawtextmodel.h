@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef RAWTEXTMODEL_H
+#define RAWTEXTMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QList>
+#include <QMetaObject>
+
+#include "mediainfotabelmodel.h"
+
+/**
+ * @brief Raw text lines of a MediaInfoTabelModel
+ *
+ * Line 0 is the header, every following line one row of the table joined
+ * with the separator of its format. Lines are only built when a view asks
+ * for them, nothing is copied, so a QListView on top only renders the
+ * visible lines of any table size.
+ */
+class RawTextModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit RawTextModel(QObject *parent = nullptr);
+    ~RawTextModel();
+
+    void setSourceModel(MediaInfoTabelModel *model);
+    MediaInfoTabelModel *sourceModel() const;
+
+    void setSeparator(const QString &separator);
+    QString separator() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Text of one line, the header for line 0. Empty while the page of a paged model loads
+    QString lineText(int line) const;
+
+private:
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onSourceColumnsChanged();
+    void onSourceRowsPermuted(const QVector<int> &order);
+
+private:
+    QPointer<MediaInfoTabelModel> m_model;
+    QString m_separator;
+    QList<QMetaObject::Connection> m_sourceConnections;
+};
+
+#endif // RAWTEXTMODEL_H
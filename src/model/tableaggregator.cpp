@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tableaggregator.h"
+
+#include <QHash>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#define AGGREGATION_FLAT_GROUPS (1 << 20)   // group combinations looked up in a flat table instead of a hash
+
+TableAggregator::TableAggregator()
+    : m_histogramBins(0)
+{
+}
+
+void TableAggregator::setGroupColumns(const QList<int> &columns)
+{
+    m_groupColumns = columns;
+}
+
+void TableAggregator::setValueColumns(const QList<int> &columns)
+{
+    m_valueColumns = columns;
+}
+
+void TableAggregator::setPercentiles(const QVector<double> &percentiles)
+{
+    m_percentiles.clear();
+    for (double percentile : percentiles) {
+        m_percentiles.append(qBound(0.0, percentile, 100.0));
+    }
+}
+
+void TableAggregator::setHistogramBins(int bins)
+{
+    m_histogramBins = qMax(0, bins);
+}
+
+QList<int> TableAggregator::groupColumns() const
+{
+    return m_groupColumns;
+}
+
+QList<int> TableAggregator::valueColumns() const
+{
+    return m_valueColumns;
+}
+
+QVector<double> TableAggregator::percentiles() const
+{
+    return m_percentiles;
+}
+
+int TableAggregator::histogramBins() const
+{
+    return m_histogramBins;
+}
+
+bool TableAggregator::aggregate(const ColumnTableStore &store, const QVector<int> &rows, QVector<Group> *groups,
+                                const ZProbeScheduler::CancelToken &token) const
+{
+    groups->clear();
+
+    QList<int> groupColumns;
+    for (int col : m_groupColumns) {
+        if (col >= 0 && col < store.columnCount()) {
+            groupColumns.append(col);
+        }
+    }
+    QList<int> valueColumns;
+    for (int col : m_valueColumns) {
+        if (col >= 0 && col < store.columnCount()) {
+            valueColumns.append(col);
+        }
+    }
+
+    int rowCount = rows.size();
+    if (rowCount == 0) {
+        return true;
+    }
+
+    // group ids of every group column on its own, one column per pool task
+    QVector<QVector<quint32>> columnIds(groupColumns.size());
+    QVector<QStringList> columnKeys(groupColumns.size());
+    QVector<quint32> *ids = columnIds.data();
+    QStringList *keys = columnKeys.data();
+
+    QVector<int> columnTasks(groupColumns.size());
+    std::iota(columnTasks.begin(), columnTasks.end(), 0);
+    QtConcurrent::blockingMap(columnTasks, [&](int task) {
+        ids[task] = columnGroupIds(store, groupColumns.at(task), rows, &keys[task]);
+    });
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    // combine the columns one by one into dense group numbers, in order of appearance
+    QVector<quint32> groupIds(rowCount, 0);
+    QVector<QVector<quint32>> members(1);   // key of every group column for each group
+    for (int c = 0; c < groupColumns.size(); ++c) {
+        const quint32 *columnId = columnIds.at(c).constData();
+        QVector<QVector<quint32>> next;
+
+        auto addGroup = [&](int i) {
+            QVector<quint32> member = members.at(groupIds.at(i));
+            member.append(columnId[i]);
+            next.append(member);
+            return static_cast<quint32>(next.size() - 1);
+        };
+
+        quint64 combinations = quint64(members.size()) * quint64(columnKeys.at(c).size());
+        if (combinations <= AGGREGATION_FLAT_GROUPS) {
+            QVector<qint32> table(static_cast<int>(combinations), -1);
+            for (int i = 0; i < rowCount; ++i) {
+                qint32 &slot = table[static_cast<int>(groupIds.at(i) * columnKeys.at(c).size() + columnId[i])];
+                if (slot < 0) {
+                    slot = static_cast<qint32>(addGroup(i));
+                }
+                groupIds[i] = static_cast<quint32>(slot);
+            }
+        } else {
+            QHash<quint64, quint32> table;
+            for (int i = 0; i < rowCount; ++i) {
+                quint64 key = (quint64(groupIds.at(i)) << 32) | columnId[i];
+                auto it = table.constFind(key);
+                if (it == table.constEnd()) {
+                    it = table.insert(key, addGroup(i));
+                }
+                groupIds[i] = it.value();
+            }
+        }
+        members.swap(next);
+    }
+
+    // rows of each group next to each other
+    int groupCount = members.size();
+    QVector<int> offsets(groupCount + 1, 0);
+    for (quint32 id : qAsConst(groupIds)) {
+        ++offsets[static_cast<int>(id) + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    QVector<int> groupedRows(rowCount);
+    QVector<int> positions = offsets;
+    for (int i = 0; i < rowCount; ++i) {
+        groupedRows[positions[static_cast<int>(groupIds.at(i))]++] = rows.at(i);
+    }
+
+    groups->resize(groupCount);
+    Group *result = groups->data();
+    for (int g = 0; g < groupCount; ++g) {
+        Group &group = result[g];
+        for (int c = 0; c < groupColumns.size(); ++c) {
+            group.keys.append(columnKeys.at(c).at(static_cast<int>(members.at(g).at(c))));
+        }
+        group.rowCount = offsets.at(g + 1) - offsets.at(g);
+        group.columns.resize(valueColumns.size());
+    }
+
+    // one pool task per group and value column
+    int valueCount = valueColumns.size();
+    QVector<int> statsTasks(groupCount * valueCount);
+    std::iota(statsTasks.begin(), statsTasks.end(), 0);
+    QtConcurrent::blockingMap(statsTasks, [&](int task) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+        int g = task / valueCount;
+        int v = task % valueCount;
+        columnStats(store, valueColumns.at(v), groupedRows.constData() + offsets.at(g),
+                    offsets.at(g + 1) - offsets.at(g), &result[g].columns[v]);
+    });
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        groups->clear();
+        return false;
+    }
+    return true;
+}
+
+QVector<quint32> TableAggregator::columnGroupIds(const ColumnTableStore &store, int column, const QVector<int> &rows,
+                                                 QStringList *keys)
+{
+    QVector<quint32> ids(rows.size());
+
+    if (store.isDictionary(column)) {
+        // the codes already number the values, unused ones never get a group
+        for (int i = 0; i < rows.size(); ++i) {
+            ids[i] = store.code(rows.at(i), column);
+        }
+        for (int code = 0; code < store.dictionarySize(column); ++code) {
+            keys->append(store.dictionaryValue(column, static_cast<quint32>(code)));
+        }
+        return ids;
+    }
+
+    // numbers are grouped by their raw value, text is only built for new values
+    const qint64 *numbers = store.numbers(column);
+    QHash<qint64, quint32> numberIds;
+    QHash<QString, quint32> textIds;
+    for (int i = 0; i < rows.size(); ++i) {
+        int row = rows.at(i);
+        if (numbers && ColumnTableStore::hasNumber(numbers[row])) {
+            auto it = numberIds.constFind(numbers[row]);
+            if (it == numberIds.constEnd()) {
+                it = numberIds.insert(numbers[row], static_cast<quint32>(keys->size()));
+                keys->append(store.text(row, column));
+            }
+            ids[i] = it.value();
+        } else {
+            QString text = store.text(row, column);
+            auto it = textIds.constFind(text);
+            if (it == textIds.constEnd()) {
+                it = textIds.insert(text, static_cast<quint32>(keys->size()));
+                keys->append(text);
+            }
+            ids[i] = it.value();
+        }
+    }
+    return ids;
+}
+
+void TableAggregator::columnStats(const ColumnTableStore &store, int column, const int *rows, int count,
+                                  ColumnStats *stats) const
+{
+    stats->column = column;
+
+    const qint64 *numbers = store.numbers(column);
+    bool dictionary = store.isDictionary(column);
+
+    double scale = static_cast<double>(ColumnTableStore::scale(store.decimals(column)));
+
+    QVector<double> values;
+    if (numbers) {
+        values.reserve(count);
+    }
+    for (int i = 0; i < count; ++i) {
+        int row = rows[i];
+        if (numbers && ColumnTableStore::hasNumber(numbers[row])) {
+            values.append(static_cast<double>(numbers[row]) / scale);
+        } else if (dictionary ? store.code(row, column) != 0 : !store.isNull(row, column)) {
+            ++stats->count;
+        }
+    }
+
+    stats->count += values.size();
+    stats->numberCount = values.size();
+    if (values.isEmpty()) {
+        return;
+    }
+
+    // sorted once for min, max and every percentile
+    std::sort(values.begin(), values.end());
+    stats->min = values.first();
+    stats->max = values.last();
+    stats->sum = std::accumulate(values.constBegin(), values.constEnd(), 0.0);
+    stats->mean = stats->sum / values.size();
+
+    for (double percentile : m_percentiles) {
+        // linear interpolation between the closest ranks
+        double position = percentile / 100.0 * (values.size() - 1);
+        int lower = static_cast<int>(std::floor(position));
+        int upper = qMin(lower + 1, values.size() - 1);
+        stats->percentiles.append(values.at(lower) + (values.at(upper) - values.at(lower)) * (position - lower));
+    }
+
+    if (m_histogramBins > 0) {
+        stats->histogram.fill(0, m_histogramBins);
+        double width = (stats->max - stats->min) / m_histogramBins;
+        for (double value : qAsConst(values)) {
+            int bin = width > 0 ? static_cast<int>((value - stats->min) / width) : 0;
+            ++stats->histogram[qMin(bin, m_histogramBins - 1)];
+        }
+    }
+}
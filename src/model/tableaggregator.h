@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLEAGGREGATOR_H
+#define TABLEAGGREGATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+/**
+ * @brief Group-by statistics over the rows of a ColumnTableStore
+ *
+ * Rows are grouped by the distinct values of the group columns, e.g.
+ * stream_index x pict_type, and every value column gets count, sum, min, max,
+ * mean, percentiles and a histogram per group. Group keys come from dictionary
+ * codes and raw numbers, cells are only turned into text once per distinct
+ * value. The statistics of every group and value column are computed in
+ * parallel on the global thread pool.
+ */
+class TableAggregator
+{
+public:
+    struct ColumnStats {
+        int column = -1;
+        qint64 count = 0;           // non null cells
+        qint64 numberCount = 0;     // cells with a number, the statistics below only use these
+        double sum = 0;
+        double min = 0;
+        double max = 0;
+        double mean = 0;
+        QVector<double> percentiles;    // same order as the requested percentiles
+        QVector<qint64> histogram;      // equal width bins from min to max
+    };
+
+    struct Group {
+        QStringList keys;           // one value per group column
+        qint64 rowCount = 0;
+        QVector<ColumnStats> columns;   // same order as the value columns
+    };
+
+    TableAggregator();
+
+    void setGroupColumns(const QList<int> &columns);
+    void setValueColumns(const QList<int> &columns);
+    // Percentiles between 0 and 100
+    void setPercentiles(const QVector<double> &percentiles);
+    // 0 skips the histograms
+    void setHistogramBins(int bins);
+
+    QList<int> groupColumns() const;
+    QList<int> valueColumns() const;
+    QVector<double> percentiles() const;
+    int histogramBins() const;
+
+    /**
+     * @brief Statistics of the given rows
+     * @param rows Store rows to aggregate, e.g. the rows matched by the current search
+     * @param groups In order of the first row of each group
+     * @param token Checked between tasks, the aggregation stops once it is canceled
+     * @return false if the aggregation was canceled
+     */
+    bool aggregate(const ColumnTableStore &store, const QVector<int> &rows, QVector<Group> *groups,
+                   const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken()) const;
+
+private:
+    static QVector<quint32> columnGroupIds(const ColumnTableStore &store, int column, const QVector<int> &rows,
+                                           QStringList *keys);
+    void columnStats(const ColumnTableStore &store, int column, const int *rows, int count, ColumnStats *stats) const;
+
+private:
+    QList<int> m_groupColumns;
+    QList<int> m_valueColumns;
+    QVector<double> m_percentiles;
+    int m_histogramBins;
+};
+
+#endif // TABLEAGGREGATOR_H
@@ -0,0 +1,446 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tablediff.h"
+
+#include <QHash>
+#include <QMap>
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#define DIFF_CHUNK_ROWS 65536       // result rows turned into text per pool task
+#define DIFF_MAX_FIELDS 32          // the changed fields of a pair are a bit mask
+
+namespace {
+
+const qint64 NULL_KEY = std::numeric_limits<qint64>::min();
+
+// timestamp columns in order of preference, the first one both tables have is used.
+// Seconds come first: raw timestamps count in each file's own stream time base and
+// only pair up when both files were muxed with the same one.
+const char *const TIME_COLUMNS[] = {
+    "pts_time", "pkt_pts_time", "best_effort_timestamp_time",
+    "pts", "pkt_pts", "best_effort_timestamp"
+};
+
+qint64 power10(int exponent)
+{
+    qint64 value = 1;
+    while (exponent-- > 0) {
+        value *= 10;
+    }
+    return value;
+}
+
+bool fail(QString *error, const QString &message)
+{
+    if (error) {
+        *error = message;
+    }
+    qWarning() << "Table diff:" << message;
+    return false;
+}
+
+}
+
+struct TableDiff::Field {
+    enum Kind {
+        KIND_NUMBER,                // raw numbers, scaled to the same decimals
+        KIND_CODE,                  // dictionary codes, test codes mapped to reference codes
+        KIND_TEXT
+    };
+
+    QString name;
+    int referenceColumn = -1;
+    int testColumn = -1;
+    Kind kind = KIND_TEXT;
+    const qint64 *referenceNumbers = nullptr;
+    const qint64 *testNumbers = nullptr;
+    qint64 referenceScale = 1;
+    qint64 testScale = 1;
+    QVector<quint32> testCodes;     // reference code of every test code, UINT_MAX if the value is not there
+};
+
+TableDiff::TableDiff()
+    : m_fields(defaultFields())
+    , m_includeUnchanged(false)
+{
+}
+
+void TableDiff::setFields(const QStringList &fields)
+{
+    m_fields = fields;
+}
+
+void TableDiff::setIncludeUnchanged(bool include)
+{
+    m_includeUnchanged = include;
+}
+
+QStringList TableDiff::fields() const
+{
+    return m_fields;
+}
+
+bool TableDiff::includeUnchanged() const
+{
+    return m_includeUnchanged;
+}
+
+QStringList TableDiff::defaultFields()
+{
+    return QStringList() << "size" << "pkt_size" << "flags" << "pict_type" << "key_frame";
+}
+
+QString TableDiff::statusText(RowStatus status)
+{
+    switch (status) {
+    case ROW_SAME:      return "same";
+    case ROW_CHANGED:   return "changed";
+    case ROW_INSERTED:  return "inserted";
+    case ROW_MISSING:   return "missing";
+    }
+    return QString();
+}
+
+bool TableDiff::compare(const ColumnTableStore &reference, const QStringList &referenceHeaders,
+                        const ColumnTableStore &test, const QStringList &testHeaders,
+                        ColumnTableStore *result, QStringList *resultHeaders, Summary *summary,
+                        QString *error, const ZProbeScheduler::CancelToken &token) const
+{
+    *result = ColumnTableStore();
+    resultHeaders->clear();
+    *summary = Summary();
+
+    int referenceStream = findColumn(reference, referenceHeaders, "stream_index");
+    int testStream = findColumn(test, testHeaders, "stream_index");
+    if (referenceStream < 0 || testStream < 0) {
+        return fail(error, QObject::tr("Both tables need a stream_index column"));
+    }
+
+    int referenceTime = -1;
+    int testTime = -1;
+    for (const char *name : TIME_COLUMNS) {
+        referenceTime = findColumn(reference, referenceHeaders, name);
+        testTime = findColumn(test, testHeaders, name);
+        if (referenceTime >= 0 && testTime >= 0) {
+            summary->timeColumn = name;
+            break;
+        }
+    }
+    if (summary->timeColumn.isEmpty()) {
+        return fail(error, QObject::tr("The tables have no common timestamp column (pts_time, pkt_pts_time, best_effort_timestamp_time)"));
+    }
+
+    QVector<Field> fields;
+    for (const QString &name : m_fields) {
+        Field field;
+        field.name = name;
+        field.referenceColumn = findColumn(reference, referenceHeaders, name);
+        field.testColumn = findColumn(test, testHeaders, name);
+        if (field.referenceColumn < 0 || field.testColumn < 0) {
+            continue;
+        }
+        if (fields.size() == DIFF_MAX_FIELDS) {
+            qWarning() << "Table diff: only the first" << DIFF_MAX_FIELDS << "fields are compared";
+            break;
+        }
+
+        field.referenceNumbers = reference.numbers(field.referenceColumn);
+        field.testNumbers = test.numbers(field.testColumn);
+        if (field.referenceNumbers && field.testNumbers) {
+            int referenceDecimals = reference.decimals(field.referenceColumn);
+            int testDecimals = test.decimals(field.testColumn);
+            int decimals = qMax(referenceDecimals, testDecimals);
+            field.kind = Field::KIND_NUMBER;
+            field.referenceScale = power10(decimals - referenceDecimals);
+            field.testScale = power10(decimals - testDecimals);
+        } else if (reference.isDictionary(field.referenceColumn) && test.isDictionary(field.testColumn)) {
+            // code 0 is the null cell in both
+            QHash<QString, quint32> referenceCodes;
+            for (int code = 1; code < reference.dictionarySize(field.referenceColumn); ++code) {
+                referenceCodes.insert(reference.dictionaryValue(field.referenceColumn, code), static_cast<quint32>(code));
+            }
+            field.kind = Field::KIND_CODE;
+            field.testCodes.resize(test.dictionarySize(field.testColumn));
+            for (int code = 1; code < field.testCodes.size(); ++code) {
+                field.testCodes[code] = referenceCodes.value(test.dictionaryValue(field.testColumn, code),
+                                                             std::numeric_limits<quint32>::max());
+            }
+        }
+
+        fields.append(field);
+        summary->fields.append(name);
+    }
+
+    // timestamps of both tables on the same scale, e.g. pts_time with different precision
+    int decimals = qMax(reference.decimals(referenceTime), test.decimals(testTime));
+    QVector<qint64> referenceTimes = timeKeys(reference, referenceTime, decimals);
+    QVector<qint64> testTimes = timeKeys(test, testTime, decimals);
+    QVector<qint64> referenceStreams = streamKeys(reference, referenceStream);
+    QVector<qint64> testStreams = streamKeys(test, testStream);
+
+    // rows of every stream in table order
+    QMap<qint64, QPair<QVector<int>, QVector<int>>> streamRowMap;
+    for (int row = 0; row < referenceStreams.size(); ++row) {
+        streamRowMap[referenceStreams.at(row)].first.append(row);
+    }
+    for (int row = 0; row < testStreams.size(); ++row) {
+        streamRowMap[testStreams.at(row)].second.append(row);
+    }
+    QVector<QPair<QVector<int>, QVector<int>>> streamRows;
+    for (auto it = streamRowMap.begin(); it != streamRowMap.end(); ++it) {
+        streamRows.append(std::move(it.value()));
+    }
+    streamRowMap.clear();
+    summary->streams = streamRows.size();
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    // sort and merge every stream on its own, one stream per pool task
+    QVector<QVector<Match>> streamMatches(streamRows.size());
+    QPair<QVector<int>, QVector<int>> *rowsOfStream = streamRows.data();
+    QVector<Match> *matchesOfStream = streamMatches.data();
+    const qint64 *referenceKeys = referenceTimes.constData();
+    const qint64 *testKeys = testTimes.constData();
+    const Field *fieldData = fields.constData();
+    int fieldCount = fields.size();
+
+    QVector<int> streamTasks(streamRows.size());
+    std::iota(streamTasks.begin(), streamTasks.end(), 0);
+    QtConcurrent::blockingMap(streamTasks, [&](int task) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+
+        QVector<int> &referenceRows = rowsOfStream[task].first;
+        QVector<int> &testRows = rowsOfStream[task].second;
+
+        // frames are in pts order already, packets follow dts; equal timestamps keep the table order
+        auto byReferenceTime = [referenceKeys](int left, int right) {
+            return referenceKeys[left] < referenceKeys[right];
+        };
+        auto byTestTime = [testKeys](int left, int right) {
+            return testKeys[left] < testKeys[right];
+        };
+        if (!std::is_sorted(referenceRows.begin(), referenceRows.end(), byReferenceTime)) {
+            std::stable_sort(referenceRows.begin(), referenceRows.end(), byReferenceTime);
+        }
+        if (!std::is_sorted(testRows.begin(), testRows.end(), byTestTime)) {
+            std::stable_sort(testRows.begin(), testRows.end(), byTestTime);
+        }
+
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+
+        int referenceCount = referenceRows.size();
+        int testCount = testRows.size();
+        const int *referenceRow = referenceRows.constData();
+        const int *testRow = testRows.constData();
+
+        QVector<Match> &matches = matchesOfStream[task];
+        matches.reserve(qMax(referenceCount, testCount));
+
+        int i = 0;
+        int j = 0;
+        while (i < referenceCount || j < testCount) {
+            Match match;
+            if (j == testCount || (i < referenceCount && referenceKeys[referenceRow[i]] < testKeys[testRow[j]])) {
+                match.reference = referenceRow[i++];
+            } else if (i == referenceCount || testKeys[testRow[j]] < referenceKeys[referenceRow[i]]) {
+                match.test = testRow[j++];
+            } else {
+                // same timestamp, duplicates pair up in order
+                match.reference = referenceRow[i++];
+                match.test = testRow[j++];
+                for (int f = 0; f < fieldCount; ++f) {
+                    if (!fieldEqual(fieldData[f], reference, match.reference, test, match.test)) {
+                        match.changed |= 1u << f;
+                    }
+                }
+            }
+            matches.append(match);
+        }
+    });
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    auto statusOf = [](const Match &match) {
+        if (match.reference < 0) {
+            return ROW_INSERTED;
+        }
+        if (match.test < 0) {
+            return ROW_MISSING;
+        }
+        return match.changed ? ROW_CHANGED : ROW_SAME;
+    };
+
+    QVector<Match> rows;
+    for (QVector<Match> &matches : streamMatches) {
+        for (const Match &match : qAsConst(matches)) {
+            switch (statusOf(match)) {
+            case ROW_SAME:      ++summary->same; break;
+            case ROW_CHANGED:   ++summary->changed; break;
+            case ROW_INSERTED:  ++summary->inserted; break;
+            case ROW_MISSING:   ++summary->missing; break;
+            }
+            if (m_includeUnchanged || statusOf(match) != ROW_SAME) {
+                rows.append(match);
+            }
+        }
+        matches = QVector<Match>();
+    }
+
+    *resultHeaders << "status" << "stream_index" << summary->timeColumn << "diff_fields" << "ref_row" << "test_row";
+    for (const Field &field : qAsConst(fields)) {
+        *resultHeaders << "ref_" + field.name << "test_" + field.name;
+    }
+
+    // text of the result rows, one chunk of rows per pool task
+    int chunkCount = (rows.size() + DIFF_CHUNK_ROWS - 1) / DIFF_CHUNK_ROWS;
+    QVector<QList<QStringList>> chunks(chunkCount);
+    QList<QStringList> *chunkLines = chunks.data();
+    const Match *rowData = rows.constData();
+    int rowCount = rows.size();
+    int columnCount = resultHeaders->size();
+
+    QVector<int> chunkTasks(chunkCount);
+    std::iota(chunkTasks.begin(), chunkTasks.end(), 0);
+    QtConcurrent::blockingMap(chunkTasks, [&](int task) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+
+        int first = task * DIFF_CHUNK_ROWS;
+        int end = qMin(rowCount, first + DIFF_CHUNK_ROWS);
+        QList<QStringList> &lines = chunkLines[task];
+        lines.reserve(end - first);
+
+        for (int i = first; i < end; ++i) {
+            const Match &match = rowData[i];
+            bool hasReference = match.reference >= 0;
+            bool hasTest = match.test >= 0;
+
+            QStringList line;
+            line.reserve(columnCount);
+            line << statusText(statusOf(match));
+            if (hasReference) {
+                line << reference.text(match.reference, referenceStream) << reference.text(match.reference, referenceTime);
+            } else {
+                line << test.text(match.test, testStream) << test.text(match.test, testTime);
+            }
+
+            QStringList changed;
+            for (int f = 0; f < fieldCount; ++f) {
+                if (match.changed & (1u << f)) {
+                    changed.append(fieldData[f].name);
+                }
+            }
+            line << changed.join(',');
+
+            line << (hasReference ? QString::number(match.reference + 1) : QString());
+            line << (hasTest ? QString::number(match.test + 1) : QString());
+            for (int f = 0; f < fieldCount; ++f) {
+                line << (hasReference ? reference.text(match.reference, fieldData[f].referenceColumn) : QString());
+                line << (hasTest ? test.text(match.test, fieldData[f].testColumn) : QString());
+            }
+            lines.append(line);
+        }
+    });
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    result->setColumnCount(columnCount);
+    for (QList<QStringList> &lines : chunks) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            *result = ColumnTableStore();
+            return false;
+        }
+        result->appendRows(lines);
+        lines = QList<QStringList>();
+    }
+
+    return true;
+}
+
+int TableDiff::findColumn(const ColumnTableStore &store, const QStringList &headers, const QString &name)
+{
+    int column = headers.indexOf(name);
+    return column < store.columnCount() ? column : -1;
+}
+
+QVector<qint64> TableDiff::timeKeys(const ColumnTableStore &store, int column, int decimals)
+{
+    QVector<qint64> keys(store.rowCount(), NULL_KEY);
+
+    // N/A cells and text columns have no timestamp, they sort first and pair up in table order
+    const qint64 *numbers = store.numbers(column);
+    if (!numbers) {
+        return keys;
+    }
+
+    qint64 scale = power10(decimals - store.decimals(column));
+    for (int row = 0; row < keys.size(); ++row) {
+        if (ColumnTableStore::hasNumber(numbers[row])) {
+            keys[row] = numbers[row] * scale;
+        }
+    }
+    return keys;
+}
+
+QVector<qint64> TableDiff::streamKeys(const ColumnTableStore &store, int column)
+{
+    QVector<qint64> keys(store.rowCount(), -1);
+
+    const qint64 *numbers = store.numbers(column);
+    for (int row = 0; row < keys.size(); ++row) {
+        if (numbers) {
+            if (ColumnTableStore::hasNumber(numbers[row])) {
+                keys[row] = numbers[row];
+            }
+        } else {
+            bool ok = false;
+            qint64 value = store.text(row, column).toLongLong(&ok);
+            if (ok) {
+                keys[row] = value;
+            }
+        }
+    }
+    return keys;
+}
+
+bool TableDiff::fieldEqual(const Field &field, const ColumnTableStore &reference, int referenceRow,
+                           const ColumnTableStore &test, int testRow)
+{
+    switch (field.kind) {
+    case Field::KIND_NUMBER: {
+        qint64 referenceValue = field.referenceNumbers[referenceRow];
+        qint64 testValue = field.testNumbers[testRow];
+        if (ColumnTableStore::hasNumber(referenceValue) && ColumnTableStore::hasNumber(testValue)) {
+            return referenceValue * field.referenceScale == testValue * field.testScale;
+        }
+        // null cells and text that did not fit the type
+        break;
+    }
+    case Field::KIND_CODE: {
+        quint32 testCode = test.code(testRow, field.testColumn);
+        return testCode < static_cast<quint32>(field.testCodes.size())
+            && field.testCodes.at(static_cast<int>(testCode)) == reference.code(referenceRow, field.referenceColumn);
+    }
+    case Field::KIND_TEXT:
+        break;
+    }
+
+    return reference.text(referenceRow, field.referenceColumn) == test.text(testRow, field.testColumn);
+}
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLEDIFF_H
+#define TABLEDIFF_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+/**
+ * @brief Timestamp aligned diff of two packet or frame tables
+ *
+ * Rows of a reference and a test table are paired by stream_index and pts_time
+ * (pkt_pts_time, best_effort_timestamp_time... whichever both tables have, raw
+ * pts only without any of those, as time bases may differ). Each stream
+ * is sorted by its timestamps and walked with one linear merge, the streams
+ * are merged in parallel on the global thread pool. Paired rows are compared
+ * on the chosen fields, e.g. size, flags and pict_type; numbers compare
+ * raw, dictionary columns by code, no cell text is built for equal cells.
+ *
+ * The result is a new table with one row per pair or unpaired row: its
+ * status, the stream and timestamp, the changed fields, the row numbers in
+ * both tables and the reference and test value of every field.
+ */
+class TableDiff
+{
+public:
+    enum RowStatus {
+        ROW_SAME = 0,
+        ROW_CHANGED,        // paired, at least one field differs
+        ROW_INSERTED,       // only in the test table
+        ROW_MISSING         // only in the reference table
+    };
+
+    struct Summary {
+        QString timeColumn;
+        QStringList fields;         // compared fields found in both tables
+        int streams = 0;
+        qint64 same = 0;
+        qint64 changed = 0;
+        qint64 inserted = 0;
+        qint64 missing = 0;
+    };
+
+    TableDiff();
+
+    // Columns compared on paired rows, fields missing from either table are skipped
+    void setFields(const QStringList &fields);
+    // Also list the rows that are the same in both tables
+    void setIncludeUnchanged(bool include);
+
+    QStringList fields() const;
+    bool includeUnchanged() const;
+
+    // size, pkt_size, flags, pict_type, key_frame
+    static QStringList defaultFields();
+    static QString statusText(RowStatus status);
+
+    /**
+     * @brief Aligns the test table to the reference table
+     * @param result Merged rows, ordered by stream and timestamp
+     * @param resultHeaders Column names of the result
+     * @param token Checked between tasks, the diff stops once it is canceled
+     * @return false if the diff was canceled or the tables can not be aligned, see error
+     */
+    bool compare(const ColumnTableStore &reference, const QStringList &referenceHeaders,
+                 const ColumnTableStore &test, const QStringList &testHeaders,
+                 ColumnTableStore *result, QStringList *resultHeaders, Summary *summary,
+                 QString *error = nullptr,
+                 const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken()) const;
+
+private:
+    struct Field;
+
+    struct Match {
+        int reference = -1;         // -1 for inserted rows
+        int test = -1;              // -1 for missing rows
+        quint32 changed = 0;        // bit per compared field
+    };
+
+    static int findColumn(const ColumnTableStore &store, const QStringList &headers, const QString &name);
+    static QVector<qint64> timeKeys(const ColumnTableStore &store, int column, int decimals);
+    static QVector<qint64> streamKeys(const ColumnTableStore &store, int column);
+    static bool fieldEqual(const Field &field, const ColumnTableStore &reference, int referenceRow,
+                           const ColumnTableStore &test, int testRow);
+
+private:
+    QStringList m_fields;
+    bool m_includeUnchanged;
+};
+
+#endif // TABLEDIFF_H
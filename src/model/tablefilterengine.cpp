@@ -0,0 +1,275 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tablefilterengine.h"
+
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#define FILTER_CHUNK_ROWS 8192      // rows scanned by one pool task between two cancel checks
+
+TableFilterEngine::TableFilterEngine()
+    : m_caseSensitive(false)
+    , m_wholeWords(false)
+    , m_useRegex(false)
+{
+}
+
+void TableFilterEngine::setSearch(const QString &text, bool caseSensitive, bool wholeWords, bool useRegex)
+{
+    m_searchText = text;
+    m_caseSensitive = caseSensitive;
+    m_wholeWords = wholeWords;
+    m_useRegex = useRegex;
+
+    if (m_searchText.isEmpty()) {
+        m_regex = QRegularExpression();
+        return;
+    }
+
+    QString pattern = m_searchText;
+
+    // Escape special regex characters if not using regex mode
+    if (!m_useRegex) {
+        pattern = escapeRegexSpecialChars(pattern);
+    }
+
+    // Add word boundaries for whole word matching
+    if (m_wholeWords) {
+        pattern = QString("\\b%1\\b").arg(pattern);
+    }
+
+    // Set case sensitivity
+    QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
+    if (!m_caseSensitive) {
+        options |= QRegularExpression::CaseInsensitiveOption;
+    }
+
+    // Note: OptimizeOnFirstUsageOption was removed in Qt6 as the regex engine is optimized by default
+
+    m_regex.setPattern(pattern);
+    m_regex.setPatternOptions(options);
+
+    if (!m_regex.isValid()) {
+        qWarning() << "Invalid regular expression:" << pattern << "Error:" << m_regex.errorString();
+        // Fallback to escaped pattern
+        m_regex.setPattern(escapeRegexSpecialChars(m_searchText));
+        m_regex.setPatternOptions(options);
+    }
+
+    // compile once here instead of racing on the first match of every pool thread
+    m_regex.optimize();
+}
+
+void TableFilterEngine::setColumns(const QList<int> &columns)
+{
+    m_columns = columns;
+}
+
+void TableFilterEngine::setExpression(const QSharedPointer<const TableFilterExpression> &expression)
+{
+    m_expression = expression;
+}
+
+QString TableFilterEngine::searchText() const
+{
+    return m_searchText;
+}
+
+bool TableFilterEngine::isEmpty() const
+{
+    return m_searchText.isEmpty();
+}
+
+bool TableFilterEngine::matches(const QString &text) const
+{
+    if (m_searchText.isEmpty()) {
+        return true;
+    }
+
+    if (m_useRegex || m_wholeWords) {
+        return m_regex.match(text).hasMatch();
+    } else {
+        // Simple substring search
+        return text.contains(m_searchText, m_caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    }
+}
+
+bool TableFilterEngine::filter(const ColumnTableStore &store, QVector<int> *rows,
+                               const ZProbeScheduler::CancelToken &token, const TrigramIndex *index) const
+{
+    return filterRows(store, 0, store.rowCount(), rows, token, index);
+}
+
+bool TableFilterEngine::filterRange(const ColumnTableStore &store, int first, int end, QVector<int> *rows,
+                                    const ZProbeScheduler::CancelToken &token) const
+{
+    return filterRows(store, qMax(0, first), qMin(end, store.rowCount()), rows, token, nullptr);
+}
+
+bool TableFilterEngine::filterRows(const ColumnTableStore &store, int first, int end, QVector<int> *rows,
+                                   const ZProbeScheduler::CancelToken &token, const TrigramIndex *index) const
+{
+    rows->clear();
+
+    if (m_expression) {
+        return m_expression->evaluate(store, first, end, rows, token);
+    }
+
+    if (m_searchText.isEmpty()) {
+        rows->resize(qMax(0, end - first));
+        std::iota(rows->begin(), rows->end(), first);
+        return true;
+    }
+
+    QList<int> columns = searchedColumns(store);
+
+    // every distinct value of a dictionary column is tested once, not once per row
+    QVector<QVector<bool>> codeMatches(store.columnCount());
+    for (int col : columns) {
+        if (!store.isDictionary(col)) {
+            continue;
+        }
+        QVector<bool> &codes = codeMatches[col];
+        codes.resize(store.dictionarySize(col));
+        for (int code = 0; code < codes.size(); ++code) {
+            codes[code] = matches(store.dictionaryValue(col, static_cast<quint32>(code)));
+        }
+    }
+
+    // the index holds literal text, a pattern can match rows without any of its trigrams
+    bool indexed = index && !m_useRegex && m_searchText.size() >= 3 && first == 0 && end == store.rowCount()
+                   && index->rowCount() == store.rowCount() && index->columnCount() == store.columnCount();
+    for (int col : columns) {
+        indexed = indexed && (store.isDictionary(col) || index->isIndexed(col));
+    }
+
+    if (indexed) {
+        return indexedRows(store, columns, codeMatches, *index, rows, token);
+    }
+    return scanRows(store, columns, codeMatches, first, end, rows, token);
+}
+
+QList<int> TableFilterEngine::searchedColumns(const ColumnTableStore &store) const
+{
+    QList<int> columns;
+    if (m_columns.isEmpty()) {
+        for (int col = 0; col < store.columnCount(); ++col) {
+            columns.append(col);
+        }
+    } else {
+        for (int col : m_columns) {
+            if (col >= 0 && col < store.columnCount()) {
+                columns.append(col);
+            }
+        }
+    }
+    return columns;
+}
+
+bool TableFilterEngine::scanRows(const ColumnTableStore &store, const QList<int> &columns,
+                                 const QVector<QVector<bool>> &codeMatches, int first, int end, QVector<int> *rows,
+                                 const ZProbeScheduler::CancelToken &token) const
+{
+    QVector<int> chunks(qMax(0, (end - first + FILTER_CHUNK_ROWS - 1) / FILTER_CHUNK_ROWS));
+    std::iota(chunks.begin(), chunks.end(), 0);
+    QVector<QVector<int>> results(chunks.size());
+    QVector<int> *result = results.data();
+
+    QtConcurrent::blockingMap(chunks, [&](int chunk) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+
+        QVector<int> &matched = result[chunk];
+        int chunkEnd = qMin(end, first + (chunk + 1) * FILTER_CHUNK_ROWS);
+        for (int row = first + chunk * FILTER_CHUNK_ROWS; row < chunkEnd; ++row) {
+            for (int col : columns) {
+                bool hit = store.isDictionary(col) ? codeMatches.at(col).at(store.code(row, col))
+                                                   : matches(store.text(row, col));
+                if (hit) {
+                    matched.append(row);
+                    break; // Found match in at least one column
+                }
+            }
+        }
+    });
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    int count = 0;
+    for (const QVector<int> &matched : qAsConst(results)) {
+        count += matched.size();
+    }
+    rows->reserve(count);
+    for (const QVector<int> &matched : qAsConst(results)) {
+        rows->append(matched);
+    }
+    return true;
+}
+
+bool TableFilterEngine::indexedRows(const ColumnTableStore &store, const QList<int> &columns,
+                                    const QVector<QVector<bool>> &codeMatches, const TrigramIndex &index,
+                                    QVector<int> *rows, const ZProbeScheduler::CancelToken &token) const
+{
+    QList<int> dictionaryColumns;
+    QList<int> textColumns;
+    for (int col : columns) {
+        if (!store.isDictionary(col)) {
+            textColumns.append(col);
+        } else if (codeMatches.at(col).contains(true)) {
+            // columns without a matching value can not add rows
+            dictionaryColumns.append(col);
+        }
+    }
+
+    // dictionary columns: compare codes, one small integer per row
+    QVector<int> codeRows;
+    if (!dictionaryColumns.isEmpty()
+        && !scanRows(store, dictionaryColumns, codeMatches, 0, store.rowCount(), &codeRows, token)) {
+        return false;
+    }
+
+    // other columns: verify the rows having every trigram of the search text
+    QVector<int> textRows;
+    if (!textColumns.isEmpty()) {
+        QVector<int> candidates;
+        index.candidates(m_searchText, &candidates);
+        for (int row : qAsConst(candidates)) {
+            for (int col : qAsConst(textColumns)) {
+                if (matches(store.text(row, col))) {
+                    textRows.append(row);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    rows->reserve(codeRows.size() + textRows.size());
+    std::set_union(codeRows.constBegin(), codeRows.constEnd(), textRows.constBegin(), textRows.constEnd(),
+                   std::back_inserter(*rows));
+    return true;
+}
+
+QString TableFilterEngine::escapeRegexSpecialChars(const QString &text)
+{
+    QString result = text;
+
+    // Escape regex special characters
+    static const QString specialChars = "\\^$.*+?()[]{}|";
+    for (const QChar &ch : specialChars) {
+        result.replace(ch, QString("\\%1").arg(ch));
+    }
+
+    return result;
+}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLEFILTERENGINE_H
+#define TABLEFILTERENGINE_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QRegularExpression>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+#include "trigramindex.h"
+#include "tablefilterexpression.h"
+
+/**
+ * @brief Text search over the rows of a ColumnTableStore
+ *
+ * Holds the search options of MultiColumnSearchProxyModel (case, whole words,
+ * regular expression, searched columns) and scans a store in chunks on the
+ * global thread pool. Every distinct value of a dictionary column is tested
+ * once, other cells are turned into text only while they are scanned. With a
+ * TrigramIndex of the store, literal searches only verify the candidate rows.
+ * With a TableFilterExpression the search text is ignored and the expression
+ * picks the rows.
+ * The engine is copied into scheduler jobs and only read from there.
+ */
+class TableFilterEngine
+{
+public:
+    TableFilterEngine();
+
+    void setSearch(const QString &text, bool caseSensitive, bool wholeWords, bool useRegex);
+    // Columns searched by filter(), empty searches all columns
+    void setColumns(const QList<int> &columns);
+    // Replaces the text search, null goes back to it
+    void setExpression(const QSharedPointer<const TableFilterExpression> &expression);
+
+    QString searchText() const;
+    bool isEmpty() const;
+
+    bool matches(const QString &text) const;
+
+    /**
+     * @brief Rows of store with a match in one of the searched columns
+     * @param rows Ascending row indexes, every row when the search text is empty
+     * @param token Checked between chunks, the scan stops once it is canceled
+     * @param index Index built from the same rows, regular expressions and short
+     *              texts are scanned anyway
+     * @return false if the scan was canceled, rows is then incomplete
+     */
+    bool filter(const ColumnTableStore &store, QVector<int> *rows,
+                const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken(),
+                const TrigramIndex *index = nullptr) const;
+    // Same as filter() for the rows first <= row < end only, e.g. rows just appended
+    bool filterRange(const ColumnTableStore &store, int first, int end, QVector<int> *rows,
+                     const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken()) const;
+
+private:
+    bool filterRows(const ColumnTableStore &store, int first, int end, QVector<int> *rows,
+                    const ZProbeScheduler::CancelToken &token, const TrigramIndex *index) const;
+    QList<int> searchedColumns(const ColumnTableStore &store) const;
+    bool scanRows(const ColumnTableStore &store, const QList<int> &columns, const QVector<QVector<bool>> &codeMatches,
+                  int first, int end, QVector<int> *rows, const ZProbeScheduler::CancelToken &token) const;
+    bool indexedRows(const ColumnTableStore &store, const QList<int> &columns, const QVector<QVector<bool>> &codeMatches,
+                     const TrigramIndex &index, QVector<int> *rows, const ZProbeScheduler::CancelToken &token) const;
+
+    static QString escapeRegexSpecialChars(const QString &text);
+
+private:
+    QString m_searchText;
+    bool m_caseSensitive;
+    bool m_wholeWords;
+    bool m_useRegex;
+    QList<int> m_columns;
+    QSharedPointer<const TableFilterExpression> m_expression;
+
+    // Compiled regular expression for performance
+    QRegularExpression m_regex;
+};
+
+#endif // TABLEFILTERENGINE_H
@@ -0,0 +1,593 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tablefilterexpression.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#define EXPRESSION_BATCH_ROWS 4096  // rows evaluated per mask, and between two cancel checks
+
+namespace {
+
+// Branch free loop over the raw cells of a numeric column
+template <typename Predicate>
+void numberMask(const qint64 *values, int count, quint8 *mask, Predicate predicate)
+{
+    for (int i = 0; i < count; ++i) {
+        mask[i] = static_cast<quint8>(ColumnTableStore::hasNumber(values[i]) & predicate(values[i]));
+    }
+}
+
+}
+
+class TableFilterExpression::Parser
+{
+public:
+    Parser(const QString &text, const QStringList &headers, TableFilterExpression *expression)
+        : m_text(text)
+        , m_headers(headers)
+        , m_expression(expression)
+    {
+    }
+
+    bool parse(QString *error)
+    {
+        tokenize();
+        if (m_error.isEmpty()) {
+            m_expression->m_root = parseOr();
+        }
+        if (m_error.isEmpty() && m_current < m_tokens.size()) {
+            fail(QString("Unexpected '%1'").arg(m_tokens.at(m_current).text));
+        }
+        if (error) {
+            *error = m_error;
+        }
+        return m_error.isEmpty();
+    }
+
+private:
+    enum TokenType {
+        TOKEN_WORD,
+        TOKEN_NUMBER,
+        TOKEN_STRING,
+        TOKEN_SYMBOL
+    };
+
+    struct Token {
+        TokenType type = TOKEN_WORD;
+        QString text;
+        int position = 0;
+    };
+
+    void tokenize()
+    {
+        static const QStringList symbols = {"==", "!=", "<=", ">=", "&&", "||", "=", "<", ">", "!", "~", "(", ")"};
+
+        int i = 0;
+        while (i < m_text.size() && m_error.isEmpty()) {
+            QChar ch = m_text.at(i);
+            if (ch.isSpace()) {
+                ++i;
+                continue;
+            }
+
+            Token token;
+            token.position = i;
+
+            if (ch == '"' || ch == '\'') {
+                token.type = TOKEN_STRING;
+                int end = i + 1;
+                while (end < m_text.size() && m_text.at(end) != ch) {
+                    if (m_text.at(end) == '\\' && end + 1 < m_text.size()) {
+                        ++end;
+                    }
+                    token.text.append(m_text.at(end));
+                    ++end;
+                }
+                if (end >= m_text.size()) {
+                    fail("Unterminated string", i);
+                    return;
+                }
+                i = end + 1;
+            } else if (ch.isLetterOrNumber() || ch == '_'
+                       || ((ch == '-' || ch == '.') && i + 1 < m_text.size() && m_text.at(i + 1).isDigit())) {
+                int end = i + 1;
+                while (end < m_text.size() && (m_text.at(end).isLetterOrNumber() || m_text.at(end) == '_'
+                                               || m_text.at(end) == '.' || m_text.at(end) == ':')) {
+                    ++end;
+                }
+                token.text = m_text.mid(i, end - i);
+
+                // "-12.5" is a number, "h264" or "1080p" a bare word
+                bool isNumber = false;
+                token.text.toDouble(&isNumber);
+                token.type = isNumber ? TOKEN_NUMBER : TOKEN_WORD;
+                i = end;
+            } else {
+                token.type = TOKEN_SYMBOL;
+                for (const QString &symbol : symbols) {
+                    if (m_text.mid(i, symbol.size()) == symbol) {
+                        token.text = symbol;
+                        break;
+                    }
+                }
+                if (token.text.isEmpty()) {
+                    fail(QString("Unexpected character '%1'").arg(ch), i);
+                    return;
+                }
+                i += token.text.size();
+            }
+            m_tokens.append(token);
+        }
+    }
+
+    bool atSymbol(const QString &symbol) const
+    {
+        return m_current < m_tokens.size() && m_tokens.at(m_current).type == TOKEN_SYMBOL
+               && m_tokens.at(m_current).text == symbol;
+    }
+
+    bool atKeyword(const QString &keyword) const
+    {
+        return m_current < m_tokens.size() && m_tokens.at(m_current).type == TOKEN_WORD
+               && m_tokens.at(m_current).text.compare(keyword, Qt::CaseInsensitive) == 0;
+    }
+
+    int addNode(const Node &node)
+    {
+        m_expression->m_nodes.append(node);
+        return m_expression->m_nodes.size() - 1;
+    }
+
+    int addBinary(NodeType type, int left, int right)
+    {
+        Node node;
+        node.type = type;
+        node.left = left;
+        node.right = right;
+        return addNode(node);
+    }
+
+    int parseOr()
+    {
+        int left = parseAnd();
+        while (m_error.isEmpty() && (atSymbol("||") || atKeyword("or"))) {
+            ++m_current;
+            int right = parseAnd();
+            left = addBinary(NODE_OR, left, right);
+        }
+        return left;
+    }
+
+    int parseAnd()
+    {
+        int left = parseNot();
+        while (m_error.isEmpty() && (atSymbol("&&") || atKeyword("and"))) {
+            ++m_current;
+            int right = parseNot();
+            left = addBinary(NODE_AND, left, right);
+        }
+        return left;
+    }
+
+    int parseNot()
+    {
+        if (atSymbol("!") || atKeyword("not")) {
+            ++m_current;
+            int operand = parseNot();
+            return addBinary(NODE_NOT, operand, -1);
+        }
+        return parsePrimary();
+    }
+
+    int parsePrimary()
+    {
+        if (m_error.isEmpty() && atSymbol("(")) {
+            ++m_current;
+            int inner = parseOr();
+            if (m_error.isEmpty() && !atSymbol(")")) {
+                fail("Expected ')'");
+                return -1;
+            }
+            ++m_current;
+            return inner;
+        }
+        return parseComparison();
+    }
+
+    int parseComparison()
+    {
+        if (!m_error.isEmpty()) {
+            return -1;
+        }
+        if (m_current >= m_tokens.size() || m_tokens.at(m_current).type != TOKEN_WORD) {
+            fail("Expected a column name");
+            return -1;
+        }
+
+        Node node;
+        const Token &name = m_tokens.at(m_current);
+        node.column = findColumn(name.text);
+        if (node.column < 0) {
+            fail(QString("Unknown column '%1'").arg(name.text), name.position);
+            return -1;
+        }
+        ++m_current;
+
+        static const QList<QPair<QString, Operator>> operators = {
+            {"==", OP_EQ}, {"=", OP_EQ}, {"!=", OP_NE}, {"<", OP_LT}, {"<=", OP_LE},
+            {">", OP_GT}, {">=", OP_GE}, {"~", OP_CONTAINS}
+        };
+
+        bool found = false;
+        for (const auto &entry : operators) {
+            if (atSymbol(entry.first)) {
+                node.op = entry.second;
+                found = true;
+                break;
+            }
+        }
+        if (!found && atKeyword("contains")) {
+            node.op = OP_CONTAINS;
+            found = true;
+        }
+        if (!found && atKeyword("between")) {
+            node.op = OP_BETWEEN;
+            found = true;
+        }
+        if (!found) {
+            fail(QString("Expected a comparison after '%1'").arg(name.text));
+            return -1;
+        }
+        ++m_current;
+
+        if (!parseValue(&node.low)) {
+            return -1;
+        }
+        if (node.op == OP_BETWEEN) {
+            if (!atSymbol("&&") && !atKeyword("and")) {
+                fail("Expected 'and' in between");
+                return -1;
+            }
+            ++m_current;
+            if (!parseValue(&node.high)) {
+                return -1;
+            }
+        }
+
+        return addNode(node);
+    }
+
+    bool parseValue(Value *value)
+    {
+        if (m_current >= m_tokens.size() || m_tokens.at(m_current).type == TOKEN_SYMBOL) {
+            fail("Expected a value");
+            return false;
+        }
+
+        value->text = m_tokens.at(m_current).text;
+        value->number = value->text.toDouble(&value->isNumber);
+        ++m_current;
+        return true;
+    }
+
+    int findColumn(const QString &name) const
+    {
+        int column = m_headers.indexOf(name);
+        if (column >= 0) {
+            return column;
+        }
+        for (int i = 0; i < m_headers.size(); ++i) {
+            if (m_headers.at(i).compare(name, Qt::CaseInsensitive) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void fail(const QString &message, int position = -1)
+    {
+        if (!m_error.isEmpty()) {
+            return;
+        }
+        if (position < 0) {
+            position = m_current < m_tokens.size() ? m_tokens.at(m_current).position : m_text.size();
+        }
+        m_error = QString("%1 at %2").arg(message).arg(position + 1);
+    }
+
+private:
+    QString m_text;
+    QStringList m_headers;
+    TableFilterExpression *m_expression;
+    QVector<Token> m_tokens;
+    int m_current = 0;
+    QString m_error;
+};
+
+QSharedPointer<const TableFilterExpression> TableFilterExpression::parse(const QString &text, const QStringList &headers, QString *error)
+{
+    QSharedPointer<TableFilterExpression> expression(new TableFilterExpression());
+    Parser parser(text, headers, expression.data());
+    if (!parser.parse(error)) {
+        return QSharedPointer<const TableFilterExpression>();
+    }
+    return expression;
+}
+
+bool TableFilterExpression::evaluate(const ColumnTableStore &store, QVector<int> *rows,
+                                     const ZProbeScheduler::CancelToken &token) const
+{
+    return evaluate(store, 0, store.rowCount(), rows, token);
+}
+
+bool TableFilterExpression::evaluate(const ColumnTableStore &store, int first, int end, QVector<int> *rows,
+                                     const ZProbeScheduler::CancelToken &token) const
+{
+    rows->clear();
+    if (m_root < 0) {
+        return true;
+    }
+
+    // bind every comparison to the column types of this store once
+    QVector<Leaf> leaves(m_nodes.size());
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes.at(i).type == NODE_COMPARE) {
+            leaves[i] = compile(m_nodes.at(i), store);
+        }
+    }
+
+    first = qMax(0, first);
+    end = qMin(end, store.rowCount());
+    QVector<int> batches(qMax(0, (end - first + EXPRESSION_BATCH_ROWS - 1) / EXPRESSION_BATCH_ROWS));
+    std::iota(batches.begin(), batches.end(), 0);
+    QVector<QVector<int>> results(batches.size());
+    QVector<int> *result = results.data();
+
+    QtConcurrent::blockingMap(batches, [&](int batch) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+
+        int batchFirst = first + batch * EXPRESSION_BATCH_ROWS;
+        int count = qMin(EXPRESSION_BATCH_ROWS, end - batchFirst);
+        QVector<quint8> mask(count);
+        evaluateNode(m_root, leaves, store, batchFirst, count, mask.data());
+
+        QVector<int> &matched = result[batch];
+        for (int i = 0; i < count; ++i) {
+            if (mask.at(i)) {
+                matched.append(batchFirst + i);
+            }
+        }
+    });
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    for (const QVector<int> &matched : qAsConst(results)) {
+        rows->append(matched);
+    }
+    return true;
+}
+
+TableFilterExpression::Leaf TableFilterExpression::compile(const Node &node, const ColumnTableStore &store) const
+{
+    Leaf leaf;
+    ColumnTableStore::ColumnType type = store.columnType(node.column);
+
+    switch (type) {
+    case ColumnTableStore::TYPE_EMPTY:
+        break;
+    case ColumnTableStore::TYPE_DICTIONARY:
+        // each distinct value once, the rows only look up their code
+        leaf.kind = Leaf::LEAF_CODES;
+        leaf.codeMatches.resize(store.dictionarySize(node.column));
+        for (int code = 1; code < leaf.codeMatches.size(); ++code) {
+            leaf.codeMatches[code] = testValue(store.dictionaryValue(node.column, static_cast<quint32>(code)), node) ? 1 : 0;
+        }
+        break;
+    case ColumnTableStore::TYPE_TEXT:
+        leaf.kind = Leaf::LEAF_TEXT;
+        break;
+    default: {
+        Value low = node.low;
+        Value high = node.high;
+        if (type == ColumnTableStore::TYPE_BOOL) {
+            // bool cells are stored as 0 and 1
+            for (Value *value : {&low, &high}) {
+                if (value->text == QLatin1String("true") || value->text == QLatin1String("false")) {
+                    value->isNumber = true;
+                    value->number = value->text == QLatin1String("true") ? 1 : 0;
+                    value->text = QString::number(value->number);
+                }
+            }
+        }
+
+        bool numeric = node.op != OP_CONTAINS && low.isNumber && (node.op != OP_BETWEEN || high.isNumber);
+        if (!numeric) {
+            // e.g. pts == "N/A" or pts contains "00", compare the text
+            leaf.kind = Leaf::LEAF_TEXT;
+            break;
+        }
+
+        // literals are scaled exactly, a double product such as 0.3 * 10 misses the cell 3
+        int decimals = store.decimals(node.column);
+        qint64 lowFloor = 0;
+        qint64 highFloor = 0;
+        bool lowExact = true;
+        bool highExact = true;
+        if (!ColumnTableStore::scaleNumber(low.text, decimals, &lowFloor, &lowExact)
+            || (node.op == OP_BETWEEN && !ColumnTableStore::scaleNumber(high.text, decimals, &highFloor, &highExact))) {
+            leaf.kind = Leaf::LEAF_TEXT;
+            break;
+        }
+        qint64 lowCeil = lowExact ? lowFloor : lowFloor + 1;
+
+        // every operator is a range of raw cells, a literal finer than the column rounds inwards
+        leaf.kind = Leaf::LEAF_NUMBER;
+        leaf.numbers = store.numbers(node.column);
+        leaf.low = std::numeric_limits<qint64>::min();
+        leaf.high = std::numeric_limits<qint64>::max();
+        switch (node.op) {
+        case OP_EQ:
+        case OP_NE:
+            if (lowExact) {
+                leaf.low = lowFloor;
+                leaf.high = lowFloor;
+            } else {
+                // no cell holds a value with more decimals than its column
+                leaf.low = 1;
+                leaf.high = 0;
+            }
+            leaf.outside = node.op == OP_NE;
+            break;
+        case OP_LT:
+            leaf.high = lowCeil - 1;
+            break;
+        case OP_LE:
+            leaf.high = lowFloor;
+            break;
+        case OP_GT:
+            leaf.low = lowFloor + 1;
+            break;
+        case OP_GE:
+            leaf.low = lowCeil;
+            break;
+        case OP_BETWEEN:
+            leaf.low = lowCeil;
+            leaf.high = highFloor;
+            break;
+        case OP_CONTAINS:
+            break;
+        }
+        break;
+    }
+    }
+    return leaf;
+}
+
+void TableFilterExpression::evaluateNode(int node, const QVector<Leaf> &leaves, const ColumnTableStore &store,
+                                         int first, int count, quint8 *mask) const
+{
+    const Node &entry = m_nodes.at(node);
+
+    switch (entry.type) {
+    case NODE_AND: {
+        evaluateNode(entry.left, leaves, store, first, count, mask);
+        if (std::none_of(mask, mask + count, [](quint8 value) { return value; })) {
+            return;
+        }
+        QVector<quint8> other(count);
+        evaluateNode(entry.right, leaves, store, first, count, other.data());
+        for (int i = 0; i < count; ++i) {
+            mask[i] &= other.at(i);
+        }
+        break;
+    }
+    case NODE_OR: {
+        evaluateNode(entry.left, leaves, store, first, count, mask);
+        if (std::all_of(mask, mask + count, [](quint8 value) { return value; })) {
+            return;
+        }
+        QVector<quint8> other(count);
+        evaluateNode(entry.right, leaves, store, first, count, other.data());
+        for (int i = 0; i < count; ++i) {
+            mask[i] |= other.at(i);
+        }
+        break;
+    }
+    case NODE_NOT:
+        evaluateNode(entry.left, leaves, store, first, count, mask);
+        for (int i = 0; i < count; ++i) {
+            mask[i] ^= 1;
+        }
+        break;
+    case NODE_COMPARE:
+        evaluateLeaf(entry, leaves.at(node), store, first, count, mask);
+        break;
+    }
+}
+
+void TableFilterExpression::evaluateLeaf(const Node &node, const Leaf &leaf, const ColumnTableStore &store,
+                                         int first, int count, quint8 *mask) const
+{
+    switch (leaf.kind) {
+    case Leaf::LEAF_NONE:
+        std::memset(mask, 0, count);
+        break;
+    case Leaf::LEAF_NUMBER: {
+        const qint64 *values = leaf.numbers + first;
+        qint64 low = leaf.low;
+        qint64 high = leaf.high;
+        if (leaf.outside) {
+            numberMask(values, count, mask, [low, high](qint64 value) { return (value < low) | (value > high); });
+        } else {
+            numberMask(values, count, mask, [low, high](qint64 value) { return (value >= low) & (value <= high); });
+        }
+        break;
+    }
+    case Leaf::LEAF_CODES: {
+        QVector<quint32> codes(count);
+        store.codes(node.column, first, count, codes.data());
+        const quint8 *matches = leaf.codeMatches.constData();
+        for (int i = 0; i < count; ++i) {
+            mask[i] = matches[codes.at(i)];
+        }
+        break;
+    }
+    case Leaf::LEAF_TEXT:
+        for (int i = 0; i < count; ++i) {
+            mask[i] = testValue(store.text(first + i, node.column), node) ? 1 : 0;
+        }
+        break;
+    }
+}
+
+bool TableFilterExpression::testValue(const QString &value, const Node &node)
+{
+    if (value.isEmpty()) {
+        return false;
+    }
+    if (node.op == OP_CONTAINS) {
+        return value.contains(node.low.text, Qt::CaseInsensitive);
+    }
+
+    bool isNumber = false;
+    double number = value.toDouble(&isNumber);
+    bool numericLiteral = node.low.isNumber && (node.op != OP_BETWEEN || node.high.isNumber);
+    if (numericLiteral && !isNumber) {
+        // "N/A" and friends are null to a numeric comparison, as on the LEAF_NUMBER path
+        return false;
+    }
+    if (numericLiteral) {
+        switch (node.op) {
+        case OP_EQ: return number == node.low.number;
+        case OP_NE: return number != node.low.number;
+        case OP_LT: return number < node.low.number;
+        case OP_LE: return number <= node.low.number;
+        case OP_GT: return number > node.low.number;
+        case OP_GE: return number >= node.low.number;
+        case OP_BETWEEN: return number >= node.low.number && number <= node.high.number;
+        default: return false;
+        }
+    }
+
+    int order = QString::compare(value, node.low.text);
+    switch (node.op) {
+    case OP_EQ: return order == 0;
+    case OP_NE: return order != 0;
+    case OP_LT: return order < 0;
+    case OP_LE: return order <= 0;
+    case OP_GT: return order > 0;
+    case OP_GE: return order >= 0;
+    case OP_BETWEEN: return order >= 0 && QString::compare(value, node.high.text) <= 0;
+    default: return false;
+    }
+}
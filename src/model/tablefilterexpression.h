@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLEFILTEREXPRESSION_H
+#define TABLEFILTEREXPRESSION_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSharedPointer>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+/**
+ * @brief Small filter language over the columns of an info table
+ *
+ * Examples:
+ *   stream_index == 0 && pict_type == "I" && pkt_size > 200000
+ *   pts_time between 120 and 180
+ *   !(flags contains "K") || codec_type != video
+ *
+ * Comparisons are ==, !=, <, <=, >, >=, contains and between ... and ...,
+ * combined with &&/and, ||/or, !/not and parentheses. Values are numbers,
+ * quoted strings or bare words. Numbers compare numerically, anything else
+ * by text; null cells never match a comparison.
+ *
+ * Every comparison is bound to the column type of the store it runs on:
+ * numeric columns compare their raw int64 cells, dictionary columns test
+ * each distinct value once and then look up codes. Rows are evaluated in
+ * batches of byte masks on the global thread pool.
+ */
+class TableFilterExpression
+{
+public:
+    /**
+     * @brief Parse text, column names are looked up in headers
+     * @param error Reason and position when the text is not a valid expression
+     * @return Null on error
+     */
+    static QSharedPointer<const TableFilterExpression> parse(const QString &text, const QStringList &headers, QString *error);
+
+    /**
+     * @brief Rows of store matching the expression
+     * @param rows Ascending row indexes
+     * @param token Checked between batches, the evaluation stops once it is canceled
+     * @return false if the evaluation was canceled
+     */
+    bool evaluate(const ColumnTableStore &store, QVector<int> *rows,
+                  const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken()) const;
+    // Rows first <= row < end of store matching the expression
+    bool evaluate(const ColumnTableStore &store, int first, int end, QVector<int> *rows,
+                  const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken()) const;
+
+private:
+    enum NodeType {
+        NODE_AND,
+        NODE_OR,
+        NODE_NOT,
+        NODE_COMPARE
+    };
+
+    enum Operator {
+        OP_EQ,
+        OP_NE,
+        OP_LT,
+        OP_LE,
+        OP_GT,
+        OP_GE,
+        OP_CONTAINS,
+        OP_BETWEEN
+    };
+
+    struct Value {
+        QString text;
+        bool isNumber = false;
+        double number = 0;
+    };
+
+    struct Node {
+        NodeType type = NODE_COMPARE;
+        int left = -1;              // operands of and/or, not only uses left
+        int right = -1;
+        int column = -1;
+        Operator op = OP_EQ;
+        Value low;
+        Value high;                 // upper bound of between
+    };
+
+    // Compare node bound to the column type of one store
+    struct Leaf {
+        enum Kind {
+            LEAF_NONE,              // column without values, never matches
+            LEAF_NUMBER,
+            LEAF_CODES,
+            LEAF_TEXT
+        };
+        Kind kind = LEAF_NONE;
+        const qint64 *numbers = nullptr;
+        qint64 low = 0;             // inclusive range of raw cells
+        qint64 high = 0;
+        bool outside = false;       // match the cells outside the range, !=
+        QVector<quint8> codeMatches;
+    };
+
+    class Parser;
+
+    TableFilterExpression() = default;
+
+    Leaf compile(const Node &node, const ColumnTableStore &store) const;
+    void evaluateNode(int node, const QVector<Leaf> &leaves, const ColumnTableStore &store,
+                      int first, int count, quint8 *mask) const;
+    void evaluateLeaf(const Node &node, const Leaf &leaf, const ColumnTableStore &store,
+                      int first, int count, quint8 *mask) const;
+    static bool testValue(const QString &value, const Node &node);
+
+private:
+    QVector<Node> m_nodes;
+    int m_root = -1;
+};
+
+#endif // TABLEFILTEREXPRESSION_H
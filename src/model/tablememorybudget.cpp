@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tablememorybudget.h"
+#include "mediainfotabelmodel.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+#include <common/common.h>
+
+#define BUDGET_IDLE_MS 2000             // quiet time after the last change before the budget is checked
+#define BUDGET_TARGET_PERCENT 75        // spilling stops below this share of the budget
+#define SPILL_MIN_COLUMN_BYTES (1 << 20) // smaller columns are not worth a file
+
+TableMemoryBudget::TableMemoryBudget()
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(BUDGET_IDLE_MS);
+    QObject::connect(&m_timer, &QTimer::timeout, [this]() {
+        enforce();
+    });
+}
+
+void TableMemoryBudget::addModel(MediaInfoTabelModel *model)
+{
+    if (model && !m_models.contains(model)) {
+        m_models.append(model);
+    }
+}
+
+void TableMemoryBudget::removeModel(MediaInfoTabelModel *model)
+{
+    m_models.removeAll(model);
+}
+
+void TableMemoryBudget::touch(MediaInfoTabelModel *model)
+{
+    if (m_models.removeAll(model) > 0) {
+        m_models.append(model);
+    }
+    m_timer.start();
+}
+
+void TableMemoryBudget::enforce()
+{
+    qint64 budget = Common::instance()->getConfigValue(TABLE_MEMORY_BUDGET_KEY, DEFAULT_TABLE_MEMORY_BUDGET).toLongLong() * 1024 * 1024;
+    if (budget <= 0) {
+        return;
+    }
+
+    qint64 total = 0;
+    for (MediaInfoTabelModel *model : qAsConst(m_models)) {
+        if (!model->isPaged()) {
+            total += model->store().memoryUsage();
+        }
+    }
+
+    if (total <= budget) {
+        return;
+    }
+    qint64 excess = total - budget * BUDGET_TARGET_PERCENT / 100;
+
+    qInfo() << "Info tables use" << total / (1024 * 1024) << "MB, spilling" << excess / (1024 * 1024) << "MB to disk";
+
+    for (MediaInfoTabelModel *model : qAsConst(m_models)) {
+        if (model->isPaged()) {
+            continue;
+        }
+
+        // largest columns first, fewer files for the same relief
+        const ColumnTableStore &store = model->store();
+        QVector<QPair<qint64, int>> columns;
+        for (int column = 0; column < store.columnCount(); ++column) {
+            qint64 bytes = store.isSpilled(column) ? 0 : store.memoryUsage(column);
+            if (bytes >= SPILL_MIN_COLUMN_BYTES) {
+                columns.append(qMakePair(bytes, column));
+            }
+        }
+        std::sort(columns.begin(), columns.end(), [](const QPair<qint64, int> &left, const QPair<qint64, int> &right) {
+            return left.first > right.first;
+        });
+
+        QList<int> spilled;
+        for (const auto &column : qAsConst(columns)) {
+            spilled.append(column.second);
+            excess -= column.first;
+            if (excess <= 0) {
+                break;
+            }
+        }
+
+        model->spillColumns(spilled);
+        if (excess <= 0) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLEMEMORYBUDGET_H
+#define TABLEMEMORYBUDGET_H
+
+#include <QList>
+#include <QTimer>
+
+#include <common/zsingleton.h>
+
+class MediaInfoTabelModel;
+
+/**
+ * @brief Heap budget shared by every info table
+ *
+ * Models report their changes through touch(). Once no table has changed for
+ * a moment, the stores above General/tableMemoryBudgetMB spill columns to
+ * memory mapped temp files: the largest columns of the least recently
+ * changed tables first, until the tables are back under three quarters of
+ * the budget. Paged tables keep few rows and are left alone. GUI thread only.
+ */
+class TableMemoryBudget
+{
+    DECLARE_ZSINGLETON(TableMemoryBudget)
+
+public:
+    void addModel(MediaInfoTabelModel *model);
+    void removeModel(MediaInfoTabelModel *model);
+
+    // The rows of a model changed, it becomes the most recently used table
+    void touch(MediaInfoTabelModel *model);
+
+private:
+    TableMemoryBudget();
+    ~TableMemoryBudget() = default;
+
+    void enforce();
+
+private:
+    QList<MediaInfoTabelModel *> m_models;  // least recently changed first
+    QTimer m_timer;
+};
+
+#endif // TABLEMEMORYBUDGET_H
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tablemimedata.h"
+
+#define COPY_CHUNK_ROWS 4096        // rows written between two cancel checks and progress reports
+
+TableMimeData::TableMimeData(const ColumnTableStore &store, const QVector<int> &rows, const QList<int> &columns,
+                             const QStringList &header, const QString &separator)
+    : m_store(store)
+    , m_rows(rows)
+    , m_columns(columns)
+    , m_header(header)
+    , m_separator(separator)
+    , m_serialized(false)
+{
+    if (m_columns.isEmpty()) {
+        for (int col = 0; col < m_store.columnCount(); ++col) {
+            m_columns.append(col);
+        }
+    }
+}
+
+int TableMimeData::rowCount() const
+{
+    return m_rows.isEmpty() ? m_store.rowCount() : m_rows.size();
+}
+
+bool TableMimeData::serialize(const ZProbeScheduler::CancelToken &token, const std::function<void(int)> &progress) const
+{
+    if (m_serialized) {
+        return true;
+    }
+
+    QByteArray text;
+    if (!m_header.isEmpty()) {
+        text += m_header.join(m_separator).toUtf8();
+        text += '\n';
+    }
+
+    // one chunk of UTF-16 at a time, only the UTF-8 text grows with the row count
+    int total = rowCount();
+    QString chunk;
+    for (int first = 0; first < total; first += COPY_CHUNK_ROWS) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return false;
+        }
+
+        int end = qMin(total, first + COPY_CHUNK_ROWS);
+        chunk.clear();
+        for (int i = first; i < end; ++i) {
+            int row = m_rows.isEmpty() ? i : m_rows.at(i);
+            for (int c = 0; c < m_columns.size(); ++c) {
+                if (c > 0) {
+                    chunk += m_separator;
+                }
+                chunk += m_store.text(row, m_columns.at(c));
+            }
+            chunk += '\n';
+        }
+        text += chunk.toUtf8();
+
+        if (progress) {
+            progress(static_cast<int>(qint64(end) * 100 / total));
+        }
+    }
+
+    m_text = text;
+    m_serialized = true;
+    m_store = ColumnTableStore();
+    m_rows = QVector<int>();
+    return true;
+}
+
+QStringList TableMimeData::formats() const
+{
+    return QStringList() << QStringLiteral("text/plain");
+}
+
+bool TableMimeData::hasFormat(const QString &mimeType) const
+{
+    return mimeType == QLatin1String("text/plain");
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+QVariant TableMimeData::retrieveData(const QString &mimeType, QVariant::Type type) const
+#else
+QVariant TableMimeData::retrieveData(const QString &mimeType, QMetaType type) const
+#endif
+{
+    Q_UNUSED(type)
+
+    if (!hasFormat(mimeType)) {
+        return QVariant();
+    }
+
+    // QMimeData::text() decodes UTF-8 bytes, platform clipboards take them as they are
+    serialize();
+    return m_text;
+}
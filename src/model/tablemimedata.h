@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLEMIMEDATA_H
+#define TABLEMIMEDATA_H
+
+#include <QMimeData>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+
+#include <functional>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+/**
+ * @brief Clipboard payload of copied info table cells
+ *
+ * Holds a snapshot of the column store and the copied rows and columns, and
+ * writes them as UTF-8 text in chunks of rows, cells separated by tabs or by
+ * the separator of the raw view. serialize() is
+ * meant to run on a worker thread before the object is handed to the
+ * clipboard; a payload put on the clipboard unserialized writes its text on
+ * the first request. The text is kept once, as UTF-8, and handed out as
+ * "text/plain" without a QString copy.
+ */
+class TableMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param rows Store rows in copy order, empty copies every row
+     * @param columns Store columns, empty copies every column
+     * @param header First line, empty for none
+     * @param separator Between two cells of a line
+     */
+    TableMimeData(const ColumnTableStore &store, const QVector<int> &rows, const QList<int> &columns,
+                  const QStringList &header = QStringList(), const QString &separator = QStringLiteral("\t"));
+
+    int rowCount() const;
+
+    /**
+     * @brief Write the text, progress gets the percentage after every chunk
+     * @return false if token was canceled, the text is then dropped
+     */
+    bool serialize(const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken(),
+                   const std::function<void(int)> &progress = std::function<void(int)>()) const;
+
+    QStringList formats() const override;
+    bool hasFormat(const QString &mimeType) const override;
+
+protected:
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QVariant retrieveData(const QString &mimeType, QVariant::Type type) const override;
+#else
+    QVariant retrieveData(const QString &mimeType, QMetaType type) const override;
+#endif
+
+private:
+    // released once the text is written, the clipboard may keep the payload for long
+    mutable ColumnTableStore m_store;
+    mutable QVector<int> m_rows;
+    QList<int> m_columns;
+    QStringList m_header;
+    QString m_separator;
+
+    mutable QByteArray m_text;
+    mutable bool m_serialized;
+};
+
+#endif // TABLEMIMEDATA_H
@@ -0,0 +1,416 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tablesnapshot.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QtEndian>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include <algorithm>
+
+#define SNAPSHOT_MAGIC 0x5A545331           // "ZTS1"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_CHUNK_ROWS 65536           // rows of one column compressed together
+#define SNAPSHOT_COMPRESSION_LEVEL 3        // zlib level, inflating costs the same for every level
+#define SNAPSHOT_MAX_DECIMALS 9             // digits after the point a decimal column of the store can have
+
+namespace {
+
+bool fail(QString *error, const QString &message)
+{
+    if (error) {
+        *error = message;
+    }
+    qWarning() << "Table snapshot:" << message;
+    return false;
+}
+
+}
+
+bool TableSnapshot::save(const QString &fileName, const ColumnTableStore &store, const Info &info,
+                         QString *error, const ZProbeScheduler::CancelToken &token)
+{
+    const int rowCount = store.rowCount();
+    const int columnCount = store.columnCount();
+
+    QVector<Chunk> chunks;
+    for (int column = 0; column < columnCount; ++column) {
+        if (store.columnType(column) == ColumnTableStore::TYPE_EMPTY) {
+            continue;
+        }
+        for (int first = 0; first < rowCount; first += SNAPSHOT_CHUNK_ROWS) {
+            Chunk chunk;
+            chunk.column = column;
+            chunk.firstRow = first;
+            chunk.rowCount = qMin(SNAPSHOT_CHUNK_ROWS, rowCount - first);
+            chunks.append(chunk);
+        }
+    }
+
+    // chunks are independent, they are encoded and compressed on the global pool
+    QtConcurrent::blockingMap(chunks, [&store, &token](Chunk &chunk) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+        QByteArray raw = encodeChunk(store, chunk);
+        chunk.rawSize = raw.size();
+        chunk.data = qCompress(raw, SNAPSHOT_COMPRESSION_LEVEL);
+        chunk.size = chunk.data.size();
+    });
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    qint64 offset = 0;
+    for (Chunk &chunk : chunks) {
+        chunk.offset = offset;
+        offset += chunk.size;
+    }
+
+    QByteArray directory;
+    QDataStream out(&directory, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << info.headers << info.command << info.sourceFile << info.sourceSize << info.sourceModified
+        << info.sourceIdentity << info.created;
+    out << qint32(rowCount) << qint32(columnCount);
+    for (const ColumnTableStore::Column &column : store.m_columns) {
+        out << qint32(column.type) << qint32(column.decimals) << qint32(column.codeWidth) << qint32(column.maxLength)
+            << column.dictionary << column.exceptions;
+    }
+    out << qint32(chunks.size());
+    for (const Chunk &chunk : qAsConst(chunks)) {
+        out << qint32(chunk.column) << qint32(chunk.firstRow) << qint32(chunk.rowCount)
+            << qint64(chunk.offset) << qint32(chunk.size) << qint32(chunk.rawSize);
+    }
+
+    // magic, version, data offset, then the directory as a length prefixed block
+    quint64 dataOffset = 4 + 4 + 8 + 4 + quint64(directory.size());
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(error, QObject::tr("Cannot write %1: %2").arg(fileName, file.errorString()));
+    }
+
+    QDataStream header(&file);
+    header.setVersion(QDataStream::Qt_5_12);
+    header << quint32(SNAPSHOT_MAGIC) << quint32(SNAPSHOT_VERSION) << dataOffset << directory;
+    for (const Chunk &chunk : qAsConst(chunks)) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            file.cancelWriting();
+            return false;
+        }
+        file.write(chunk.data);
+    }
+
+    if (!file.commit()) {
+        return fail(error, QObject::tr("Cannot write %1: %2").arg(fileName, file.errorString()));
+    }
+    return true;
+}
+
+bool TableSnapshot::load(const QString &fileName, ColumnTableStore *store, Info *info, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(error, QObject::tr("Cannot open %1: %2").arg(fileName, file.errorString()));
+    }
+
+    QDataStream header(&file);
+    header.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 dataOffset = 0;
+    QByteArray directory;
+    header >> magic >> version;
+    if (header.status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC) {
+        return fail(error, QObject::tr("%1 is not a table session file").arg(fileName));
+    }
+    if (version > SNAPSHOT_VERSION) {
+        return fail(error, QObject::tr("%1 was written by a newer version (format %2)").arg(fileName).arg(version));
+    }
+    header >> dataOffset >> directory;
+    if (header.status() != QDataStream::Ok || dataOffset > quint64(file.size())) {
+        return fail(error, QObject::tr("%1 is truncated").arg(fileName));
+    }
+
+    Info sessionInfo;
+    ColumnTableStore result;
+    qint32 rowCount = 0;
+    qint32 columnCount = 0;
+    qint32 chunkCount = 0;
+
+    QDataStream in(directory);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> sessionInfo.headers >> sessionInfo.command >> sessionInfo.sourceFile >> sessionInfo.sourceSize
+       >> sessionInfo.sourceModified >> sessionInfo.sourceIdentity >> sessionInfo.created;
+    in >> rowCount >> columnCount;
+    if (in.status() != QDataStream::Ok || rowCount < 0 || columnCount < 0) {
+        return fail(error, QObject::tr("%1 has a broken directory").arg(fileName));
+    }
+
+    result.m_rowCount = rowCount;
+    result.m_columns.resize(columnCount);
+    for (ColumnTableStore::Column &column : result.m_columns) {
+        qint32 type = 0;
+        qint32 decimals = 0;
+        qint32 codeWidth = 0;
+        qint32 maxLength = 0;
+        in >> type >> decimals >> codeWidth >> maxLength >> column.dictionary >> column.exceptions;
+        if (type < ColumnTableStore::TYPE_EMPTY || type > ColumnTableStore::TYPE_TEXT
+            || decimals < 0 || decimals > SNAPSHOT_MAX_DECIMALS || (codeWidth != 1 && codeWidth != 2 && codeWidth != 4)) {
+            return fail(error, QObject::tr("%1 has a broken directory").arg(fileName));
+        }
+        column.type = static_cast<ColumnTableStore::ColumnType>(type);
+        column.decimals = decimals;
+        column.codeWidth = codeWidth;
+        column.maxLength = maxLength;
+
+        for (auto it = column.exceptions.constBegin(); it != column.exceptions.constEnd(); ++it) {
+            if (it.key() < 0 || it.key() >= rowCount) {
+                return fail(error, QObject::tr("%1 has a broken directory").arg(fileName));
+            }
+        }
+
+        // every column is resized once here, the chunks fill disjoint parts in parallel
+        switch (column.type) {
+        case ColumnTableStore::TYPE_EMPTY:
+            break;
+        case ColumnTableStore::TYPE_DICTIONARY:
+            // code 0 is the null cell, it is never interned
+            for (int code = 1; code < column.dictionary.size(); ++code) {
+                column.dictionaryIndex.insert(column.dictionary.at(code), quint32(code));
+            }
+            if (column.codeWidth == 1) {
+                column.codes8.resize(rowCount);
+            } else if (column.codeWidth == 2) {
+                column.codes16.resize(rowCount);
+            } else {
+                column.codes32.resize(rowCount);
+            }
+            break;
+        case ColumnTableStore::TYPE_TEXT:
+            column.texts.resize(rowCount);
+            break;
+        default:
+            column.numbers.resize(rowCount);
+            break;
+        }
+    }
+
+    in >> chunkCount;
+    QVector<Chunk> chunks(qMax(0, chunkCount));
+    qint64 dataSize = file.size() - qint64(dataOffset);
+    for (Chunk &chunk : chunks) {
+        qint32 column = 0;
+        qint32 firstRow = 0;
+        qint32 chunkRows = 0;
+        qint64 offset = 0;
+        qint32 size = 0;
+        qint32 rawSize = 0;
+        in >> column >> firstRow >> chunkRows >> offset >> size >> rawSize;
+        if (column < 0 || column >= columnCount || firstRow < 0 || chunkRows <= 0 || firstRow > rowCount - chunkRows
+            || offset < 0 || size <= 0 || rawSize < 0 || offset > dataSize - size) {
+            return fail(error, QObject::tr("%1 has a broken chunk table").arg(fileName));
+        }
+        chunk.column = column;
+        chunk.firstRow = firstRow;
+        chunk.rowCount = chunkRows;
+        chunk.offset = offset;
+        chunk.size = size;
+        chunk.rawSize = rawSize;
+    }
+    if (in.status() != QDataStream::Ok) {
+        return fail(error, QObject::tr("%1 has a broken directory").arg(fileName));
+    }
+
+    // the chunks of a column must tile it exactly, overlapping ones would be
+    // inflated into the same cells from two threads
+    std::sort(chunks.begin(), chunks.end(), [](const Chunk &a, const Chunk &b) {
+        return a.column != b.column ? a.column < b.column : a.firstRow < b.firstRow;
+    });
+    QVector<qint64> covered(columnCount, 0);
+    for (const Chunk &chunk : qAsConst(chunks)) {
+        if (chunk.firstRow != covered.at(chunk.column)) {
+            return fail(error, QObject::tr("%1 has overlapping or missing cells in column %2").arg(fileName).arg(chunk.column));
+        }
+        covered[chunk.column] += chunk.rowCount;
+    }
+    for (int column = 0; column < columnCount; ++column) {
+        bool empty = result.m_columns.at(column).type == ColumnTableStore::TYPE_EMPTY;
+        if (covered.at(column) != (empty || rowCount == 0 ? 0 : rowCount)) {
+            return fail(error, QObject::tr("%1 misses cells of column %2").arg(fileName).arg(column));
+        }
+    }
+
+    // cells are inflated straight from the mapping, a failed map falls back to reading the file
+    QByteArray contents;
+    const uchar *data = file.map(qint64(dataOffset), dataSize);
+    if (!data && dataSize > 0) {
+        file.seek(qint64(dataOffset));
+        contents = file.readAll();
+        if (contents.size() != dataSize) {
+            return fail(error, QObject::tr("Cannot read %1: %2").arg(fileName, file.errorString()));
+        }
+        data = reinterpret_cast<const uchar *>(contents.constData());
+    }
+
+    QVector<void *> cells(columnCount, nullptr);
+    for (int column = 0; column < columnCount; ++column) {
+        ColumnTableStore::Column &entry = result.m_columns[column];
+        switch (entry.type) {
+        case ColumnTableStore::TYPE_EMPTY:
+            break;
+        case ColumnTableStore::TYPE_DICTIONARY:
+            cells[column] = entry.codeWidth == 1 ? static_cast<void *>(entry.codes8.data())
+                            : entry.codeWidth == 2 ? static_cast<void *>(entry.codes16.data())
+                                                   : static_cast<void *>(entry.codes32.data());
+            break;
+        case ColumnTableStore::TYPE_TEXT:
+            cells[column] = entry.texts.data();
+            break;
+        default:
+            cells[column] = entry.numbers.data();
+            break;
+        }
+    }
+
+    QAtomicInt broken(0);
+    const ColumnTableStore::Column *columns = result.m_columns.constData();
+    QtConcurrent::blockingMap(chunks, [data, columns, &cells, &broken](const Chunk &chunk) {
+        if (broken.loadAcquire()) {
+            return;
+        }
+        QByteArray raw = qUncompress(data + chunk.offset, chunk.size);
+        if (raw.size() != chunk.rawSize
+            || !decodeChunk(columns[chunk.column], cells.at(chunk.column), chunk, raw)) {
+            broken.storeRelease(1);
+        }
+    });
+    if (broken.loadAcquire()) {
+        return fail(error, QObject::tr("%1 has corrupt cells").arg(fileName));
+    }
+
+    *store = result;
+    if (info) {
+        *info = sessionInfo;
+    }
+    return true;
+}
+
+QByteArray TableSnapshot::encodeChunk(const ColumnTableStore &store, const Chunk &chunk)
+{
+    const ColumnTableStore::Column &column = store.m_columns.at(chunk.column);
+    const int first = chunk.firstRow;
+    const int count = chunk.rowCount;
+    QByteArray raw;
+
+    switch (column.type) {
+    case ColumnTableStore::TYPE_EMPTY:
+        break;
+    case ColumnTableStore::TYPE_DICTIONARY: {
+        QVector<quint32> codes(count);
+        store.codes(chunk.column, first, count, codes.data());
+        int width = column.codeWidth;
+        raw.resize(count * width);
+        uchar *out = reinterpret_cast<uchar *>(raw.data());
+        for (int i = 0; i < count; ++i) {
+            if (width == 1) {
+                out[i] = static_cast<uchar>(codes.at(i));
+            } else if (width == 2) {
+                qToLittleEndian<quint16>(static_cast<quint16>(codes.at(i)), out + i * 2);
+            } else {
+                qToLittleEndian<quint32>(codes.at(i), out + i * 4);
+            }
+        }
+        break;
+    }
+    case ColumnTableStore::TYPE_TEXT: {
+        // every length first, then the UTF-16 text of the cells
+        QVector<QString> texts(count);
+        qint64 chars = 0;
+        for (int i = 0; i < count; ++i) {
+            texts[i] = ColumnTableStore::textAt(column, first + i);
+            chars += texts.at(i).size();
+        }
+        raw.resize(int(count * 4 + chars * 2));
+        uchar *out = reinterpret_cast<uchar *>(raw.data());
+        for (int i = 0; i < count; ++i) {
+            qToLittleEndian<qint32>(texts.at(i).size(), out + i * 4);
+        }
+        out += count * 4;
+        for (const QString &text : qAsConst(texts)) {
+            qToLittleEndian<quint16>(text.utf16(), text.size(), out);
+            out += text.size() * 2;
+        }
+        break;
+    }
+    default:
+        raw.resize(count * 8);
+        qToLittleEndian<qint64>(ColumnTableStore::numberData(column) + first, count, raw.data());
+        break;
+    }
+    return raw;
+}
+
+bool TableSnapshot::decodeChunk(const ColumnTableStore::Column &column, void *cells, const Chunk &chunk, const QByteArray &raw)
+{
+    const int first = chunk.firstRow;
+    const int count = chunk.rowCount;
+    const uchar *in = reinterpret_cast<const uchar *>(raw.constData());
+
+    switch (column.type) {
+    case ColumnTableStore::TYPE_EMPTY:
+        return true;
+    case ColumnTableStore::TYPE_DICTIONARY: {
+        int width = column.codeWidth;
+        if (raw.size() != count * width) {
+            return false;
+        }
+        // a code outside the dictionary would be read past its end later
+        quint32 dictionarySize = static_cast<quint32>(column.dictionary.size());
+        quint32 maxCode = 0;
+        if (width == 1) {
+            quint8 *codes = static_cast<quint8 *>(cells) + first;
+            std::copy(in, in + count, codes);
+            maxCode = *std::max_element(codes, codes + count);
+        } else if (width == 2) {
+            quint16 *codes = static_cast<quint16 *>(cells) + first;
+            qFromLittleEndian<quint16>(in, count, codes);
+            maxCode = *std::max_element(codes, codes + count);
+        } else {
+            quint32 *codes = static_cast<quint32 *>(cells) + first;
+            qFromLittleEndian<quint32>(in, count, codes);
+            maxCode = *std::max_element(codes, codes + count);
+        }
+        return maxCode < dictionarySize;
+    }
+    case ColumnTableStore::TYPE_TEXT: {
+        if (raw.size() < count * 4) {
+            return false;
+        }
+        QString *texts = static_cast<QString *>(cells) + first;
+        const uchar *text = in + count * 4;
+        const uchar *end = in + raw.size();
+        for (int i = 0; i < count; ++i) {
+            qint32 length = qFromLittleEndian<qint32>(in + i * 4);
+            if (length < 0 || length > (end - text) / 2) {
+                return false;
+            }
+            texts[i].resize(length);
+            qFromLittleEndian<quint16>(text, length, texts[i].data());
+            text += length * 2;
+        }
+        return text == end;
+    }
+    default:
+        if (raw.size() != count * 8) {
+            return false;
+        }
+        qFromLittleEndian<qint64>(in, count, static_cast<qint64 *>(cells) + first);
+        return true;
+    }
+}
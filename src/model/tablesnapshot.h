@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLESNAPSHOT_H
+#define TABLESNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+/**
+ * @brief Binary session file of an info table
+ *
+ * Keeps the typed columns of a ColumnTableStore together with the schema,
+ * the identity of the probed file and the probe command, so a long scan can
+ * be reopened or handed to someone else without probing again.
+ *
+ * Layout: magic, format version and the offset of the cell data, then a
+ * directory with the session info, the column types, dictionaries and the
+ * chunk table. Every column is cut into chunks of rows, each compressed on
+ * its own. Loading maps the file and inflates the chunks in parallel straight
+ * into the column vectors, no cell text is parsed. Cells are little endian,
+ * the header and directory are QDataStream's big endian. Files of a newer
+ * format version are refused.
+ */
+class TableSnapshot
+{
+public:
+    struct Info {
+        QStringList headers;
+        QString command;                // probe command the rows came from
+        QString sourceFile;             // path on the machine that saved it
+        qint64 sourceSize = -1;
+        QDateTime sourceModified;
+        QByteArray sourceIdentity;      // ZProbeCache::contentIdentity(), independent of the path
+        QDateTime created;
+    };
+
+    // Runs on any thread, a canceled token leaves no file behind
+    static bool save(const QString &fileName, const ColumnTableStore &store, const Info &info,
+                     QString *error = nullptr,
+                     const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken());
+    static bool load(const QString &fileName, ColumnTableStore *store, Info *info, QString *error = nullptr);
+
+private:
+    struct Chunk {
+        int column = 0;
+        int firstRow = 0;
+        int rowCount = 0;
+        qint64 offset = 0;              // from the start of the cell data
+        int size = 0;                   // compressed
+        int rawSize = 0;
+        QByteArray data;                // only while saving
+    };
+
+    static QByteArray encodeChunk(const ColumnTableStore &store, const Chunk &chunk);
+    // cells is the first cell of the pre-sized vector of the column
+    static bool decodeChunk(const ColumnTableStore::Column &column, void *cells, const Chunk &chunk, const QByteArray &raw);
+};
+
+#endif // TABLESNAPSHOT_H
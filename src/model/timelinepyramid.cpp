@@ -0,0 +1,414 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "timelinepyramid.h"
+
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+#define TIMELINE_CANCEL_ROWS 65536  // rows read between two cancel checks
+
+namespace {
+
+// time columns in order of preference, without one the row number is the time
+const char *const TIME_COLUMNS[] = {
+    "pts_time", "pkt_pts_time", "best_effort_timestamp_time", "dts_time", "pkt_dts_time"
+};
+
+const char *const VALUE_COLUMNS[] = {
+    "size", "pkt_size"
+};
+
+int findColumn(const ColumnTableStore &store, const QStringList &headers, const QString &name)
+{
+    int column = headers.indexOf(name);
+    return column < store.columnCount() ? column : -1;
+}
+
+double power10(int exponent)
+{
+    return std::pow(10.0, exponent);
+}
+
+bool fail(QString *error, const QString &message)
+{
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+// A text column mapped to small values, looked up by dictionary code where the column has one
+class CellMap
+{
+public:
+    CellMap(const ColumnTableStore &store, int column, quint8 fallback, const std::function<quint8(const QString &)> &map)
+        : m_store(store)
+        , m_column(column)
+        , m_fallback(fallback)
+        , m_map(map)
+    {
+        if (m_column >= 0 && m_store.isDictionary(m_column)) {
+            m_codes.resize(m_store.dictionarySize(m_column));
+            for (int code = 0; code < m_codes.size(); ++code) {
+                m_codes[code] = m_map(m_store.dictionaryValue(m_column, static_cast<quint32>(code)));
+            }
+        }
+    }
+
+    bool isValid() const
+    {
+        return m_column >= 0;
+    }
+
+    quint8 at(int row) const
+    {
+        if (m_column < 0) {
+            return m_fallback;
+        }
+        if (!m_codes.isEmpty()) {
+            return m_codes.value(static_cast<int>(m_store.code(row, m_column)), m_fallback);
+        }
+        return m_map(m_store.text(row, m_column));
+    }
+
+private:
+    const ColumnTableStore &m_store;
+    int m_column;
+    quint8 m_fallback;
+    std::function<quint8(const QString &)> m_map;
+    QVector<quint8> m_codes;
+};
+
+}
+
+TimelinePyramid::TimelinePyramid()
+    : m_series(CATEGORY_COUNT)
+{
+}
+
+bool TimelinePyramid::build(const ColumnTableStore &store, const QStringList &headers, qint64 stream,
+                            QString *error, const ZProbeScheduler::CancelToken &token)
+{
+    *this = TimelinePyramid();
+
+    int valueColumn = -1;
+    for (const char *name : VALUE_COLUMNS) {
+        valueColumn = findColumn(store, headers, name);
+        if (valueColumn >= 0) {
+            m_valueColumn = name;
+            break;
+        }
+    }
+    if (valueColumn < 0) {
+        return fail(error, QObject::tr("The table has no size or pkt_size column"));
+    }
+    const qint64 *values = store.numbers(valueColumn);
+    if (!values) {
+        return fail(error, QObject::tr("The %1 column holds no numbers").arg(m_valueColumn));
+    }
+    double valueScale = 1.0 / power10(store.decimals(valueColumn));
+
+    const qint64 *times = nullptr;
+    double timeScale = 1.0;
+    for (const char *name : TIME_COLUMNS) {
+        int column = findColumn(store, headers, name);
+        times = column >= 0 ? store.numbers(column) : nullptr;
+        if (times) {
+            m_timeColumn = name;
+            timeScale = 1.0 / power10(store.decimals(column));
+            break;
+        }
+    }
+
+    int streamColumn = findColumn(store, headers, "stream_index");
+    const qint64 *streams = streamColumn >= 0 ? store.numbers(streamColumn) : nullptr;
+
+    // key_frame of frames, the K flag of packets
+    int keyColumn = findColumn(store, headers, "key_frame");
+    const qint64 *keyFrames = keyColumn >= 0 ? store.numbers(keyColumn) : nullptr;
+    CellMap keyFlags(store, keyFrames ? -1 : findColumn(store, headers, "flags"), 0, [](const QString &flags) {
+        return static_cast<quint8>(flags.contains('K'));
+    });
+
+    int mediaColumn = findColumn(store, headers, "codec_type");
+    if (mediaColumn < 0) {
+        mediaColumn = findColumn(store, headers, "media_type");
+    }
+    CellMap video(store, mediaColumn, 1, [](const QString &type) {
+        return static_cast<quint8>(type == QLatin1String("video"));
+    });
+
+    CellMap pictureTypes(store, findColumn(store, headers, "pict_type"), CATEGORY_OTHER, [](const QString &type) {
+        if (type == QLatin1String("I")) {
+            return static_cast<quint8>(CATEGORY_I);
+        }
+        if (type == QLatin1String("P")) {
+            return static_cast<quint8>(CATEGORY_P);
+        }
+        if (type == QLatin1String("B")) {
+            return static_cast<quint8>(CATEGORY_B);
+        }
+        return static_cast<quint8>(CATEGORY_OTHER);
+    });
+
+    QVector<Series> series(CATEGORY_COUNT);
+    int rowCount = store.rowCount();
+    for (int row = 0; row < rowCount; ++row) {
+        if (row % TIMELINE_CANCEL_ROWS == 0 && ZProbeScheduler::isCanceled(token)) {
+            return false;
+        }
+
+        qint64 streamIndex = streams && ColumnTableStore::hasNumber(streams[row]) ? streams[row] : -1;
+        if (!m_streams.contains(streamIndex)) {
+            m_streams.append(streamIndex);
+        }
+        if (stream >= 0 && streamIndex != stream) {
+            continue;
+        }
+
+        if (!ColumnTableStore::hasNumber(values[row]) || (times && !ColumnTableStore::hasNumber(times[row]))) {
+            continue;
+        }
+
+        int category = CATEGORY_OTHER;
+        if (video.at(row)) {
+            bool key = keyFrames ? ColumnTableStore::hasNumber(keyFrames[row]) && keyFrames[row] != 0
+                                 : keyFlags.at(row) != 0;
+            category = key ? CATEGORY_KEY : pictureTypes.at(row);
+        }
+
+        Series &points = series[category];
+        points.times.append(times ? times[row] * timeScale : row);
+        points.values.append(static_cast<float>(values[row] * valueScale));
+        points.rows.append(row);
+    }
+    std::sort(m_streams.begin(), m_streams.end());
+
+    // sort and build the levels of every category on its own, one category per pool task
+    Series *seriesData = series.data();
+    QVector<int> categoryTasks(CATEGORY_COUNT);
+    std::iota(categoryTasks.begin(), categoryTasks.end(), 0);
+    QtConcurrent::blockingMap(categoryTasks, [&](int task) {
+        if (ZProbeScheduler::isCanceled(token)) {
+            return;
+        }
+
+        // packets follow dts, B pictures come before the pictures they follow in time
+        Series &points = seriesData[task];
+        if (!std::is_sorted(points.times.constBegin(), points.times.constEnd())) {
+            QVector<int> order(points.times.size());
+            std::iota(order.begin(), order.end(), 0);
+            const double *time = points.times.constData();
+            std::stable_sort(order.begin(), order.end(), [time](int left, int right) {
+                return time[left] < time[right];
+            });
+
+            Series sorted;
+            sorted.times.reserve(order.size());
+            sorted.values.reserve(order.size());
+            sorted.rows.reserve(order.size());
+            for (int index : qAsConst(order)) {
+                sorted.times.append(points.times.at(index));
+                sorted.values.append(points.values.at(index));
+                sorted.rows.append(points.rows.at(index));
+            }
+            points = sorted;
+        }
+
+        buildLevels(points);
+    });
+
+    if (ZProbeScheduler::isCanceled(token)) {
+        return false;
+    }
+
+    m_series = series;
+    return true;
+}
+
+bool TimelinePyramid::isEmpty() const
+{
+    for (const Series &series : m_series) {
+        if (!series.times.isEmpty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int TimelinePyramid::pointCount(Category category) const
+{
+    return m_series.at(category).times.size();
+}
+
+double TimelinePyramid::firstTime() const
+{
+    double time = std::numeric_limits<double>::max();
+    for (const Series &series : m_series) {
+        if (!series.times.isEmpty()) {
+            time = qMin(time, series.times.first());
+        }
+    }
+    return isEmpty() ? 0 : time;
+}
+
+double TimelinePyramid::lastTime() const
+{
+    double time = std::numeric_limits<double>::lowest();
+    for (const Series &series : m_series) {
+        if (!series.times.isEmpty()) {
+            time = qMax(time, series.times.last());
+        }
+    }
+    return isEmpty() ? 0 : time;
+}
+
+QString TimelinePyramid::timeColumn() const
+{
+    return m_timeColumn;
+}
+
+QString TimelinePyramid::valueColumn() const
+{
+    return m_valueColumn;
+}
+
+QVector<qint64> TimelinePyramid::streams() const
+{
+    return m_streams;
+}
+
+void TimelinePyramid::decimate(Category category, double from, double to, int width, float *minimum, float *maximum) const
+{
+    if (width <= 0) {
+        return;
+    }
+    std::fill(minimum, minimum + width, std::numeric_limits<float>::infinity());
+    std::fill(maximum, maximum + width, -std::numeric_limits<float>::infinity());
+
+    const Series &series = m_series.at(category);
+    if (to <= from || series.times.isEmpty()) {
+        return;
+    }
+
+    int first = static_cast<int>(std::lower_bound(series.times.constBegin(), series.times.constEnd(), from) - series.times.constBegin());
+    int last = static_cast<int>(std::upper_bound(series.times.constBegin(), series.times.constEnd(), to) - series.times.constBegin());
+    if (first >= last) {
+        return;
+    }
+
+    // about two buckets per pixel, finer levels would only find the same extremes
+    int count = last - first;
+    int level = 0;
+    while (level < series.levels.size() && (count >> (level + 1)) >= 2 * width) {
+        ++level;
+    }
+
+    double scale = width / (to - from);
+    for (int index = first >> level; index <= (last - 1) >> level; ++index) {
+        accumulate(series, level, index, from, scale, width, minimum, maximum);
+    }
+}
+
+int TimelinePyramid::nearestRow(double time, double tolerance) const
+{
+    int row = -1;
+    double distance = tolerance;
+
+    // later categories win ties, the key pictures are drawn on top
+    for (const Series &series : m_series) {
+        int index = static_cast<int>(std::lower_bound(series.times.constBegin(), series.times.constEnd(), time) - series.times.constBegin());
+        for (int candidate = index - 1; candidate <= index; ++candidate) {
+            if (candidate < 0 || candidate >= series.times.size()) {
+                continue;
+            }
+            double candidateDistance = std::fabs(series.times.at(candidate) - time);
+            if (candidateDistance <= distance) {
+                distance = candidateDistance;
+                row = series.rows.at(candidate);
+            }
+        }
+    }
+
+    return row;
+}
+
+void TimelinePyramid::buildLevels(Series &series)
+{
+    series.levels.clear();
+
+    int count = series.times.size();
+    if (count < 2) {
+        return;
+    }
+
+    QVector<Bucket> level((count + 1) / 2);
+    for (int i = 0; i < level.size(); ++i) {
+        int left = 2 * i;
+        int right = qMin(left + 1, count - 1);
+        Bucket &bucket = level[i];
+        bucket.first = series.times.at(left);
+        bucket.last = series.times.at(right);
+        bucket.minimum = qMin(series.values.at(left), series.values.at(right));
+        bucket.maximum = qMax(series.values.at(left), series.values.at(right));
+    }
+
+    while (level.size() > 1) {
+        QVector<Bucket> next((level.size() + 1) / 2);
+        for (int i = 0; i < next.size(); ++i) {
+            const Bucket &left = level.at(2 * i);
+            const Bucket &right = level.at(qMin(2 * i + 1, level.size() - 1));
+            Bucket &bucket = next[i];
+            bucket.first = left.first;
+            bucket.last = right.last;
+            bucket.minimum = qMin(left.minimum, right.minimum);
+            bucket.maximum = qMax(left.maximum, right.maximum);
+        }
+        series.levels.append(level);
+        level.swap(next);
+    }
+    series.levels.append(level);
+}
+
+void TimelinePyramid::accumulate(const Series &series, int level, int index, double from, double scale, int width,
+                                 float *minimum, float *maximum)
+{
+    if (level == 0) {
+        double x = (series.times.at(index) - from) * scale;
+        if (x >= 0 && x < width) {
+            int pixel = static_cast<int>(x);
+            float value = series.values.at(index);
+            minimum[pixel] = qMin(minimum[pixel], value);
+            maximum[pixel] = qMax(maximum[pixel], value);
+        }
+        return;
+    }
+
+    const Bucket &bucket = series.levels.at(level - 1).at(index);
+    double firstX = std::floor((bucket.first - from) * scale);
+    double lastX = std::floor((bucket.last - from) * scale);
+    if (lastX < 0 || firstX >= width) {
+        return;
+    }
+
+    if (firstX == lastX) {
+        int pixel = static_cast<int>(firstX);
+        minimum[pixel] = qMin(minimum[pixel], bucket.minimum);
+        maximum[pixel] = qMax(maximum[pixel], bucket.maximum);
+        return;
+    }
+
+    // the bucket crosses a pixel boundary, e.g. a gap in the stream or the edge of the view
+    int childCount = level == 1 ? series.times.size() : series.levels.at(level - 2).size();
+    accumulate(series, level - 1, 2 * index, from, scale, width, minimum, maximum);
+    if (2 * index + 1 < childCount) {
+        accumulate(series, level - 1, 2 * index + 1, from, scale, width, minimum, maximum);
+    }
+}
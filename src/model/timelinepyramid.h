@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TIMELINEPYRAMID_H
+#define TIMELINEPYRAMID_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+/**
+ * @brief Multi-resolution min/max series of packet or frame sizes over time
+ *
+ * The sizes of a table are split by picture type (key, I, P, B, other) and
+ * sorted by timestamp. Every series keeps levels of buckets with the time
+ * span and the smallest and largest size of 2, 4, 8... neighbouring points.
+ * decimate() walks the coarsest level that still has about two buckets per
+ * pixel and only descends into buckets that cross a pixel boundary, so the
+ * cost of a redraw depends on the width of the chart, not on the point count.
+ */
+class TimelinePyramid
+{
+public:
+    enum Category {
+        CATEGORY_OTHER = 0,     // audio, subtitles, frames without a picture type
+        CATEGORY_B,
+        CATEGORY_P,
+        CATEGORY_I,             // intra pictures not flagged as key
+        CATEGORY_KEY,
+        CATEGORY_COUNT
+    };
+
+    TimelinePyramid();
+
+    /**
+     * @brief Builds the series of one stream of a table
+     * @param stream stream_index to plot, -1 for every stream
+     * @param token Checked between tasks, the build stops once it is canceled
+     * @return false if the build was canceled or the table has no size column, see error
+     */
+    bool build(const ColumnTableStore &store, const QStringList &headers, qint64 stream,
+               QString *error = nullptr,
+               const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken());
+
+    bool isEmpty() const;
+    int pointCount(Category category) const;
+    double firstTime() const;
+    double lastTime() const;
+
+    // Columns the series were read from, the time column is empty when rows stand in for time
+    QString timeColumn() const;
+    QString valueColumn() const;
+    // Distinct stream_index values of the whole table, ascending
+    QVector<qint64> streams() const;
+
+    /**
+     * @brief Smallest and largest size of one category per pixel column
+     * @param from Time at the left edge of the first pixel
+     * @param to Time at the right edge of the last pixel
+     * @param minimum,maximum width values each, pixels without a point get minimum > maximum
+     */
+    void decimate(Category category, double from, double to, int width, float *minimum, float *maximum) const;
+
+    // Table row of the point closest to time, -1 if no point is within tolerance
+    int nearestRow(double time, double tolerance) const;
+
+private:
+    struct Bucket {
+        double first = 0;           // time of the first and last point
+        double last = 0;
+        float minimum = 0;
+        float maximum = 0;
+    };
+
+    struct Series {
+        QVector<double> times;      // ascending
+        QVector<float> values;
+        QVector<int> rows;          // table row of every point
+        QVector<QVector<Bucket>> levels;    // levels[k] holds buckets of 2^(k+1) points
+    };
+
+    static void buildLevels(Series &series);
+    static void accumulate(const Series &series, int level, int index, double from, double scale, int width,
+                           float *minimum, float *maximum);
+
+private:
+    QVector<Series> m_series;       // one per category
+    QString m_timeColumn;
+    QString m_valueColumn;
+    QVector<qint64> m_streams;
+};
+
+#endif // TIMELINEPYRAMID_H
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "trigramindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+#define TRIGRAM_CANCEL_ROWS 4096    // rows indexed between two cancel checks
+
+namespace {
+
+quint64 trigramKey(const QChar *text)
+{
+    return (quint64(text[0].unicode()) << 32) | (quint64(text[1].unicode()) << 16) | quint64(text[2].unicode());
+}
+
+}
+
+TrigramIndex::TrigramIndex()
+    : m_rowCount(0)
+{
+}
+
+QSharedPointer<const TrigramIndex> TrigramIndex::build(const ColumnTableStore &store, const ZProbeScheduler::CancelToken &token)
+{
+    QSharedPointer<TrigramIndex> index(new TrigramIndex());
+    index->m_rowCount = store.rowCount();
+    index->m_indexed.resize(store.columnCount());
+
+    QList<int> columns;
+    for (int col = 0; col < store.columnCount(); ++col) {
+        ColumnTableStore::ColumnType type = store.columnType(col);
+        index->m_indexed[col] = type != ColumnTableStore::TYPE_DICTIONARY;
+        if (type != ColumnTableStore::TYPE_DICTIONARY && type != ColumnTableStore::TYPE_EMPTY) {
+            columns.append(col);
+        }
+    }
+
+    for (int row = 0; row < store.rowCount(); ++row) {
+        if (row % TRIGRAM_CANCEL_ROWS == 0 && ZProbeScheduler::isCanceled(token)) {
+            return QSharedPointer<const TrigramIndex>();
+        }
+        for (int col : columns) {
+            if (!store.isNull(row, col)) {
+                index->addText(store.text(row, col).toCaseFolded(), row);
+            }
+        }
+    }
+
+    for (Posting &posting : index->m_postings) {
+        posting.deltas.squeeze();
+    }
+    return index;
+}
+
+int TrigramIndex::rowCount() const
+{
+    return m_rowCount;
+}
+
+int TrigramIndex::columnCount() const
+{
+    return m_indexed.size();
+}
+
+bool TrigramIndex::isIndexed(int column) const
+{
+    return column >= 0 && column < m_indexed.size() && m_indexed.at(column);
+}
+
+bool TrigramIndex::candidates(const QString &text, QVector<int> *rows) const
+{
+    rows->clear();
+
+    QString folded = text.toCaseFolded();
+    if (folded.size() < 3) {
+        return false;
+    }
+
+    QVector<const Posting *> postings;
+    for (int i = 0; i + 3 <= folded.size(); ++i) {
+        auto it = m_postings.constFind(trigramKey(folded.constData() + i));
+        if (it == m_postings.constEnd()) {
+            // a trigram no cell has, nothing can match
+            return true;
+        }
+        if (!postings.contains(&it.value())) {
+            postings.append(&it.value());
+        }
+    }
+
+    // start from the rarest trigram, every further list can only shrink the result
+    std::sort(postings.begin(), postings.end(), [](const Posting *left, const Posting *right) {
+        return left->count < right->count;
+    });
+
+    *rows = decode(*postings.first());
+    for (int i = 1; i < postings.size() && !rows->isEmpty(); ++i) {
+        QVector<int> other = decode(*postings.at(i));
+        QVector<int> both;
+        both.reserve(qMin(rows->size(), other.size()));
+        std::set_intersection(rows->constBegin(), rows->constEnd(), other.constBegin(), other.constEnd(),
+                              std::back_inserter(both));
+        rows->swap(both);
+    }
+    return true;
+}
+
+qint64 TrigramIndex::memoryUsage() const
+{
+    qint64 bytes = 0;
+    for (const Posting &posting : m_postings) {
+        // row list plus its hash node
+        bytes += posting.deltas.capacity() + 48;
+    }
+    return bytes;
+}
+
+void TrigramIndex::addText(const QString &text, int row)
+{
+    for (int i = 0; i + 3 <= text.size(); ++i) {
+        Posting &posting = m_postings[trigramKey(text.constData() + i)];
+        if (posting.lastRow == row) {
+            continue;
+        }
+
+        // rows ascend, most deltas of frequent trigrams fit in one byte
+        quint32 delta = static_cast<quint32>(row - posting.lastRow);
+        while (delta >= 0x80) {
+            posting.deltas.append(static_cast<char>((delta & 0x7F) | 0x80));
+            delta >>= 7;
+        }
+        posting.deltas.append(static_cast<char>(delta));
+
+        posting.lastRow = row;
+        ++posting.count;
+    }
+}
+
+QVector<int> TrigramIndex::decode(const Posting &posting)
+{
+    QVector<int> rows;
+    rows.reserve(posting.count);
+
+    int row = -1;
+    quint32 delta = 0;
+    int shift = 0;
+    for (char byte : posting.deltas) {
+        quint8 value = static_cast<quint8>(byte);
+        delta |= quint32(value & 0x7F) << shift;
+        if (value & 0x80) {
+            shift += 7;
+            continue;
+        }
+
+        row += static_cast<int>(delta);
+        rows.append(row);
+        delta = 0;
+        shift = 0;
+    }
+    return rows;
+}
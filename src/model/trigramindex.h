@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include <common/zprobescheduler.h>
+
+#include "columntablestore.h"
+
+/**
+ * @brief Trigram index over the cells of a ColumnTableStore
+ *
+ * Maps every three character sequence of the case folded cell text to the rows
+ * containing it, so a substring search only verifies the rows that have all
+ * trigrams of the search text. Row lists are delta encoded varints.
+ * Dictionary columns are not indexed, their few distinct values are tested
+ * directly. The index describes the rows it was built from, any change of the
+ * store needs a new one.
+ */
+class TrigramIndex
+{
+public:
+    // Null if the token was canceled while building
+    static QSharedPointer<const TrigramIndex> build(const ColumnTableStore &store,
+                                                    const ZProbeScheduler::CancelToken &token = ZProbeScheduler::CancelToken());
+
+    int rowCount() const;
+    int columnCount() const;
+    bool isIndexed(int column) const;
+
+    /**
+     * @brief Rows that may contain text in one of the indexed columns
+     * @param rows Ascending candidates, a superset of the rows with a match
+     * @return false if text is shorter than a trigram, the index can not narrow it
+     */
+    bool candidates(const QString &text, QVector<int> *rows) const;
+
+    // Approximate heap size of the row lists
+    qint64 memoryUsage() const;
+
+private:
+    struct Posting {
+        QByteArray deltas;
+        int count = 0;
+        int lastRow = -1;
+    };
+
+    TrigramIndex();
+
+    void addText(const QString &text, int row);
+    static QVector<int> decode(const Posting &posting);
+
+private:
+    int m_rowCount;
+    QVector<bool> m_indexed;
+    QHash<quint64, Posting> m_postings;
+};
+
+#endif // TRIGRAMINDEX_H
@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "aggregationwg.h"
+#include "ui_aggregationwg.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QHeaderView>
+#include <QTableWidgetItem>
+#include <QDebug>
+
+#include <cmath>
+#include <numeric>
+
+#include <common/qtcompat.h>
+#include <common/zprobescheduler.h>
+
+#define AGGREGATION_MAX_ROWS 10000  // result rows shown, the status tells how many more there are
+
+namespace {
+
+QTableWidgetItem *numberItem(double value)
+{
+    auto *item = new QTableWidgetItem();
+    // whole numbers without an exponent, the items still sort numerically
+    if (std::floor(value) == value && std::fabs(value) < 9007199254740992.0) {
+        item->setData(Qt::DisplayRole, static_cast<qlonglong>(value));
+    } else {
+        item->setData(Qt::DisplayRole, value);
+    }
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+}
+
+AggregationWG::AggregationWG(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::AggregationWG)
+    , m_generation(0)
+    , m_hasResult(false)
+{
+    ui->setupUi(this);
+
+    m_groupByLayout = new ZFlowLayout();
+    ui->group_by_gbox->setLayout(m_groupByLayout);
+
+    m_valueLayout = new ZFlowLayout();
+    ui->value_gbox->setLayout(m_valueLayout);
+
+    ui->result_tw->verticalHeader()->setVisible(false);
+    ui->result_tw->horizontalHeader()->setSectionsMovable(true);
+}
+
+AggregationWG::~AggregationWG()
+{
+    ZProbeScheduler::instance().cancel(this);
+    delete ui;
+}
+
+void AggregationWG::setSourceModels(MediaInfoTabelModel *model, MultiColumnSearchProxyModel *proxy)
+{
+    m_model = model;
+    m_proxy = proxy;
+}
+
+void AggregationWG::setColumns(const QStringList &headers)
+{
+    if (headers == m_headers) {
+        return;
+    }
+
+    m_headers = headers;
+    setCheckBoxes(m_groupByLayout, m_groupByCBoxes, headers);
+    setCheckBoxes(m_valueLayout, m_valueCBoxes, headers);
+}
+
+bool AggregationWG::hasResult() const
+{
+    return m_hasResult;
+}
+
+void AggregationWG::compute()
+{
+    if (!m_model || m_model->isPaged()) {
+        ui->status_lb->setText(tr("Not available for paged tables"));
+        return;
+    }
+
+    TableAggregator aggregator;
+    aggregator.setGroupColumns(checkedColumns(m_groupByCBoxes));
+    aggregator.setValueColumns(checkedColumns(m_valueCBoxes));
+    aggregator.setPercentiles(percentiles());
+    aggregator.setHistogramBins(ui->histogram_bins_sb->value());
+
+    // implicitly shared snapshot, edits on the GUI thread detach from it
+    ColumnTableStore store = m_model->store();
+
+    // same rows as the view: the last search result, or every row
+    QVector<int> rows;
+    if (m_proxy && m_proxy->hasMatchedRows()) {
+        rows = m_proxy->matchedRows();
+    } else {
+        rows.resize(store.rowCount());
+        std::iota(rows.begin(), rows.end(), 0);
+    }
+
+    int generation = ++m_generation;
+    QStringList headers = m_headers;
+    QPointer<AggregationWG> guard(this);
+    ui->status_lb->setText(tr("Computing..."));
+
+    // a newer computation of this panel cancels the running one
+    ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, aggregator, store, rows, headers, generation]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        QVector<TableAggregator::Group> groups;
+        if (!aggregator.aggregate(store, rows, &groups, ZProbeScheduler::currentToken())) {
+            return;
+        }
+
+        qint64 rowCount = rows.size();
+        qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(qApp, [guard, generation, groups, aggregator, headers, rowCount, elapsed]() {
+            if (guard) {
+                guard->onAggregated(generation, groups, aggregator, headers, rowCount, elapsed);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AggregationWG::on_compute_btn_clicked()
+{
+    compute();
+}
+
+void AggregationWG::setCheckBoxes(ZFlowLayout *layout, QList<QCheckBox *> &checkBoxes, const QStringList &headers)
+{
+    QStringList checked;
+    for (auto *checkBox : checkBoxes) {
+        if (checkBox->isChecked()) {
+            checked.append(checkBox->text());
+        }
+        layout->removeWidget(checkBox);
+        checkBox->deleteLater();
+    }
+    checkBoxes.clear();
+
+    for (const QString &header : headers) {
+        auto *checkBox = new QCheckBox(header, this);
+        checkBox->setChecked(checked.contains(header));
+        checkBoxes.append(checkBox);
+        layout->addWidget(checkBox);
+    }
+
+    layout->update();
+}
+
+QList<int> AggregationWG::checkedColumns(const QList<QCheckBox *> &checkBoxes) const
+{
+    QList<int> columns;
+    for (int i = 0; i < checkBoxes.size(); ++i) {
+        if (checkBoxes.at(i)->isChecked()) {
+            columns.append(i);
+        }
+    }
+    return columns;
+}
+
+QVector<double> AggregationWG::percentiles() const
+{
+    QVector<double> values;
+    const QStringList parts = ui->percentiles_le->text().split(',', QT_SKIP_EMPTY_PARTS);
+    for (const QString &part : parts) {
+        bool ok = false;
+        double value = part.trimmed().toDouble(&ok);
+        if (ok && value >= 0 && value <= 100) {
+            values.append(value);
+        } else {
+            qWarning() << "Ignoring invalid percentile:" << part;
+        }
+    }
+    return values;
+}
+
+void AggregationWG::onAggregated(int generation, const QVector<TableAggregator::Group> &groups,
+                                 const TableAggregator &aggregator, const QStringList &headers,
+                                 qint64 rowCount, qint64 elapsed)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    QList<int> groupColumns = aggregator.groupColumns();
+    QList<int> valueColumns = aggregator.valueColumns();
+    QVector<double> percentiles = aggregator.percentiles();
+    bool histogram = aggregator.histogramBins() > 0;
+
+    QStringList labels;
+    for (int col : groupColumns) {
+        labels.append(headers.value(col));
+    }
+    labels.append(tr("Rows"));
+    if (!valueColumns.isEmpty()) {
+        labels << tr("Column") << tr("Count") << tr("Sum") << tr("Min") << tr("Max") << tr("Mean");
+        for (double percentile : percentiles) {
+            labels.append(QString("P%1").arg(percentile));
+        }
+        if (histogram) {
+            labels.append(tr("Histogram"));
+        }
+    }
+
+    // one line per group and value column
+    int lineCount = 0;
+    for (const TableAggregator::Group &group : groups) {
+        lineCount += qMax(1, group.columns.size());
+    }
+    int shownLines = qMin(lineCount, AGGREGATION_MAX_ROWS);
+
+    ui->result_tw->setSortingEnabled(false);
+    ui->result_tw->clear();
+    ui->result_tw->setColumnCount(labels.size());
+    ui->result_tw->setHorizontalHeaderLabels(labels);
+    ui->result_tw->setRowCount(shownLines);
+
+    int line = 0;
+    for (const TableAggregator::Group &group : groups) {
+        int statsCount = qMax(1, group.columns.size());
+        for (int s = 0; s < statsCount && line < shownLines; ++s, ++line) {
+            int col = 0;
+            for (const QString &key : group.keys) {
+                ui->result_tw->setItem(line, col++, new QTableWidgetItem(key));
+            }
+            ui->result_tw->setItem(line, col++, numberItem(group.rowCount));
+
+            if (group.columns.isEmpty()) {
+                continue;
+            }
+
+            const TableAggregator::ColumnStats &stats = group.columns.at(s);
+            ui->result_tw->setItem(line, col++, new QTableWidgetItem(headers.value(stats.column)));
+            ui->result_tw->setItem(line, col++, numberItem(stats.count));
+            if (stats.numberCount == 0) {
+                // text columns are only counted
+                continue;
+            }
+
+            ui->result_tw->setItem(line, col++, numberItem(stats.sum));
+            ui->result_tw->setItem(line, col++, numberItem(stats.min));
+            ui->result_tw->setItem(line, col++, numberItem(stats.max));
+            ui->result_tw->setItem(line, col++, numberItem(stats.mean));
+            for (double value : stats.percentiles) {
+                ui->result_tw->setItem(line, col++, numberItem(value));
+            }
+            if (histogram) {
+                auto *item = new QTableWidgetItem(histogramText(stats.histogram));
+                QStringList bins;
+                for (qint64 count : stats.histogram) {
+                    bins.append(QString::number(count));
+                }
+                item->setToolTip(tr("%1 .. %2: %3").arg(stats.min).arg(stats.max).arg(bins.join(' ')));
+                ui->result_tw->setItem(line, col++, item);
+            }
+        }
+    }
+
+    ui->result_tw->setSortingEnabled(true);
+    ui->result_tw->resizeColumnsToContents();
+
+    QString status = tr("%1 groups over %2 rows in %3 ms").arg(groups.size()).arg(rowCount).arg(elapsed);
+    if (shownLines < lineCount) {
+        status += tr(", first %1 of %2 lines shown").arg(shownLines).arg(lineCount);
+    }
+    ui->status_lb->setText(status);
+    m_hasResult = true;
+}
+
+QString AggregationWG::histogramText(const QVector<qint64> &histogram)
+{
+    static const QString bars = QString::fromUtf8("▁▂▃▄▅▆▇█");
+
+    qint64 peak = 0;
+    for (qint64 count : histogram) {
+        peak = qMax(peak, count);
+    }
+
+    QString text;
+    for (qint64 count : histogram) {
+        if (count == 0 || peak == 0) {
+            text.append(' ');
+        } else {
+            text.append(bars.at(static_cast<int>((count * (bars.size() - 1)) / peak)));
+        }
+    }
+    return text;
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef AGGREGATIONWG_H
+#define AGGREGATIONWG_H
+
+#include <QWidget>
+#include <QCheckBox>
+#include <QPointer>
+#include <QStringList>
+
+#include <common/zflowlayout.h>
+
+#include <model/mediainfotabelmodel.h>
+#include <model/multicolumnsearchproxymodel.h>
+#include <model/tableaggregator.h>
+
+namespace Ui {
+class AggregationWG;
+}
+
+/**
+ * @brief Group-by statistics panel of the info tables
+ *
+ * Count, sum, min/max, mean, percentiles and histograms of the checked value
+ * columns, per distinct combination of the checked group columns. Only the
+ * rows matched by the current search are aggregated, the work runs as a
+ * TableAggregator job on ZProbeScheduler.
+ */
+class AggregationWG : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit AggregationWG(QWidget *parent = nullptr);
+    ~AggregationWG();
+
+    // Rows are read from the model's column store, the proxy limits them to its search result
+    void setSourceModels(MediaInfoTabelModel *model, MultiColumnSearchProxyModel *proxy);
+
+    // Columns offered for grouping and values, checked names stay checked
+    void setColumns(const QStringList &headers);
+
+    bool hasResult() const;
+
+public slots:
+    void compute();
+
+private slots:
+    void on_compute_btn_clicked();
+
+private:
+    void setCheckBoxes(ZFlowLayout *layout, QList<QCheckBox *> &checkBoxes, const QStringList &headers);
+    QList<int> checkedColumns(const QList<QCheckBox *> &checkBoxes) const;
+    QVector<double> percentiles() const;
+
+    void onAggregated(int generation, const QVector<TableAggregator::Group> &groups,
+                      const TableAggregator &aggregator, const QStringList &headers, qint64 rowCount, qint64 elapsed);
+    static QString histogramText(const QVector<qint64> &histogram);
+
+private:
+    Ui::AggregationWG *ui;
+
+    ZFlowLayout *m_groupByLayout;
+    ZFlowLayout *m_valueLayout;
+    QList<QCheckBox *> m_groupByCBoxes;
+    QList<QCheckBox *> m_valueCBoxes;
+    QStringList m_headers;
+
+    QPointer<MediaInfoTabelModel> m_model;
+    QPointer<MultiColumnSearchProxyModel> m_proxy;
+    int m_generation;
+    bool m_hasResult;
+};
+
+#endif // AGGREGATIONWG_H
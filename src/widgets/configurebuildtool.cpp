@@ -172,7 +172,7 @@ QString ConfigureBuildTool::getConfigCmd()
 {
     QString cmd = "./configure \\\n";
 
-    for (auto it: *ui->select_option_tb->getTableData()) {
+    for (auto it: ui->select_option_tb->getTableData()) {
         QStringList optionList = it.at(0).split("=", QT_SKIP_EMPTY_PARTS);
 
         QString value = it.at(2);
@@ -10,8 +10,19 @@
 #include <QClipboard>
 #include <QMetaObject>
 #include <QItemSelectionRange>
+#include <QScrollBar>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPointer>
+#include <QMessageBox>
+#include <QToolTip>
 #include "progressdlg.h"
 
+#define COLUMN_WIDTH_SAMPLE_ROWS 64     // rows measured per column, spread over the whole table
+#define COLUMN_WIDTH_MIN 50
+#define COLUMN_WIDTH_MAX 480            // long text columns are left to the stretch or the user
+#define COLUMN_WIDTH_PADDING 24         // cell margins and the sort indicator
+
 InfoWidgets::InfoWidgets(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::InfoWidgets)
@@ -26,14 +37,18 @@ InfoWidgets::InfoWidgets(QWidget *parent)
     , m_copyAllDataAction(nullptr)
     , m_copyAllDataWithHeaderAction(nullptr)
     , m_detailSearchDialog(nullptr)
+    , m_aggregationDialog(nullptr)
+    , m_aggregationAction(nullptr)
+    , m_rawView(nullptr)
+    , m_rawModel(nullptr)
     , m_copyProgressDialog(nullptr)
     , m_tableContextMenu(new QMenu(this))
     , m_isUserAdjusted(false)
+    , m_applyingColumnWidths(false)
     , m_resizeTimer(new QTimer(this))
     , m_lastTableWidth(0)
 {
     ui->setupUi(this);
-    ui->detail_raw_pte->setVisible(false);
 
     // Setup context menu for table
     setupContextMenu();
@@ -51,7 +66,11 @@ InfoWidgets::InfoWidgets(QWidget *parent)
 
     connect(m_model, &QAbstractItemModel::dataChanged, this,
             [=](const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles) {
-                emit dataChanged(m_data_tb.at(topLeft.row()));
+                // paged models report loaded pages here, not edits
+                if (m_model->isPaged()) {
+                    return;
+                }
+                emit dataChanged(m_model->rowData(topLeft.row()));
             });
 }
 
@@ -59,6 +78,7 @@ InfoWidgets::~InfoWidgets()
 {
     delete m_headerManager;
     delete m_detailSearchDialog;
+    delete m_aggregationDialog;
     delete m_copyProgressDialog;
     delete ui;
 }
@@ -96,15 +116,9 @@ void InfoWidgets::addContextSeparator()
 QList<QStringList> InfoWidgets::getSelectLines()
 {
     QList<QStringList> tmp;
-    QSet<int> availableRow;
-    QModelIndexList selectedRows = ui->detail_tb->selectionModel()->selectedIndexes();
-    foreach (const QModelIndex &it, selectedRows) {
-        auto index = multiColumnSearchModel->mapToSource(it);
-        availableRow.insert(index.row());
-    }
-
-    foreach (auto &row, availableRow) {
-        tmp.append(m_data_tb.at(row));
+    const QVector<int> rows = selectedSourceRows();
+    for (int row : rows) {
+        tmp.append(m_model->rowData(row));
     }
 
     return tmp;
@@ -113,23 +127,49 @@ QList<QStringList> InfoWidgets::getSelectLines()
 QList<int> InfoWidgets::getSelectRows()
 {
     QList<int> tmp;
-    QSet<int> availableRow;
-    QModelIndexList selectedRows = ui->detail_tb->selectionModel()->selectedIndexes();
-    foreach (const QModelIndex &it, selectedRows) {
-        auto index = multiColumnSearchModel->mapToSource(it);
-        availableRow.insert(index.row());
-    }
-
-    foreach (auto &row, availableRow) {
+    const QVector<int> rows = selectedSourceRows();
+    for (int row : rows) {
         tmp.append(row);
     }
 
     return tmp;
 }
 
-const QList<QStringList> *InfoWidgets::getTableData()
+QList<QStringList> InfoWidgets::getTableData()
+{
+    return m_model->store().rows();
+}
+
+int InfoWidgets::rowCount() const
+{
+    return m_model->rowCount();
+}
+
+QStringList InfoWidgets::rowData(int row) const
 {
-    return &m_data_tb;
+    return m_model->rowData(row);
+}
+
+const ColumnTableStore &InfoWidgets::tableStore() const
+{
+    return m_model->store();
+}
+
+bool InfoWidgets::isPaged() const
+{
+    return m_model->isPaged();
+}
+
+bool InfoWidgets::selectSourceRow(int row)
+{
+    QModelIndex index = multiColumnSearchModel->mapFromSource(m_model->index(row, 0));
+    if (!index.isValid()) {
+        return false;
+    }
+
+    ui->detail_tb->selectRow(index.row());
+    ui->detail_tb->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    return true;
 }
 
 void InfoWidgets::on_search_btn_clicked()
@@ -144,6 +184,7 @@ void InfoWidgets::clear_detail_tb()
 
 void InfoWidgets::init_header_detail_tb(const QStringList &headers, QString format_join)
 {
+    setPagedControls(false);
     m_headers = headers;
     
     m_model->setColumn(m_headers.count());
@@ -152,16 +193,38 @@ void InfoWidgets::init_header_detail_tb(const QStringList &headers, QString form
     // Initial resize mode will be set in setupInitialColumnWidths()
     m_headerManager->restoreState();
 
-    ui->detail_raw_pte->clear();
-    ui->detail_raw_pte->appendPlainText(m_headers.join(format_join));
+    setRawSeparator(format_join);
 }
 
-void InfoWidgets::update_data_detail_tb(const QList<QStringList> &data_tb, QString format_join)
+void InfoWidgets::init_paged_detail_tb(const QStringList &headers, int pageCount,
+                                       const MediaInfoTabelModel::PageLoader &loader, QString format_join)
 {
-    m_data_tb = data_tb;
+    setPagedControls(true);
+
+    m_headers = headers;
+    m_model->setPagedSource(m_headers, pageCount, loader);
+
+    if (!ui->detail_tb->model()) {
+        ui->detail_tb->setModel(multiColumnSearchModel);
+    }
+    multiColumnSearchModel->resetFilters();
+
+    ui->detail_tb->setShowGrid(true);
+    m_headerManager->restoreState();
+
+    setRawSeparator(format_join);
 
-    m_model->setRow(m_data_tb.count());
-    m_model->setTableData(const_cast<QList<QStringList>*>(&m_data_tb));
+    updateCurrentModel();
+
+    // first page, the view asks for more pages while it scrolls down
+    if (m_model->canFetchMore(QModelIndex())) {
+        m_model->fetchMore(QModelIndex());
+    }
+}
+
+void InfoWidgets::update_data_detail_tb(const QList<QStringList> &data_tb, QString format_join)
+{
+    m_model->setTableData(data_tb);
 
     if (!ui->detail_tb->model()) {
         ui->detail_tb->setModel(multiColumnSearchModel);
@@ -174,10 +237,7 @@ void InfoWidgets::update_data_detail_tb(const QList<QStringList> &data_tb, QStri
     if (m_headers.size() > 0) {
         setupInitialColumnWidths();
     }
-    ui->detail_raw_pte->clear();
-    for (auto it : m_data_tb) {
-        ui->detail_raw_pte->appendPlainText(it.join(format_join));
-    }
+    setRawSeparator(format_join);
 
     QTimer::singleShot(50, this, [this]() {
         resizeColumnsProportionally();
@@ -186,13 +246,12 @@ void InfoWidgets::update_data_detail_tb(const QList<QStringList> &data_tb, QStri
 
 void InfoWidgets::update_data_detail_tb(const QMap<QString, QList<QStringList> > &data_tb, QString format_join)
 {
-    m_data_tb.clear();
+    QList<QStringList> rows;
     for (auto key: data_tb.keys()) {
-        m_data_tb.append(data_tb.value(key));
+        rows.append(data_tb.value(key));
     }
 
-    m_model->setRow(m_data_tb.count());
-    m_model->setTableData(const_cast<QList<QStringList>*>(&m_data_tb));
+    m_model->setTableData(rows);
 
     if (!ui->detail_tb->model()) {
         ui->detail_tb->setModel(multiColumnSearchModel);
@@ -205,27 +264,46 @@ void InfoWidgets::update_data_detail_tb(const QMap<QString, QList<QStringList> >
     if (m_headers.size() > 0) {
         setupInitialColumnWidths();
     }
-    ui->detail_raw_pte->clear();
-    for (auto it : m_data_tb) {
-        ui->detail_raw_pte->appendPlainText(it.join(format_join));
+    setRawSeparator(format_join);
+}
+
+void InfoWidgets::update_store_detail_tb(const ColumnTableStore &store, QString format_join)
+{
+    m_model->setTableStore(store);
+
+    if (!ui->detail_tb->model()) {
+        ui->detail_tb->setModel(multiColumnSearchModel);
+    }
+
+    ui->detail_tb->setShowGrid(true);
+
+    updateCurrentModel();
+
+    if (m_headers.size() > 0) {
+        setupInitialColumnWidths();
     }
+    setRawSeparator(format_join);
+
+    QTimer::singleShot(50, this, [this]() {
+        resizeColumnsProportionally();
+    });
 }
 
 void InfoWidgets::remove_data_from_row_indexs(const QList<int> &indexs)
 {
-    QList<int> sortedRows = indexs;
-    std::sort(sortedRows.begin(), sortedRows.end(), std::greater<int>());
-    foreach (int row, sortedRows) {
-        m_data_tb.removeAt(row);
-    }
+    m_model->removeRowList(indexs.toVector());
 }
 
 void InfoWidgets::append_data_detail_tb(const QList<QStringList> &data_tb, QString format_join)
 {
-    m_data_tb.append(data_tb);
+    if (data_tb.isEmpty()) {
+        return;
+    }
 
-    m_model->setRow(m_data_tb.count());
-    m_model->setTableData(const_cast<QList<QStringList>*>(&m_data_tb));
+    bool firstRows = m_model->rowCount() == 0;
+
+    // Insert only the new rows, streamed tables append many small batches
+    m_model->appendTableData(data_tb);
 
     if (!ui->detail_tb->model()) {
         ui->detail_tb->setModel(multiColumnSearchModel);
@@ -235,33 +313,20 @@ void InfoWidgets::append_data_detail_tb(const QList<QStringList> &data_tb, QStri
 
     updateCurrentModel();
 
-    if (m_headers.size() > 0) {
+    if (firstRows && m_headers.size() > 0) {
         setupInitialColumnWidths();
     }
-    ui->detail_raw_pte->clear();
-    for (auto it : m_data_tb) {
-        ui->detail_raw_pte->appendPlainText(it.join(format_join));
-    }
+    setRawSeparator(format_join);
 }
 
-void InfoWidgets::remove_selected_row()
+void InfoWidgets::append_header_detail_tb(const QStringList &headers)
 {
-    QSet<int> availableRow;
-    QModelIndexList selectedRows = ui->detail_tb->selectionModel()->selectedIndexes();
-    foreach (const QModelIndex &index, selectedRows) {
-        availableRow.insert(index.row());
-    }
-
-    QList<int> rowsToDelete = availableRow.values();
-    std::sort(rowsToDelete.begin(), rowsToDelete.end(), std::greater<int>());
-
-    foreach (int row, rowsToDelete) {
-        if (row >= 0 && row < m_data_tb.size()) {
-            m_data_tb.removeAt(row);
-        }
-    }
+    m_model->appendTableHeader(headers);
+}
 
-    m_model->setRow(m_data_tb.count());
+void InfoWidgets::remove_selected_row()
+{
+    m_model->removeRowList(selectedSourceRows());
 }
 
 void InfoWidgets::format_data(const QString &data, QList<QStringList> &data_tb, QStringList &headers, QString format_key)
@@ -483,15 +548,109 @@ void InfoWidgets::format_data(const QString &data, QList<QStringList> &data_tb,
 
 void InfoWidgets::init_detail_tb(const QString &data, const QString& format_key)
 {
-    format_data(data, m_data_tb, m_headers, format_key);
+    QList<QStringList> rows;
+    format_data(data, rows, m_headers, format_key);
 
     init_header_detail_tb(m_headers);
-    update_data_detail_tb(m_data_tb);
+    update_data_detail_tb(rows);
 }
 
 void InfoWidgets::on_expand_raw_btn_clicked(bool checked)
 {
-    ui->detail_raw_pte->setVisible(checked);
+    if (checked && !m_rawView) {
+        createRawView();
+    }
+    if (m_rawView) {
+        m_rawView->setVisible(checked);
+    }
+}
+
+void InfoWidgets::createRawView()
+{
+    // lines are joined from the model when they are painted, nothing is copied
+    m_rawModel = new RawTextModel(this);
+    m_rawModel->setSeparator(m_formatJoin);
+    m_rawModel->setSourceModel(m_model);
+
+    m_rawView = new QListView(this);
+    m_rawView->setModel(m_rawModel);
+    m_rawView->setUniformItemSizes(true);
+    m_rawView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_rawView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_rawView->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    m_rawView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    ui->verticalLayout->addWidget(m_rawView);
+
+    // copy the selected lines in their table order
+    auto *copyShortcut = new QShortcut(QKeySequence::Copy, m_rawView);
+    copyShortcut->setContext(Qt::WidgetShortcut);
+    connect(copyShortcut, &QShortcut::activated, this, &InfoWidgets::copyRawSelection);
+}
+
+void InfoWidgets::copyRawSelection()
+{
+    // line spans of the selection ranges, not one index per selected line
+    QVector<QPair<int, int>> spans;
+    const QItemSelection selection = m_rawView->selectionModel()->selection();
+    for (const QItemSelectionRange &range : selection) {
+        spans.append(qMakePair(range.top(), range.bottom()));
+    }
+    std::sort(spans.begin(), spans.end());
+
+    // line 0 is the header, line r + 1 source row r
+    bool header = false;
+    QVector<int> rows;
+    int next = 0;
+    for (const auto &span : qAsConst(spans)) {
+        for (int line = qMax(span.first, next); line <= span.second; ++line) {
+            if (line == 0) {
+                header = true;
+            } else {
+                rows.append(line - 1);
+            }
+        }
+        next = qMax(next, span.second + 1);
+    }
+
+    if (m_model->isPaged()) {
+        // only the pages around the view are in memory, missing ones are requested
+        QStringList lines;
+        int loading = 0;
+        if (header) {
+            lines.append(m_rawModel->lineText(0));
+        }
+        for (int row : qAsConst(rows)) {
+            if (m_model->ensureRowLoaded(row)) {
+                lines.append(m_rawModel->lineText(row + 1));
+            } else {
+                ++loading;
+            }
+        }
+        if (loading > 0) {
+            QMessageBox::information(this, tr("Copy"),
+                                     tr("%1 selected lines are still loading, copy again once they are shown.").arg(loading));
+            return;
+        }
+        QApplication::clipboard()->setText(lines.join('\n'));
+        return;
+    }
+
+    if (rows.isEmpty()) {
+        // an empty row list would copy every row
+        if (header) {
+            QApplication::clipboard()->setText(m_rawModel->lineText(0));
+        }
+        return;
+    }
+    startCopy(rows, QList<int>(), header, tr("Preparing to copy selected lines..."), m_formatJoin);
+}
+
+void InfoWidgets::setRawSeparator(const QString &separator)
+{
+    m_formatJoin = separator;
+    if (m_rawModel) {
+        m_rawModel->setSeparator(separator);
+    }
 }
 
 void InfoWidgets::on_search_le_editingFinished()
@@ -531,6 +690,7 @@ void InfoWidgets::createDetailSearchDialog()
         // Configure to show only the required group boxes for InfoWidgets
         auto requiredBoxes = SearchWG::SearchRange | SearchWG::MatchControl | SearchWG::Operation;
         m_detailSearchDialog->setVisibleGroupBoxes(requiredBoxes);
+        m_detailSearchDialog->setFilterExpressionVisible(true);
         
         // Set search range options based on current table headers
         if (!m_headers.isEmpty()) {
@@ -554,6 +714,29 @@ void InfoWidgets::createDetailSearchDialog()
     }
 }
 
+void InfoWidgets::createAggregationDialog()
+{
+    if (!m_aggregationDialog) {
+        m_aggregationDialog = new AggregationWG(this);
+        m_aggregationDialog->setWindowTitle(tr("Aggregation"));
+        m_aggregationDialog->setWindowFlags(Qt::Dialog | Qt::WindowCloseButtonHint);
+        m_aggregationDialog->setSourceModels(m_model, multiColumnSearchModel);
+        m_aggregationDialog->setMinimumWidth(600);
+    }
+}
+
+void InfoWidgets::showAggregation()
+{
+    createAggregationDialog();
+
+    // Offer the current table columns
+    m_aggregationDialog->setColumns(m_headers);
+
+    m_aggregationDialog->show();
+    m_aggregationDialog->raise();
+    m_aggregationDialog->activateWindow();
+}
+
 void InfoWidgets::showDetailSearch()
 {
     // Show search title
@@ -593,6 +776,7 @@ void InfoWidgets::onDetailSearchCompleted()
     multiColumnSearchModel->setCaseSensitive(m_detailSearchDialog->isCaseSensitive());
     multiColumnSearchModel->setMatchWholeWords(m_detailSearchDialog->isMatchWholewords());
     multiColumnSearchModel->setUseRegularExpression(m_detailSearchDialog->isUseRegularExpression());
+    multiColumnSearchModel->setUseFilterExpression(m_detailSearchDialog->isUseFilterExpression());
     
     // Configure search columns
     if (selectedRanges.isEmpty()) {
@@ -618,478 +802,195 @@ void InfoWidgets::updateCurrentModel()
     m_headerManager->updateTotalCount(multiColumnSearchModel->rowCount());
 }
 
-QString InfoWidgets::getSelectedText(bool includeHeader)
+QVector<int> InfoWidgets::selectedSourceRows() const
 {
-    QModelIndexList selected = ui->detail_tb->selectionModel()->selectedIndexes();
-    if (selected.isEmpty()) {
-        return QString();
+    QVector<int> rows;
+    if (!ui->detail_tb->selectionModel()) {
+        return rows;
     }
 
-    QString text;
-    QItemSelectionRange range = ui->detail_tb->selectionModel()->selection().first();
-
-    if (includeHeader) {
-        QStringList headerContents;
-        for (int j = range.left(); j <= range.right(); ++j) {
-            int sourceColumn = j;
-            if (ui->detail_tb->model() == multiColumnSearchModel) {
-                sourceColumn = j;
-            }
-            
-            if (sourceColumn >= 0 && sourceColumn < m_headers.size()) {
-                headerContents << m_headers.at(sourceColumn);
-            } else {
-                headerContents << ui->detail_tb->model()->headerData(j, Qt::Horizontal).toString();
-            }
-        }
-        text += headerContents.join("\t") + "\n";
+    // row spans of the selection ranges, not one index per selected cell
+    QVector<QPair<int, int>> spans;
+    const QItemSelection selection = ui->detail_tb->selectionModel()->selection();
+    for (const QItemSelectionRange &range : selection) {
+        spans.append(qMakePair(range.top(), range.bottom()));
     }
-
-    for (int i = range.top(); i <= range.bottom(); ++i) {
-        QStringList rowContents;
-        for (int j = range.left(); j <= range.right(); ++j) {
-            rowContents << ui->detail_tb->model()->index(i,j).data().toString();
+    std::sort(spans.begin(), spans.end());
+
+    // the proxy only filters, source rows ascend with the proxy rows
+    bool filtered = multiColumnSearchModel->rowCount() != m_model->rowCount();
+    int next = 0;
+    for (const auto &span : qAsConst(spans)) {
+        for (int row = qMax(span.first, next); row <= span.second; ++row) {
+            rows.append(filtered ? multiColumnSearchModel->mapToSource(multiColumnSearchModel->index(row, 0)).row() : row);
         }
-        text += rowContents.join("\t") + "\n";
+        next = qMax(next, span.second + 1);
     }
 
-    return text;
+    return rows;
 }
 
-void InfoWidgets::on_search_le_textChanged(const QString &arg1)
+QList<int> InfoWidgets::selectedColumns() const
 {
-    if (m_detailSearchDialog) {
-        m_detailSearchDialog->setSearchText(arg1);
+    QList<int> columns;
+    if (!ui->detail_tb->selectionModel()) {
+        return columns;
     }
-}
 
-void InfoWidgets::copySelectedText()
-{
-    QString text = getSelectedText(false);
-    if (!text.isEmpty()) {
-        // Create progress dialog for consistency
-        m_copyProgressDialog = new ProgressDialog(this);
-        m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-        m_copyProgressDialog->setMessage(tr("Preparing to copy selected text..."));
-        m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
-        m_copyProgressDialog->setAutoClose(true);
-        m_copyProgressDialog->setCancelButtonVisible(true);
-
-        m_copyProgressDialog->start();
-        
-        // Use QtConcurrent::run for non-blocking operation
-        QtConcurrent::run([this, text]() {
-            // Copy text directly
-            QApplication::clipboard()->setText(text);
-
-            // Update progress and finish in main thread
-            QMetaObject::invokeMethod(this, [this]() {
-                if (m_copyProgressDialog) {
-                    m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                    m_copyProgressDialog->toFinish();
-                    m_copyProgressDialog->deleteLater();
-                    m_copyProgressDialog = nullptr;
-                }
-            }, Qt::QueuedConnection);
-        });
+    QVector<bool> selected(m_model->columnCount(), false);
+    const QItemSelection selection = ui->detail_tb->selectionModel()->selection();
+    for (const QItemSelectionRange &range : selection) {
+        for (int col = range.left(); col <= range.right() && col < selected.size(); ++col) {
+            selected[col] = true;
+        }
+    }
 
-        m_copyProgressDialog->exec();
+    for (int col = 0; col < selected.size(); ++col) {
+        if (selected.at(col)) {
+            columns.append(col);
+        }
     }
+
+    return columns;
 }
 
-void InfoWidgets::copySelectedTextWithHeader()
+void InfoWidgets::startCopy(const QVector<int> &rows, const QList<int> &columns, bool includeHeader, const QString &message,
+                            const QString &separator)
 {
-    QString text = getSelectedText(true);
-    if (!text.isEmpty()) {
-        // Create progress dialog for consistency
-        m_copyProgressDialog = new ProgressDialog(this);
-        m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-        m_copyProgressDialog->setMessage(tr("Preparing to copy selected text with header..."));
-        m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
-        m_copyProgressDialog->setAutoClose(true);
-        m_copyProgressDialog->setCancelButtonVisible(true);
-
-        m_copyProgressDialog->start();
-        
-        // Use QtConcurrent::run for non-blocking operation
-        QtConcurrent::run([this, text]() {
-            // Copy text directly
-            QApplication::clipboard()->setText(text);
-
-            // Update progress and finish in main thread
-            QMetaObject::invokeMethod(this, [this]() {
-                if (m_copyProgressDialog) {
-                    m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                    m_copyProgressDialog->toFinish();
-                    m_copyProgressDialog->deleteLater();
-                    m_copyProgressDialog = nullptr;
-                }
-            }, Qt::QueuedConnection);
-        });
-
-        m_copyProgressDialog->exec();
+    QStringList header;
+    if (includeHeader) {
+        if (columns.isEmpty()) {
+            header = m_headers;
+        } else {
+            for (int col : columns) {
+                header.append(m_headers.value(col));
+            }
+        }
     }
-}
 
-void InfoWidgets::copySelectedRows()
-{
-    QSet<int> availableRows;
-    QModelIndexList selectedIndexes = ui->detail_tb->selectionModel()->selectedIndexes();
+    // the text is written from a snapshot of the store, edits detach from it
+    TableMimeData *mimeData = new TableMimeData(m_model->store(), rows, columns, header, separator);
 
-    foreach (const QModelIndex &index, selectedIndexes) {
-        auto sourceIndex = multiColumnSearchModel->mapToSource(index);
-        availableRows.insert(sourceIndex.row());
-    }
-    
-    if (availableRows.isEmpty()) {
-        return;
-    }
-    
-    QList<int> sortedRows = availableRows.values();
-    std::sort(sortedRows.begin(), sortedRows.end());
-    
     // Create progress dialog
     m_copyProgressDialog = new ProgressDialog(this);
     m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-    m_copyProgressDialog->setMessage(tr("Preparing to copy selected rows..."));
-    m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
+    m_copyProgressDialog->setMessage(message);
+    m_copyProgressDialog->setProgressMode(ProgressDialog::Determinate);
+    m_copyProgressDialog->setRange(0, 100);
+    m_copyProgressDialog->setValue(0);
     m_copyProgressDialog->setAutoClose(true);
     m_copyProgressDialog->setCancelButtonVisible(true);
 
     m_copyProgressDialog->start();
-    
-    // Use QtConcurrent::run for non-blocking operation
-    QtConcurrent::run([this, sortedRows]() {
-        // Prepare text
-        QString text;
-        text.reserve(sortedRows.size() * m_headers.size() * 20); // Pre-allocate memory
-        
-        foreach (int row, sortedRows) {
-            if (row >= 0 && row < m_data_tb.size()) {
-                text += m_data_tb.at(row).join("\t") + "\n";
-            }
-        }
 
-        // Copy text directly
-        QApplication::clipboard()->setText(text);
+    QPointer<InfoWidgets> guard(this);
+    QPointer<ProgressDialog> dialog(m_copyProgressDialog);
 
-        // Update progress and finish in main thread
-        QMetaObject::invokeMethod(this, [this]() {
-            if (m_copyProgressDialog) {
-                m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                m_copyProgressDialog->toFinish();
-                m_copyProgressDialog->deleteLater();
-                m_copyProgressDialog = nullptr;
+    // Serialize on a scheduler thread, the clipboard is only touched from the main thread
+    ZProbeScheduler::CancelToken token = ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, dialog, mimeData]() {
+        bool done = mimeData->serialize(ZProbeScheduler::currentToken(), [dialog](int percent) {
+            QMetaObject::invokeMethod(qApp, [dialog, percent]() {
+                if (dialog) {
+                    dialog->setValue(percent);
+                }
+            }, Qt::QueuedConnection);
+        });
+
+        QMetaObject::invokeMethod(qApp, [guard, mimeData, done]() {
+            if (!guard || !done) {
+                delete mimeData;
+                return;
+            }
+
+            QApplication::clipboard()->setMimeData(mimeData);
+            if (guard->m_copyProgressDialog) {
+                guard->m_copyProgressDialog->messageChanged(tr("Copy completed"));
+                guard->m_copyProgressDialog->toFinish();
+                guard->m_copyProgressDialog->deleteLater();
+                guard->m_copyProgressDialog = nullptr;
             }
         }, Qt::QueuedConnection);
+    }, [mimeData]() {
+        QMetaObject::invokeMethod(qApp, [mimeData]() {
+            delete mimeData;
+        }, Qt::QueuedConnection);
+    });
+
+    connect(m_copyProgressDialog, &ProgressDialog::canceled, this, [this, token]() {
+        ZProbeScheduler::cancel(token);
+        if (m_copyProgressDialog) {
+            m_copyProgressDialog->deleteLater();
+            m_copyProgressDialog = nullptr;
+        }
     });
 
     m_copyProgressDialog->exec();
 }
 
-void InfoWidgets::copySelectedRowsWithHeader()
+void InfoWidgets::on_search_le_textChanged(const QString &arg1)
 {
-    QSet<int> availableRows;
-    QModelIndexList selectedIndexes = ui->detail_tb->selectionModel()->selectedIndexes();
-    
-    // Get all selected row indexes
-    foreach (const QModelIndex &index, selectedIndexes) {
-        auto sourceIndex = multiColumnSearchModel->mapToSource(index);
-        availableRows.insert(sourceIndex.row());
-    }
-    
-    if (availableRows.isEmpty()) {
-        return;
+    if (m_detailSearchDialog) {
+        m_detailSearchDialog->setSearchText(arg1);
     }
-    
-    QList<int> sortedRows = availableRows.values();
-    std::sort(sortedRows.begin(), sortedRows.end());
-    
-    // Create progress dialog
-    m_copyProgressDialog = new ProgressDialog(this);
-    m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-    m_copyProgressDialog->setMessage(tr("Preparing to copy selected rows with headers..."));
-    m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
-    m_copyProgressDialog->setAutoClose(true);
-    m_copyProgressDialog->setCancelButtonVisible(true);
+}
 
-    m_copyProgressDialog->start();
-    
-    // Use QtConcurrent::run for non-blocking operation
-    QtConcurrent::run([this, sortedRows]() {
-        // Prepare text
-        QString text;
-        text.reserve((sortedRows.size() + 1) * m_headers.size() * 20); // Pre-allocate memory
-        
-        // Add headers
-        if (!m_headers.isEmpty()) {
-            text += m_headers.join("\t") + "\n";
-        }
-        
-        // Copy data in row order
-        foreach (int row, sortedRows) {
-            if (row >= 0 && row < m_data_tb.size()) {
-                text += m_data_tb.at(row).join("\t") + "\n";
-            }
-        }
+void InfoWidgets::copySelectedText()
+{
+    QVector<int> rows = selectedSourceRows();
+    if (!rows.isEmpty()) {
+        startCopy(rows, selectedColumns(), false, tr("Preparing to copy selected text..."));
+    }
+}
 
-        // Copy text directly
-        QApplication::clipboard()->setText(text);
+void InfoWidgets::copySelectedTextWithHeader()
+{
+    QVector<int> rows = selectedSourceRows();
+    if (!rows.isEmpty()) {
+        startCopy(rows, selectedColumns(), true, tr("Preparing to copy selected text with header..."));
+    }
+}
 
-        // Update progress and finish in main thread
-        QMetaObject::invokeMethod(this, [this]() {
-            if (m_copyProgressDialog) {
-                m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                m_copyProgressDialog->toFinish();
-                m_copyProgressDialog->deleteLater();
-                m_copyProgressDialog = nullptr;
-            }
-        }, Qt::QueuedConnection);
-    });
+void InfoWidgets::copySelectedRows()
+{
+    QVector<int> rows = selectedSourceRows();
+    if (!rows.isEmpty()) {
+        startCopy(rows, QList<int>(), false, tr("Preparing to copy selected rows..."));
+    }
+}
 
-    m_copyProgressDialog->exec();
+void InfoWidgets::copySelectedRowsWithHeader()
+{
+    QVector<int> rows = selectedSourceRows();
+    if (!rows.isEmpty()) {
+        startCopy(rows, QList<int>(), true, tr("Preparing to copy selected rows with headers..."));
+    }
 }
 
 void InfoWidgets::copySelectedColumns()
 {
-    // Get all selected indexes
-    QModelIndexList selectedIndexes = ui->detail_tb->selectionModel()->selectedIndexes();
-    if (selectedIndexes.isEmpty()) {
-        return;
-    }
-    
-    // Get all unique selected columns
-    QSet<int> selectedColumns;
-    foreach (const QModelIndex &index, selectedIndexes) {
-        auto sourceIndex = multiColumnSearchModel->mapToSource(index);
-        selectedColumns.insert(sourceIndex.column());
+    // every row of the selected columns
+    QList<int> columns = selectedColumns();
+    if (!columns.isEmpty()) {
+        startCopy(QVector<int>(), columns, false, tr("Preparing to copy selected columns..."));
     }
-    
-    if (selectedColumns.isEmpty()) {
-        return;
-    }
-    
-    // Sort columns for consistent order
-    QList<int> sortedColumns = selectedColumns.values();
-    std::sort(sortedColumns.begin(), sortedColumns.end());
-    
-    // Create progress dialog
-    m_copyProgressDialog = new ProgressDialog(this);
-    m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-    m_copyProgressDialog->setMessage(tr("Preparing to copy selected columns..."));
-    m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
-    m_copyProgressDialog->setAutoClose(true);
-    m_copyProgressDialog->setCancelButtonVisible(true);
-
-    m_copyProgressDialog->start();
-    
-    // Use QtConcurrent::run for non-blocking operation
-    QtConcurrent::run([this, sortedColumns]() {
-        // Prepare text
-        QString text;
-        text.reserve(m_data_tb.size() * sortedColumns.size() * 20); // Pre-allocate memory
-        
-        // Copy data for each selected column - optimized version
-        for (int row = 0; row < m_data_tb.size(); ++row) {
-            const QStringList &rowData = m_data_tb.at(row); // Use reference to avoid copying
-            for (int i = 0; i < sortedColumns.size(); ++i) {
-                if (i > 0) {
-                    text += '\t';
-                }
-                int column = sortedColumns.at(i);
-                if (column < rowData.size()) {
-                    text += rowData.at(column);
-                }
-            }
-            if (row < m_data_tb.size() - 1) {
-                text += '\n';
-            }
-        }
-        
-        // Copy text directly
-        QApplication::clipboard()->setText(text);
-
-        // Update progress and finish in main thread
-        QMetaObject::invokeMethod(this, [this]() {
-            if (m_copyProgressDialog) {
-                m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                m_copyProgressDialog->toFinish();
-                m_copyProgressDialog->deleteLater();
-                m_copyProgressDialog = nullptr;
-            }
-        }, Qt::QueuedConnection);
-    });
-
-    m_copyProgressDialog->exec();
 }
 
 void InfoWidgets::copySelectedColumnsWithHeader()
 {
-    // Get all selected indexes
-    QModelIndexList selectedIndexes = ui->detail_tb->selectionModel()->selectedIndexes();
-    if (selectedIndexes.isEmpty()) {
-        return;
+    QList<int> columns = selectedColumns();
+    if (!columns.isEmpty()) {
+        startCopy(QVector<int>(), columns, true, tr("Preparing to copy selected columns with headers..."));
     }
-    
-    // Get all unique selected columns
-    QSet<int> selectedColumns;
-    foreach (const QModelIndex &index, selectedIndexes) {
-        auto sourceIndex = multiColumnSearchModel->mapToSource(index);
-        selectedColumns.insert(sourceIndex.column());
-    }
-    
-    if (selectedColumns.isEmpty()) {
-        return;
-    }
-    
-    // Sort columns for consistent order
-    QList<int> sortedColumns = selectedColumns.values();
-    std::sort(sortedColumns.begin(), sortedColumns.end());
-    
-    // Create progress dialog
-    m_copyProgressDialog = new ProgressDialog(this);
-    m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-    m_copyProgressDialog->setMessage(tr("Preparing to copy selected columns with headers..."));
-    m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
-    m_copyProgressDialog->setAutoClose(true);
-    m_copyProgressDialog->setCancelButtonVisible(true);
-
-    m_copyProgressDialog->start();
-    
-    // Use QtConcurrent::run for non-blocking operation
-    QtConcurrent::run([this, sortedColumns]() {
-        // Prepare text
-        QString text;
-        text.reserve(m_headers.size() + m_data_tb.size() * sortedColumns.size() * 20); // Pre-allocate memory
-        
-        // Add headers for selected columns - optimized version
-        for (int i = 0; i < sortedColumns.size(); ++i) {
-            if (i > 0) {
-                text += '\t';
-            }
-            int column = sortedColumns.at(i);
-            if (column < m_headers.size()) {
-                text += m_headers.at(column);
-            }
-        }
-        text += '\n';
-        
-        // Copy data for each selected column - optimized version
-        for (int row = 0; row < m_data_tb.size(); ++row) {
-            const QStringList &rowData = m_data_tb.at(row); // Use reference
-            for (int i = 0; i < sortedColumns.size(); ++i) {
-                if (i > 0) {
-                    text += '\t';
-                }
-                int column = sortedColumns.at(i);
-                if (column < rowData.size()) {
-                    text += rowData.at(column);
-                }
-            }
-            if (row < m_data_tb.size() - 1) {
-                text += '\n';
-            }
-        }
-        
-        // Copy text directly
-        QApplication::clipboard()->setText(text);
-
-        // Update progress and finish in main thread
-        QMetaObject::invokeMethod(this, [this]() {
-            if (m_copyProgressDialog) {
-                m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                m_copyProgressDialog->toFinish();
-                m_copyProgressDialog->deleteLater();
-                m_copyProgressDialog = nullptr;
-            }
-        }, Qt::QueuedConnection);
-    });
-
-    m_copyProgressDialog->exec();
 }
 
 void InfoWidgets::copyAllData()
 {
-    // Create progress dialog
-    m_copyProgressDialog = new ProgressDialog(this);
-    m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-    m_copyProgressDialog->setMessage(tr("Preparing to copy all data..."));
-    m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
-    m_copyProgressDialog->setAutoClose(true);
-    m_copyProgressDialog->setCancelButtonVisible(true);
-
-    m_copyProgressDialog->start();
-    
-    // Use QtConcurrent::run for non-blocking operation
-    QtConcurrent::run([this]() {
-        // Prepare text
-        QString text;
-        text.reserve(m_data_tb.size() * m_headers.size() * 20); // Pre-allocate memory
-        
-        for (const QStringList &row : m_data_tb) {
-            text += row.join("\t") + "\n";
-        }
-
-        // Copy text directly
-        QApplication::clipboard()->setText(text);
-
-        // Update progress and finish in main thread
-        QMetaObject::invokeMethod(this, [this]() {
-            if (m_copyProgressDialog) {
-                m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                m_copyProgressDialog->toFinish();
-                m_copyProgressDialog->deleteLater();
-                m_copyProgressDialog = nullptr;
-            }
-        }, Qt::QueuedConnection);
-    });
-
-    m_copyProgressDialog->exec();
+    startCopy(QVector<int>(), QList<int>(), false, tr("Preparing to copy all data..."));
 }
 
 void InfoWidgets::copyAllDataWithHeader()
 {
-    // Create progress dialog
-    m_copyProgressDialog = new ProgressDialog(this);
-    m_copyProgressDialog->setWindowTitle(tr("Copying Data"));
-    m_copyProgressDialog->setMessage(tr("Preparing to copy all data with headers..."));
-    m_copyProgressDialog->setProgressMode(ProgressDialog::Indeterminate);
-    m_copyProgressDialog->setAutoClose(true);
-    m_copyProgressDialog->setCancelButtonVisible(true);
-
-    m_copyProgressDialog->start();
-    
-    // Use QtConcurrent::run for non-blocking operation
-    QtConcurrent::run([this]() {
-        // Prepare text
-        QString text;
-        text.reserve((m_data_tb.size() + 1) * m_headers.size() * 20); // Pre-allocate memory
-
-        // Add headers
-        if (!m_headers.isEmpty()) {
-            text += m_headers.join("\t") + "\n";
-        }
-
-        // Add all data
-        for (const QStringList &row : m_data_tb) {
-            text += row.join("\t") + "\n";
-        }
-
-        // Copy text directly
-        QApplication::clipboard()->setText(text);
-
-        // Update progress and finish in main thread
-        QMetaObject::invokeMethod(this, [this]() {
-            if (m_copyProgressDialog) {
-                m_copyProgressDialog->messageChanged(tr("Copy completed"));
-                m_copyProgressDialog->toFinish();
-                m_copyProgressDialog->deleteLater();
-                m_copyProgressDialog = nullptr;
-            }
-        });
-    });
-
-    m_copyProgressDialog->exec();
+    startCopy(QVector<int>(), QList<int>(), true, tr("Preparing to copy all data with headers..."));
 }
 
 void InfoWidgets::fitTableColumnToContent()
@@ -1117,14 +1018,15 @@ void InfoWidgets::showDetailInfo()
         return;
     }
 
-    qDebug() << "current name-s: " << m_data_tb[rowIndex][columnIndex];
+    QString name = m_model->store().text(rowIndex, columnIndex);
+    qDebug() << "current name-s: " << name;
 
     HelpQueryWg *helpWindow = new HelpQueryWg;
     helpWindow->setAttribute(Qt::WA_DeleteOnClose);
     helpWindow->setControlHeaderVisiable(false);
 
-    helpWindow->setWindowTitle(tr("Help Query %1=%2").arg(m_helpKey).arg(m_data_tb[rowIndex][columnIndex]));
-    helpWindow->setHelpParams(m_helpKey, m_data_tb[rowIndex][columnIndex]);
+    helpWindow->setWindowTitle(tr("Help Query %1=%2").arg(m_helpKey).arg(name));
+    helpWindow->setHelpParams(m_helpKey, name);
     helpWindow->show();
     ZWindowHelper::centerToParent(helpWindow);
 }
@@ -1219,10 +1121,13 @@ void InfoWidgets::setupInitialColumnWidths()
     
     // If user hasn't adjusted columns, use automatic sizing
     if (!m_isUserAdjusted) {
-        header->setSectionResizeMode(QHeaderView::ResizeToContents);
-        
-        // Process events to ensure content-based sizing is applied
-        QApplication::processEvents();
+        // Estimated from a bounded sample instead of ResizeToContents measuring every row
+        m_applyingColumnWidths = true;
+        header->setSectionResizeMode(QHeaderView::Interactive);
+        for (int i = 0; i < m_headers.size(); ++i) {
+            header->resizeSection(i, estimateColumnWidth(i));
+        }
+        m_applyingColumnWidths = false;
         
         // Set last column to stretch if there are multiple columns
         if (m_headers.size() > 1) {
@@ -1239,11 +1144,45 @@ void InfoWidgets::setupInitialColumnWidths()
     }
 }
 
+int InfoWidgets::estimateColumnWidth(int column)
+{
+    // the longest text only grows, a cached width stays valid until it does
+    int maxLength = m_model->store().maxTextLength(column);
+    if (column < m_columnWidthHints.size() && m_columnWidthHints.at(column).maxLength == maxLength) {
+        return m_columnWidthHints.at(column).width;
+    }
+
+    QFontMetrics metrics(ui->detail_tb->font());
+    QFontMetrics headerMetrics(ui->detail_tb->horizontalHeader()->font());
+    int width = headerMetrics.horizontalAdvance(m_headers.value(column));
+
+    int rowCount = m_model->rowCount();
+    int step = qMax(1, rowCount / COLUMN_WIDTH_SAMPLE_ROWS);
+    for (int row = 0; row < rowCount; row += step) {
+        width = qMax(width, metrics.horizontalAdvance(m_model->index(row, column).data().toString()));
+    }
+
+    // the longest value is rarely sampled, assume average glyphs for it
+    width = qMax(width, maxLength * metrics.averageCharWidth());
+    width = qBound(COLUMN_WIDTH_MIN, width + COLUMN_WIDTH_PADDING, COLUMN_WIDTH_MAX);
+
+    if (column >= m_columnWidthHints.size()) {
+        m_columnWidthHints.resize(column + 1);
+    }
+    m_columnWidthHints[column].maxLength = maxLength;
+    m_columnWidthHints[column].width = width;
+    return width;
+}
+
 void InfoWidgets::onHeaderSectionResized(int logicalIndex, int oldSize, int newSize)
 {
     Q_UNUSED(logicalIndex)
     Q_UNUSED(oldSize)
     Q_UNUSED(newSize)
+
+    if (m_applyingColumnWidths) {
+        return;
+    }
     
     // Mark as user-adjusted when user manually resizes columns
     if (!m_isUserAdjusted) {
@@ -1330,6 +1269,11 @@ void InfoWidgets::setupContextMenu()
     m_fitTableColumnAction = new QAction("Fit Column Width", this);
     connect(m_fitTableColumnAction, &QAction::triggered, this, &InfoWidgets::fitTableColumnToContent);
     m_tableContextMenu->addAction(m_fitTableColumnAction);
+
+    // aggregation action
+    m_aggregationAction = new QAction("Aggregation", this);
+    connect(m_aggregationAction, &QAction::triggered, this, &InfoWidgets::showAggregation);
+    m_tableContextMenu->addAction(m_aggregationAction);
 }
 
 void InfoWidgets::setupCopyMenu()
@@ -1389,10 +1333,41 @@ void InfoWidgets::setupTableModel()
     // model
     m_model = new MediaInfoTabelModel(this);
 
+    m_model->setTableHeader(&m_headers);
+
     multiColumnSearchModel = new MultiColumnSearchProxyModel(this);
     multiColumnSearchModel->setSourceModel(m_model);
     ui->detail_tb->setModel(multiColumnSearchModel);
 
+    connect(m_model, &MediaInfoTabelModel::modelReset, this, &InfoWidgets::tableChanged);
+    connect(m_model, &MediaInfoTabelModel::rowsInserted, this, &InfoWidgets::tableChanged);
+    connect(m_model, &MediaInfoTabelModel::rowsRemoved, this, &InfoWidgets::tableChanged);
+    connect(m_model, &MediaInfoTabelModel::layoutChanged, this, &InfoWidgets::tableChanged);
+    connect(m_model, &MediaInfoTabelModel::dataChanged, this, &InfoWidgets::tableChanged);
+
+    // searches on column stores finish in the background
+    connect(multiColumnSearchModel, &MultiColumnSearchProxyModel::filterFinished, this, [this](int rowCount) {
+        updateCurrentModel();
+
+        // follow the search with the statistics already shown
+        if (m_aggregationDialog && m_aggregationDialog->isVisible() && m_aggregationDialog->hasResult()) {
+            m_aggregationDialog->compute();
+        }
+
+        if (m_detailSearchDialog && multiColumnSearchModel->isUseFilterExpression()) {
+            QString error = multiColumnSearchModel->getExpressionError();
+            m_detailSearchDialog->setSearchStatus(error.isEmpty() ? tr("%1 rows matched").arg(rowCount)
+                                                                  : tr("Invalid expression: %1").arg(error));
+        }
+    });
+
+    // a page that could not be read stays empty until it is needed again
+    connect(m_model, &MediaInfoTabelModel::pageLoadFailed, this, [this](int page) {
+        QToolTip::showText(ui->detail_tb->viewport()->mapToGlobal(QPoint(0, 0)),
+                           tr("Rows of page %1 could not be read, scroll to load them again").arg(page + 1),
+                           ui->detail_tb);
+    });
+
     ui->detail_tb->horizontalHeader()->setSectionsMovable(true);
     ui->detail_tb->verticalHeader()->setDefaultAlignment(Qt::AlignRight | Qt::AlignVCenter);
     ui->detail_tb->verticalHeader()->setDefaultSectionSize(25);
@@ -1409,5 +1384,66 @@ void InfoWidgets::setupTableModel()
     connect(m_headerManager, &ZTableHeaderManager::headerToggleVisiable, [=]() {
         fitTableColumnToContent();
     });
+
+    // paged tables load and evict pages as the view scrolls
+    connect(ui->detail_tb->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+        updatePagedVisibleRows();
+    });
+    connect(ui->detail_tb->verticalScrollBar(), &QScrollBar::rangeChanged, this, [this]() {
+        updatePagedVisibleRows();
+    });
+    // cached column widths belong to the old rows and columns
+    connect(m_model, &QAbstractItemModel::modelReset, this, [this]() {
+        m_columnWidthHints.clear();
+    });
+    connect(m_model, &QAbstractItemModel::columnsInserted, this, [this]() {
+        m_columnWidthHints.clear();
+        if (m_model->isPaged()) {
+            m_headers = m_model->pagedHeaders();
+            emit pagedHeadersChanged(m_headers);
+        }
+    });
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &, int first, int) {
+        if (m_model->isPaged()) {
+            if (first == 0) {
+                setupInitialColumnWidths();
+            }
+            updateCurrentModel();
+        }
+    });
+}
+
+void InfoWidgets::setPagedControls(bool paged)
+{
+    ui->detail_tb->setSortingEnabled(!paged);
+    ui->search_le->setEnabled(!paged);
+    ui->search_btn->setEnabled(!paged);
+    if (m_detailSearchAction) {
+        m_detailSearchAction->setEnabled(!paged);
+    }
+    if (m_aggregationAction) {
+        m_aggregationAction->setEnabled(!paged);
+    }
+    ui->detail_tb->horizontalHeader()->setSortIndicatorShown(!paged);
+}
+
+void InfoWidgets::updatePagedVisibleRows()
+{
+    if (!m_model->isPaged() || multiColumnSearchModel->rowCount() == 0) {
+        return;
+    }
+
+    int first = ui->detail_tb->rowAt(0);
+    int last = ui->detail_tb->rowAt(ui->detail_tb->viewport()->height() - 1);
+    if (first < 0) {
+        first = 0;
+    }
+    if (last < 0) {
+        last = multiColumnSearchModel->rowCount() - 1;
+    }
+
+    int sourceFirst = multiColumnSearchModel->mapToSource(multiColumnSearchModel->index(first, 0)).row();
+    int sourceLast = multiColumnSearchModel->mapToSource(multiColumnSearchModel->index(last, 0)).row();
+    m_model->setVisibleRows(qMin(sourceFirst, sourceLast), qMax(sourceFirst, sourceLast));
 }
 
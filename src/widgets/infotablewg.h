@@ -14,6 +14,7 @@
 #include <QTimer>
 #include <QHeaderView>
 #include <QtConcurrent>
+#include <QListView>
 
 #include <common/common.h>
 #include <common/ztableheadermanager.h>
@@ -22,9 +23,12 @@
 
 #include <model/mediainfotabelmodel.h>
 #include <model/multicolumnsearchproxymodel.h>
+#include <model/rawtextmodel.h>
+#include <model/tablemimedata.h>
 
 #include <widgets/searchwg.h>
 #include <widgets/helpquerywg.h>
+#include <widgets/aggregationwg.h>
 
 // Forward declarations
 class ProgressDialog;
@@ -57,11 +61,30 @@ public:
 
     QList <int> getSelectRows();
 
-    const QList<QStringList> *getTableData();
+    // Rows are kept in the model's column store, this builds a copy
+    QList<QStringList> getTableData();
+
+    int rowCount() const;
+    QStringList rowData(int row) const;
+
+    // Cells of the whole table, only the loaded pages in paged mode
+    const ColumnTableStore &tableStore() const;
+    bool isPaged() const;
+
+    // Selects and shows a row of the store, false if the current search hides it
+    bool selectSourceRow(int row);
+
+    // Show a table too long for memory, pages are loaded around the visible rows. Search and sorting are off.
+    void init_paged_detail_tb(const QStringList &headers, int pageCount,
+                              const MediaInfoTabelModel::PageLoader &loader, QString format_join = "");
 
 signals:
     void dataChanged(QStringList line);
     void contextMenuAboutToShow();
+    // Rows were loaded, appended, removed, edited or reordered
+    void tableChanged();
+    // A paged table found its columns in a loaded page
+    void pagedHeadersChanged(const QStringList &headers);
 
 public slots:
     void init_detail_tb(const QString& data, const QString &format_key);
@@ -72,10 +95,14 @@ public slots:
 
     void update_data_detail_tb(const QMap<QString, QList<QStringList>>&data_tb, QString format_join = "");
 
+    void update_store_detail_tb(const ColumnTableStore &store, QString format_join = "");
+
     void remove_data_from_row_indexs(const QList<int>& indexs);
 
     void append_data_detail_tb(const QList<QStringList> &data_tb, QString format_join = "");
 
+    void append_header_detail_tb(const QStringList &headers);
+
     void remove_selected_row();
 
     void clear_detail_tb();
@@ -101,6 +128,9 @@ public slots:
 
     void showDetailInfo();
 
+    // Group-by statistics of the rows matched by the current search
+    void showAggregation();
+
 private slots:
     void on_search_btn_clicked();
     void on_expand_raw_btn_clicked(bool checked);
@@ -119,11 +149,21 @@ private slots:
 private:
     void setupSearchButton();
     void createDetailSearchDialog();
+    void createAggregationDialog();
+    void createRawView(); // Built the first time the raw view is expanded
+    void setRawSeparator(const QString &separator);
+    void copyRawSelection(); // Selected raw lines in table order, joined with the raw separator
     void updateCurrentModel(); // Helper method to update the current active model
-    QString getSelectedText(bool includeHeader = false);
+    QVector<int> selectedSourceRows() const; // Ascending source rows of the selection ranges
+    QList<int> selectedColumns() const;
+    // Copy rows x columns of the store (empty for all) on a scheduler thread, with progress and cancel
+    void startCopy(const QVector<int> &rows, const QList<int> &columns, bool includeHeader, const QString &message,
+                   const QString &separator = QStringLiteral("\t"));
     void setupContextMenu(); // Setup context menu for table
     void setupCopyMenu(); // Setup copy menu
     void setupTableModel(); // Setup table model and view
+    void setPagedControls(bool paged); // Disable the whole-table features in paged mode
+    void updatePagedVisibleRows(); // Report the visible rows to a paged model
 
 private:
     void format_data(const QString& data, QList<QStringList> &data_tb, QStringList &headers, QString format_key);
@@ -132,7 +172,6 @@ private:
     Ui::InfoWidgets *ui;
 
     QStringList m_headers;
-    QList<QStringList> m_data_tb;
 
     MediaInfoTabelModel *m_model;
     MultiColumnSearchProxyModel *multiColumnSearchModel;
@@ -156,6 +195,15 @@ private:
     // Detail search
     SearchWG *m_detailSearchDialog;
 
+    // Aggregation
+    AggregationWG *m_aggregationDialog;
+    QAction *m_aggregationAction;
+
+    // Raw text view, rows are joined with m_formatJoin when they are shown
+    QListView *m_rawView;
+    RawTextModel *m_rawModel;
+    QString m_formatJoin;
+
     QMenu *m_tableContextMenu;
     int m_currentRow;
     int m_currentColumn;
@@ -165,8 +213,14 @@ private:
     QAction *m_fitTableColumnAction;
     
     // Column width management
+    struct ColumnWidthHint {
+        int maxLength = -1;     // longest stored text when the width was estimated
+        int width = 0;
+    };
     QVector<double> m_columnWidthRatios;
+    QVector<ColumnWidthHint> m_columnWidthHints;
     bool m_isUserAdjusted;
+    bool m_applyingColumnWidths;
     QTimer *m_resizeTimer;
     int m_lastTableWidth;
     
@@ -178,6 +232,7 @@ private:
     void restoreColumnWidthRatios();
     void resizeColumnsProportionally();
     void setupInitialColumnWidths();
+    int estimateColumnWidth(int column); // Bounded sample of the rows, cached per column
     bool eventFilter(QObject *obj, QEvent *event) override;
 };
 
@@ -11,6 +11,8 @@
 #include <QShortcut>
 #include <QKeyEvent>
 #include <QCoreApplication>
+#include <QApplication>
+#include <QPointer>
 
 MediaPropsWG::MediaPropsWG(QWidget *parent)
     : QWidget(parent)
@@ -24,6 +26,7 @@ MediaPropsWG::MediaPropsWG(QWidget *parent)
 
 MediaPropsWG::~MediaPropsWG()
 {
+    ZProbeScheduler::instance().cancel(this);
     delete ui;
 }
 
@@ -62,9 +65,14 @@ void MediaPropsWG::loadMediaInfo()
         return;
     }
     
-    // Load format and streams info
-    loadFormatInfo();
-    loadStreamsInfo();
+    // Load format and streams info with a single probe
+    ZFfprobe::MediaSections mediaInfo = m_probe.probeSections(ZProbeEngine::SECTION_FORMAT | ZProbeEngine::SECTION_STREAMS, m_mediaFile);
+    if (m_formatWidget) {
+        m_formatWidget->loadData(mediaInfo.sectionJson(ZProbeEngine::SECTION_FORMAT));
+    }
+    if (m_streamsWidget) {
+        m_streamsWidget->loadData(mediaInfo.sectionJson(ZProbeEngine::SECTION_STREAMS));
+    }
 }
 
 void MediaPropsWG::loadMediaInfoAsync()
@@ -89,32 +97,55 @@ void MediaPropsWG::loadMediaInfoAsync()
     progressDlg->setCancelButtonVisible(false);
     progressDlg->show();
     
-    // Run the loading operation in a separate thread
-    QtConcurrent::run([=](){
-        // Get format info
-        QString formatInfo = m_probe.getMediaInfoJsonFormat(SHOW_FORMAT, m_mediaFile);
-        
-        // Get streams info
-        QString streamsInfo = m_probe.getMediaInfoJsonFormat(SHOW_STREAMS, m_mediaFile);
+    // Closes the dialog of a superseded request, the widget and its dialog may be gone by then
+    QPointer<ProgressDialog> progress(progressDlg);
+    auto closeProgress = [progress]() {
+        QMetaObject::invokeMethod(qApp, [progress]() {
+            if (progress) {
+                progress->finish();
+                progress->deleteLater();
+            }
+        }, Qt::QueuedConnection);
+    };
+
+    // Run the loading operation on the probe scheduler, a newer file supersedes this one.
+    // The job owns its probe and only reaches the widget through the guard.
+    QString mediaFile = m_mediaFile;
+    QPointer<MediaPropsWG> guard(this);
+    ZProbeScheduler::instance().submit(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, progress, mediaFile, closeProgress](){
+        // Get format and streams info, the file is opened only once
+        ZFfprobe probe;
+        ZFfprobe::MediaSections mediaInfo = probe.probeSections(ZProbeEngine::SECTION_FORMAT | ZProbeEngine::SECTION_STREAMS, mediaFile);
+        if (ZProbeScheduler::isCanceled()) {
+            closeProgress();
+            return;
+        }
+
+        QByteArray formatInfo = mediaInfo.sectionJson(ZProbeEngine::SECTION_FORMAT);
+        QByteArray streamsInfo = mediaInfo.sectionJson(ZProbeEngine::SECTION_STREAMS);
         
         // Update both widgets in a single main thread invocation
-        QMetaObject::invokeMethod(this, [this, formatInfo, streamsInfo, progressDlg]() {
-            // Update format widget
-            if (m_formatWidget) {
-                m_formatWidget->loadData(formatInfo.toUtf8());
-            }
-            
-            // Update streams widget
-            if (m_streamsWidget) {
-                m_streamsWidget->loadData(streamsInfo.toUtf8());
+        QMetaObject::invokeMethod(qApp, [guard, progress, formatInfo, streamsInfo]() {
+            if (guard) {
+                // Update format widget
+                if (guard->m_formatWidget) {
+                    guard->m_formatWidget->loadData(formatInfo);
+                }
+
+                // Update streams widget
+                if (guard->m_streamsWidget) {
+                    guard->m_streamsWidget->loadData(streamsInfo);
+                }
             }
             
             // Finish progress dialog
-            progressDlg->finish();
-            // Clean up progress dialog immediately
-            progressDlg->deleteLater();
+            if (progress) {
+                progress->finish();
+                // Clean up progress dialog immediately
+                progress->deleteLater();
+            }
         }, Qt::QueuedConnection);
-    });
+    }, closeProgress);
 }
 
 void MediaPropsWG::loadFormatInfo()
@@ -14,6 +14,7 @@
 #include <widgets/jsonfmtwg.h>
 #include <widgets/progressdlg.h>
 #include <common/zffprobe.h>
+#include <common/zprobescheduler.h>
 #include <common/zsingleton.h>
 
 // Define missing constants
@@ -12,6 +12,7 @@ SearchWG::SearchWG(QWidget *parent)
     , m_selectAllRadioBtn(nullptr)
     , m_selectNoneRadioBtn(nullptr)
     , m_visibleGroupBoxes(GroupBoxType::All)
+    , m_filterExpressionVisible(false)
 {
     ui->setupUi(this);
 
@@ -219,6 +220,10 @@ void SearchWG::updateGroupBoxDetail(QGroupBox *groupBox, bool visible)
                 child->setVisible(true);
             }
         }
+
+        if (groupBox == ui->match_control_groupBox) {
+            ui->use_filter_expression_cbx->setVisible(m_filterExpressionVisible);
+        }
     } else {
         // Collapse: hide content and minimize height
         const auto children = groupBox->findChildren<QWidget*>();
@@ -333,6 +338,17 @@ bool SearchWG::isUseRegularExpression()
     return ui->use_regular_express_cbx->isChecked();
 }
 
+bool SearchWG::isUseFilterExpression()
+{
+    return m_filterExpressionVisible && ui->use_filter_expression_cbx->isChecked();
+}
+
+void SearchWG::setFilterExpressionVisible(bool visible)
+{
+    m_filterExpressionVisible = visible;
+    ui->use_filter_expression_cbx->setVisible(visible && ui->match_control_groupBox->isChecked());
+}
+
 void SearchWG::setSearchText(const QString &text)
 {
     ui->search_le->setText(text);
@@ -56,6 +56,9 @@ public:
     bool isCaseSensitive();
     bool isMatchWholewords();
     bool isUseRegularExpression();
+    bool isUseFilterExpression();
+    // Only tables evaluate filter expressions, the option is hidden by default
+    void setFilterExpressionVisible(bool visible);
 
     void setSearchText(const QString &text);
     QString getSearchText();
@@ -107,6 +110,7 @@ private:
     // Group box visibility control
     GroupBoxTypes m_visibleGroupBoxes;
     QMap<QGroupBox*, int> m_originalHeights;
+    bool m_filterExpressionVisible;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(SearchWG::GroupBoxTypes)
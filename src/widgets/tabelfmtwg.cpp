@@ -20,11 +20,17 @@
 #include <QDesktopServices>
 #include <QUrl>
 #include <QTimer>
+#include <QPointer>
+#include <QFileInfo>
 
 #include "../common/zffmpeg.h"
+#include "../common/zffprobe.h"
 #include "../common/zffplay.h"
 #include "../common/common.h"
+#include "../common/zprobecache.h"
+#include "../common/zprobescheduler.h"
 #include "progressdlg.h"
+#include "tablediffwg.h"
 
 TabelFormatWG::TabelFormatWG(QWidget *parent)
     : BaseFormatWG(parent)
@@ -32,7 +38,37 @@ TabelFormatWG::TabelFormatWG(QWidget *parent)
 {
     ui->setupUi(this);
     m_tableFormatWg = new InfoWidgets(this);
-    ui->verticalLayout->addWidget(m_tableFormatWg);
+
+    // timeline below the rows, hidden until asked for
+    m_timelineWg = new TimelineWG(this);
+    m_timelineWg->setVisible(false);
+    m_timelineWg->setTableSource([this](ColumnTableStore *store, QStringList *headers, QString *reason) {
+        if (m_tableFormatWg->isPaged()) {
+            *reason = tr("Paged tables only keep the pages around the visible rows, the timeline needs every row");
+            return false;
+        }
+        // implicitly shared snapshot, edits while building detach from it
+        *store = m_tableFormatWg->tableStore();
+        *headers = m_headers;
+        return true;
+    });
+    connect(m_tableFormatWg, &InfoWidgets::tableChanged, m_timelineWg, &TimelineWG::invalidate);
+    // paged tables start without headers, their columns arrive with the first page
+    connect(m_tableFormatWg, &InfoWidgets::pagedHeadersChanged, this, [this](const QStringList &headers) {
+        m_headers = headers;
+    });
+    connect(m_timelineWg, &TimelineWG::rowClicked, this, [this](int row) {
+        if (!m_tableFormatWg->selectSourceRow(row)) {
+            qDebug() << "Row" << row + 1 << "is hidden by the current search";
+        }
+    });
+
+    m_splitter = new QSplitter(Qt::Vertical, this);
+    m_splitter->addWidget(m_tableFormatWg);
+    m_splitter->addWidget(m_timelineWg);
+    m_splitter->setStretchFactor(0, 3);
+    m_splitter->setStretchFactor(1, 1);
+    ui->verticalLayout->addWidget(m_splitter);
 
     // Set default window size to 3/5 of screen width and height
     QScreen *screen = QApplication::primaryScreen();
@@ -58,6 +94,26 @@ TabelFormatWG::TabelFormatWG(QWidget *parent)
 
     m_tableFormatWg->addContextSeparator();
     m_tableFormatWg->addContextMenu(m_imageMenu);
+
+    // session files
+    m_saveSessionAction = new QAction(tr("Save Session..."), this);
+    connect(m_saveSessionAction, &QAction::triggered, this, &TabelFormatWG::onSaveSessionTriggered);
+    m_openSessionAction = new QAction(tr("Open Session..."), this);
+    connect(m_openSessionAction, &QAction::triggered, this, &TabelFormatWG::onOpenSessionTriggered);
+
+    m_tableFormatWg->addContextSeparator();
+    m_tableFormatWg->addContextAction(m_saveSessionAction);
+    m_tableFormatWg->addContextAction(m_openSessionAction);
+
+    // compare mode
+    m_compareAction = new QAction(tr("Compare With..."), this);
+    connect(m_compareAction, &QAction::triggered, this, &TabelFormatWG::onCompareTriggered);
+    m_tableFormatWg->addContextAction(m_compareAction);
+
+    m_timelineAction = new QAction(tr("Show Timeline"), this);
+    m_timelineAction->setCheckable(true);
+    connect(m_timelineAction, &QAction::toggled, m_timelineWg, &TimelineWG::setVisible);
+    m_tableFormatWg->addContextAction(m_timelineAction);
     
     // Connect context menu about to show signal
     connect(m_tableFormatWg, &InfoWidgets::contextMenuAboutToShow,
@@ -66,6 +122,7 @@ TabelFormatWG::TabelFormatWG(QWidget *parent)
 
 TabelFormatWG::~TabelFormatWG()
 {
+    ZProbeScheduler::instance().cancel(this);
     delete ui;
 }
 
@@ -74,12 +131,254 @@ void TabelFormatWG::enableImageContextMenu(const bool &enable)
     m_enableImageContextMenu = enable;
 }
 
+bool TabelFormatWG::loadTable(const QStringList &headers, const QList<QStringList> &rows)
+{
+    m_headers = headers;
+
+    qDebug() << "Loaded" << rows.size() << "rows with" << m_headers.size() << "columns";
+
+    m_tableFormatWg->init_header_detail_tb(m_headers, ", ");
+    m_tableFormatWg->update_data_detail_tb(rows, ", ");
+
+    return true;
+}
+
+void TabelFormatWG::appendTable(const QStringList &headers, const QList<QStringList> &rows)
+{
+    if (headers.size() > m_headers.size()) {
+        QStringList added = headers.mid(m_headers.size());
+        m_headers = headers;
+        m_tableFormatWg->append_header_detail_tb(added);
+    }
+
+    m_tableFormatWg->append_data_detail_tb(rows, ", ");
+}
+
+void TabelFormatWG::loadPaged(const QString &command, const QString &fileName, double startTime, double duration)
+{
+    m_headers.clear();
+
+    // one extra page, the container duration is only an estimate
+    int pageCount = static_cast<int>(duration / TABLE_PAGE_DURATION) + 1;
+
+    qDebug() << "Paged table" << command << fileName << pageCount << "pages";
+
+    m_tableFormatWg->init_paged_detail_tb(m_headers, pageCount, [command, fileName, startTime](int page, QStringList &headers, QList<QStringList> &rows) {
+        // pages are loaded on scheduler threads, each with its own probe
+        ZFfprobe probe;
+        double from = startTime + page * TABLE_PAGE_DURATION;
+        return probe.getMediaInfoTableInterval(command, fileName, from, from + TABLE_PAGE_DURATION, headers, rows);
+    }, ", ");
+}
+
+void TabelFormatWG::setSourceFile(const QString &fileName)
+{
+    m_sourceFile = fileName;
+}
+
+QString TabelFormatWG::sourceFile() const
+{
+    if (!m_sourceFile.isEmpty()) {
+        return m_sourceFile;
+    }
+    return Common::instance()->getConfigValue(CURRENTFILE).toString();
+}
+
+QStringList TabelFormatWG::headers() const
+{
+    return m_headers;
+}
+
+const ColumnTableStore &TabelFormatWG::tableStore() const
+{
+    return m_tableFormatWg->tableStore();
+}
+
+bool TabelFormatWG::isPaged() const
+{
+    return m_tableFormatWg->isPaged();
+}
+
+void TabelFormatWG::saveSession(const QString &fileName)
+{
+    TableSnapshot::Info info;
+    info.headers = m_headers;
+    info.command = getExtraInfo().commandKey;
+    info.sourceFile = QFileInfo(sourceFile()).absoluteFilePath();
+    info.sourceSize = QFileInfo(info.sourceFile).size();
+    info.sourceModified = QFileInfo(info.sourceFile).lastModified();
+    info.created = QDateTime::currentDateTime();
+
+    // implicitly shared snapshot, edits while saving detach from it
+    ColumnTableStore store = m_tableFormatWg->tableStore();
+
+    ProgressDialog *progressDialog = new ProgressDialog(this);
+    progressDialog->setWindowTitle(tr("Saving Session"));
+    progressDialog->setProgressMode(ProgressDialog::Indeterminate);
+    progressDialog->setMessage(tr("Writing %1 rows to %2...").arg(store.rowCount()).arg(QFileInfo(fileName).fileName()));
+    progressDialog->setAutoClose(true);
+    progressDialog->setCancelButtonVisible(true);
+    progressDialog->start();
+
+    QPointer<TabelFormatWG> guard(this);
+    QPointer<ProgressDialog> dialog(progressDialog);
+    ZProbeScheduler::CancelToken token = ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, dialog, fileName, store, info]() {
+        TableSnapshot::Info sessionInfo = info;
+        sessionInfo.sourceIdentity = ZProbeCache::contentIdentity(info.sourceFile);
+
+        QString error;
+        bool ok = TableSnapshot::save(fileName, store, sessionInfo, &error, ZProbeScheduler::currentToken());
+        bool canceled = ZProbeScheduler::isCanceled();
+
+        QMetaObject::invokeMethod(qApp, [guard, dialog, ok, canceled, error]() {
+            if (dialog) {
+                emit dialog->toFinish();
+                dialog->deleteLater();
+            }
+            if (guard && !ok && !canceled) {
+                QMessageBox::warning(guard, tr("Save Session"), error);
+            }
+        }, Qt::QueuedConnection);
+    }, [dialog]() {
+        QMetaObject::invokeMethod(qApp, [dialog]() {
+            if (dialog) {
+                emit dialog->toFinish();
+                dialog->deleteLater();
+            }
+        }, Qt::QueuedConnection);
+    });
+
+    connect(progressDialog, &ProgressDialog::canceled, this, [token]() {
+        ZProbeScheduler::cancel(token);
+    });
+}
+
+void TabelFormatWG::loadSession(const QString &fileName)
+{
+    ProgressDialog *progressDialog = new ProgressDialog(this);
+    progressDialog->setWindowTitle(tr("Opening Session"));
+    progressDialog->setProgressMode(ProgressDialog::Indeterminate);
+    progressDialog->setMessage(tr("Reading %1...").arg(QFileInfo(fileName).fileName()));
+    progressDialog->setAutoClose(true);
+    progressDialog->setCancelButtonVisible(false);
+    progressDialog->start();
+
+    QPointer<TabelFormatWG> guard(this);
+    QPointer<ProgressDialog> dialog(progressDialog);
+    auto finish = [dialog]() {
+        if (dialog) {
+            emit dialog->toFinish();
+            dialog->deleteLater();
+        }
+    };
+
+    ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, finish, fileName]() {
+        ColumnTableStore store;
+        TableSnapshot::Info info;
+        QString error;
+        bool ok = TableSnapshot::load(fileName, &store, &info, &error);
+
+        // the probed file of someone else is usually not there, only a present one is compared
+        bool sourceChanged = false;
+        if (ok && !info.sourceIdentity.isEmpty() && QFileInfo(info.sourceFile).isFile()) {
+            sourceChanged = ZProbeCache::contentIdentity(info.sourceFile) != info.sourceIdentity;
+        }
+
+        QMetaObject::invokeMethod(qApp, [guard, finish, fileName, ok, error, store, info, sourceChanged]() {
+            finish();
+            if (!guard) {
+                return;
+            }
+            if (!ok) {
+                QMessageBox::warning(guard, tr("Open Session"), error);
+                return;
+            }
+            guard->onSessionLoaded(fileName, store, info, sourceChanged);
+        }, Qt::QueuedConnection);
+    }, [finish]() {
+        QMetaObject::invokeMethod(qApp, finish, Qt::QueuedConnection);
+    });
+}
+
+void TabelFormatWG::onSessionLoaded(const QString &fileName, const ColumnTableStore &store,
+                                    const TableSnapshot::Info &info, bool sourceChanged)
+{
+    m_headers = info.headers;
+    m_sourceFile = info.sourceFile;
+    setExtraInfo(ZExtraInfo(info.command, FORMAT_TABLE));
+
+    // the title keeps the mark, the rows no longer describe the file on disk
+    QString title = tr("Session : %1 - %2").arg(info.command, QFileInfo(info.sourceFile).fileName());
+    if (sourceChanged) {
+        title += tr(" [source changed]");
+    }
+    setWindowTitle(title);
+
+    m_tableFormatWg->init_header_detail_tb(m_headers, ", ");
+    m_tableFormatWg->update_store_detail_tb(store, ", ");
+
+    qDebug() << "Loaded session" << fileName << store.rowCount() << "rows, saved" << info.created.toString(Qt::ISODate);
+    if (sourceChanged) {
+        qWarning() << "Source file changed since the session was saved:" << info.sourceFile;
+        QMessageBox::warning(this, tr("Open Session"),
+                             tr("%1 changed since the session was saved on %2.\n"
+                                "The table shows the saved rows, not the current file.")
+                                 .arg(info.sourceFile, info.created.toString(Qt::ISODate)));
+    }
+}
+
+void TabelFormatWG::onSaveSessionTriggered()
+{
+    if (m_tableFormatWg->isPaged()) {
+        QMessageBox::information(this, tr("Save Session"),
+                                 tr("Paged tables only keep the pages around the visible rows and can not be saved."));
+        return;
+    }
+    if (m_tableFormatWg->rowCount() == 0) {
+        QMessageBox::information(this, tr("Save Session"), tr("No rows to save."));
+        return;
+    }
+
+    QString baseName = QFileInfo(sourceFile()).completeBaseName();
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save Session"),
+                                                    QDir::home().filePath(baseName + SESSION_FILE_SUFFIX),
+                                                    tr("Table Sessions (*%1)").arg(SESSION_FILE_SUFFIX));
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (!fileName.endsWith(SESSION_FILE_SUFFIX)) {
+        fileName += SESSION_FILE_SUFFIX;
+    }
+
+    saveSession(fileName);
+}
+
+void TabelFormatWG::onCompareTriggered()
+{
+    TableDiffWG *diffWindow = new TableDiffWG;
+    diffWindow->setWindowTitle(tr("Compare Tables"));
+    diffWindow->setAttribute(Qt::WA_DeleteOnClose);
+    diffWindow->setReference(this);
+    diffWindow->show();
+    ZWindowHelper::centerToParent(diffWindow);
+}
+
+void TabelFormatWG::onOpenSessionTriggered()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Session"), QDir::homePath(),
+                                                    tr("Table Sessions (*%1)").arg(SESSION_FILE_SUFFIX));
+    if (!fileName.isEmpty()) {
+        loadSession(fileName);
+    }
+}
+
 bool TabelFormatWG::loadJson(const QByteArray &json)
 {
     qDebug() << "here table";
 
+    // rows only live in the model's column store once they are handed over
+    QList<QStringList> dataTable;
     m_headers.clear();
-    m_data_tb.clear();
 
     QJsonParseError parseError;
     QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
@@ -225,13 +524,13 @@ bool TabelFormatWG::loadJson(const QByteArray &json)
             rowData.append(frameObj.contains(column) ?
                                toString(frameObj[column]) : "");
         }
-        m_data_tb.append(rowData);
+        dataTable.append(rowData);
     }
 
-    qDebug() << "Parsed" << m_data_tb.size() << "frames with" << m_headers.size() << "columns";
+    qDebug() << "Parsed" << dataTable.size() << "frames with" << m_headers.size() << "columns";
 
     m_tableFormatWg->init_header_detail_tb(m_headers, ", ");
-    m_tableFormatWg->update_data_detail_tb(m_data_tb, ", ");
+    m_tableFormatWg->update_data_detail_tb(dataTable, ", ");
 
     return true;
 }
@@ -287,7 +586,7 @@ void TabelFormatWG::previewImage()
 
     // If no rows selected, use the first row
     if (selectedRows.isEmpty()) {
-        if (m_data_tb.isEmpty()) {
+        if (m_tableFormatWg->rowCount() == 0) {
             QMessageBox::information(this, "Preview Info",
                                  "No frame data available for preview.");
             return;
@@ -311,7 +610,7 @@ void TabelFormatWG::previewImage()
     for (int i = 0; i < selectedRows.size(); ++i) {
         int selectedRow = selectedRows[i];
 
-        if (selectedRow < 0 || selectedRow >= m_data_tb.size()) {
+        if (selectedRow < 0 || selectedRow >= m_tableFormatWg->rowCount()) {
             qWarning() << "Invalid row index:" << selectedRow;
             continue;
         }
@@ -404,7 +703,7 @@ void TabelFormatWG::saveImage()
 
     // If no rows selected, use the first row
     if (selectedRows.isEmpty()) {
-        if (m_data_tb.isEmpty()) {
+        if (m_tableFormatWg->rowCount() == 0) {
             QMessageBox::information(this, "Save Image Info",
                                  "No frame data available for saving.");
             return;
@@ -453,7 +752,7 @@ void TabelFormatWG::saveImage()
     for (int i = 0; i < selectedRows.size(); ++i) {
         int selectedRow = selectedRows[i];
 
-        if (selectedRow < 0 || selectedRow >= m_data_tb.size()) {
+        if (selectedRow < 0 || selectedRow >= m_tableFormatWg->rowCount()) {
             qWarning() << "Invalid row index:" << selectedRow;
             continue;
         }
@@ -516,7 +815,7 @@ QStringList TabelFormatWG::getSelectedMediaTypes()
 {
     QStringList mediaTypes;
 
-    if (m_data_tb.isEmpty() || m_headers.isEmpty()) {
+    if (m_tableFormatWg->rowCount() == 0 || m_headers.isEmpty()) {
         return mediaTypes;
     }
 
@@ -538,7 +837,7 @@ QStringList TabelFormatWG::getSelectedMediaTypes()
 
     if (selectedRows.isEmpty()) {
         // If no rows selected, check the first row
-        if (!m_data_tb.isEmpty()) {
+        if (m_tableFormatWg->rowCount() > 0) {
             selectedRows.append(0);
         }
     }
@@ -546,8 +845,8 @@ QStringList TabelFormatWG::getSelectedMediaTypes()
     // Extract media_type values from selected rows
     QSet<QString> uniqueTypes;
     for (int row : selectedRows) {
-        if (row >= 0 && row < m_data_tb.size()) {
-            const QStringList &rowData = m_data_tb[row];
+        if (row >= 0 && row < m_tableFormatWg->rowCount()) {
+            const QStringList rowData = m_tableFormatWg->rowData(row);
             if (mediaTypeColumn < rowData.size()) {
                 QString mediaType = rowData[mediaTypeColumn].trimmed();
                 if (!mediaType.isEmpty()) {
@@ -10,11 +10,17 @@
 #include <QJsonArray>
 #include <QDebug>
 #include <QSet>
+#include <QSplitter>
 
 #include <widgets/infotablewg.h>
 #include <widgets/basefmtwg.h>
+#include <widgets/timelinewg.h>
 
 #include <model/mediainfotabelmodel.h>
+#include <model/tablesnapshot.h>
+
+#define TABLE_PAGE_DURATION 10.0    // seconds of media per page of a paged table
+#define SESSION_FILE_SUFFIX ".mdsession"
 
 namespace Ui {
 class TabelFormatWG;
@@ -28,6 +34,28 @@ public:
     explicit TabelFormatWG(QWidget *parent = nullptr);
     ~TabelFormatWG();
 
+    // Load rows that were produced without the json round trip
+    bool loadTable(const QStringList &headers, const QList<QStringList> &rows);
+
+    // Append a batch of streamed rows, headers may have grown since the last batch
+    void appendTable(const QStringList &headers, const QList<QStringList> &rows);
+
+    // Show the packets/frames of a long file page by page, each page is a TABLE_PAGE_DURATION window
+    void loadPaged(const QString &command, const QString &fileName, double startTime, double duration);
+
+    // Probed media file, recorded in saved sessions. Defaults to the current file.
+    void setSourceFile(const QString &fileName);
+    QString sourceFile() const;
+
+    // Binary session files, see TableSnapshot. Both run on a scheduler thread with a progress dialog.
+    void saveSession(const QString &fileName);
+    void loadSession(const QString &fileName);
+
+    // Shown table, only the loaded pages of a paged table
+    QStringList headers() const;
+    const ColumnTableStore &tableStore() const;
+    bool isPaged() const;
+
 public slots:
     void enableImageContextMenu(const bool &enable);
 
@@ -35,9 +63,16 @@ private:
     Ui::TabelFormatWG *ui;
 
     InfoWidgets *m_tableFormatWg = nullptr;
+    TimelineWG *m_timelineWg = nullptr;
+    QSplitter *m_splitter = nullptr;
 
-    QList<QStringList> m_data_tb;
     QList<QString> m_headers;
+    QString m_sourceFile;
+
+    QAction *m_saveSessionAction = nullptr;
+    QAction *m_openSessionAction = nullptr;
+    QAction *m_compareAction = nullptr;
+    QAction *m_timelineAction = nullptr;
 
     // image menu
     QMenu *m_imageMenu = nullptr;
@@ -54,10 +89,15 @@ private:
     
     void updateImageMenuVisibility();
 
+    void onSessionLoaded(const QString &fileName, const ColumnTableStore &store, const TableSnapshot::Info &info, bool sourceChanged);
+
 private slots:
     void previewImage();
     void saveImage();
     void onContextMenuAboutToShow();
+    void onSaveSessionTriggered();
+    void onOpenSessionTriggered();
+    void onCompareTriggered();
 
 protected:
     bool loadJson(const QByteArray &json);
@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "tablediffwg.h"
+#include "ui_tablediffwg.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QSignalBlocker>
+#include <QDir>
+#include <QDebug>
+
+#include <common/qtcompat.h>
+#include <common/zprobescheduler.h>
+
+#include <model/tablesnapshot.h>
+
+#include <widgets/tabelfmtwg.h>
+
+TableDiffWG::TableDiffWG(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::TableDiffWG)
+    , m_generation(0)
+{
+    ui->setupUi(this);
+
+    refreshSources();
+}
+
+TableDiffWG::~TableDiffWG()
+{
+    ZProbeScheduler::instance().cancel(this);
+    delete ui;
+}
+
+void TableDiffWG::setReference(TabelFormatWG *window)
+{
+    refreshSources();
+
+    for (int i = 0; i < m_sources.size(); ++i) {
+        if (m_sources.at(i).window == window) {
+            ui->reference_cb->setCurrentIndex(i);
+            // the most recent other table is the likely test side
+            if (ui->test_cb->currentIndex() == i && m_sources.size() > 1) {
+                ui->test_cb->setCurrentIndex(i == 0 ? 1 : 0);
+            }
+            return;
+        }
+    }
+}
+
+void TableDiffWG::compare()
+{
+    Input reference;
+    Input test;
+    QString error;
+    if (!takeInput(ui->reference_cb, &reference, &error) || !takeInput(ui->test_cb, &test, &error)) {
+        ui->status_lb->setText(error);
+        return;
+    }
+
+    TableDiff diff;
+    QStringList fields;
+    const QStringList parts = ui->fields_le->text().split(',', QT_SKIP_EMPTY_PARTS);
+    for (const QString &part : parts) {
+        fields.append(part.trimmed());
+    }
+    diff.setFields(fields);
+    diff.setIncludeUnchanged(ui->show_unchanged_cbox->isChecked());
+
+    int generation = ++m_generation;
+    QPointer<TableDiffWG> guard(this);
+    ui->status_lb->setText(tr("Comparing..."));
+
+    // a newer comparison of this window cancels the running one
+    ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_INTERACTIVE, [guard, diff, reference, test, generation]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        Input referenceInput = reference;
+        Input testInput = test;
+        ColumnTableStore store;
+        QStringList headers;
+        TableDiff::Summary summary;
+        QString error;
+
+        bool ok = loadInput(&referenceInput, &error) && loadInput(&testInput, &error)
+            && diff.compare(referenceInput.store, referenceInput.headers, testInput.store, testInput.headers,
+                            &store, &headers, &summary, &error, ZProbeScheduler::currentToken());
+        if (ZProbeScheduler::isCanceled()) {
+            return;
+        }
+
+        qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(qApp, [guard, generation, ok, error, store, headers, summary, elapsed]() {
+            if (guard) {
+                guard->onCompared(generation, ok, error, store, headers, summary, elapsed);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TableDiffWG::refreshSources()
+{
+    Source reference = currentSource(ui->reference_cb);
+    Source test = currentSource(ui->test_cb);
+
+    // paged tables only hold the pages around the view, they can not be aligned
+    m_sources.clear();
+    const QWidgetList widgets = QApplication::topLevelWidgets();
+    for (QWidget *widget : widgets) {
+        auto *window = qobject_cast<TabelFormatWG *>(widget);
+        if (window && window->isVisible() && !window->isPaged()) {
+            m_sources.append({window->windowTitle(), window, QString()});
+        }
+    }
+    for (const QString &fileName : qAsConst(m_sessionFiles)) {
+        m_sources.append({QFileInfo(fileName).fileName(), nullptr, fileName});
+    }
+
+    fillComboBox(ui->reference_cb, reference);
+    fillComboBox(ui->test_cb, test);
+}
+
+void TableDiffWG::changeEvent(QEvent *event)
+{
+    // table windows opened or closed meanwhile
+    if (event->type() == QEvent::ActivationChange && isActiveWindow()) {
+        refreshSources();
+    }
+    QWidget::changeEvent(event);
+}
+
+void TableDiffWG::on_compare_btn_clicked()
+{
+    compare();
+}
+
+void TableDiffWG::on_reference_btn_clicked()
+{
+    addSessionFile(ui->reference_cb);
+}
+
+void TableDiffWG::on_test_btn_clicked()
+{
+    addSessionFile(ui->test_cb);
+}
+
+void TableDiffWG::fillComboBox(QComboBox *comboBox, const Source &selected)
+{
+    QSignalBlocker blocker(comboBox);
+    comboBox->clear();
+
+    int current = -1;
+    for (int i = 0; i < m_sources.size(); ++i) {
+        const Source &source = m_sources.at(i);
+        comboBox->addItem(source.name);
+        comboBox->setItemData(i, source.sessionFile.isEmpty() ? source.name : source.sessionFile, Qt::ToolTipRole);
+
+        bool same = source.window ? source.window == selected.window
+                                  : !source.sessionFile.isEmpty() && source.sessionFile == selected.sessionFile;
+        if (same) {
+            current = i;
+        }
+    }
+
+    if (current < 0 && !m_sources.isEmpty()) {
+        // different defaults for the two sides
+        current = comboBox == ui->test_cb && m_sources.size() > 1 ? 1 : 0;
+    }
+    comboBox->setCurrentIndex(current);
+}
+
+TableDiffWG::Source TableDiffWG::currentSource(QComboBox *comboBox) const
+{
+    return m_sources.value(comboBox->currentIndex());
+}
+
+bool TableDiffWG::takeInput(QComboBox *comboBox, Input *input, QString *error) const
+{
+    Source source = currentSource(comboBox);
+    if (!source.sessionFile.isEmpty()) {
+        input->sessionFile = source.sessionFile;
+        return true;
+    }
+
+    if (!source.window) {
+        *error = tr("Pick an open table or a session file for both sides");
+        return false;
+    }
+    if (source.window->isPaged()) {
+        *error = tr("%1 is paged and can not be compared").arg(source.name);
+        return false;
+    }
+
+    // implicitly shared snapshot, edits in the table window detach from it
+    input->store = source.window->tableStore();
+    input->headers = source.window->headers();
+    return true;
+}
+
+void TableDiffWG::addSessionFile(QComboBox *comboBox)
+{
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Session"), QDir::homePath(),
+                                                    tr("Table Sessions (*%1)").arg(SESSION_FILE_SUFFIX));
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (!m_sessionFiles.contains(fileName)) {
+        m_sessionFiles.append(fileName);
+    }
+    refreshSources();
+
+    Source session;
+    session.sessionFile = fileName;
+    fillComboBox(comboBox, session);
+}
+
+bool TableDiffWG::loadInput(Input *input, QString *error)
+{
+    if (input->sessionFile.isEmpty()) {
+        return true;
+    }
+
+    TableSnapshot::Info info;
+    if (!TableSnapshot::load(input->sessionFile, &input->store, &info, error)) {
+        return false;
+    }
+    input->headers = info.headers;
+    return true;
+}
+
+void TableDiffWG::onCompared(int generation, bool ok, const QString &error, const ColumnTableStore &store,
+                             const QStringList &headers, const TableDiff::Summary &summary, qint64 elapsed)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    if (!ok) {
+        ui->status_lb->setText(error);
+        return;
+    }
+
+    ui->result_wg->init_header_detail_tb(headers, ", ");
+    ui->result_wg->update_store_detail_tb(store, ", ");
+
+    QString status = tr("%1 streams by %2: %3 changed, %4 inserted, %5 missing, %6 same in %7 ms")
+                         .arg(summary.streams).arg(summary.timeColumn)
+                         .arg(summary.changed).arg(summary.inserted).arg(summary.missing).arg(summary.same)
+                         .arg(elapsed);
+    if (summary.fields.isEmpty()) {
+        status += tr(", no field is in both tables");
+    }
+    ui->status_lb->setText(status);
+
+    qDebug() << "Table diff:" << summary.fields << store.rowCount() << "rows in" << elapsed << "ms";
+}
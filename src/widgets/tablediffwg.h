@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TABLEDIFFWG_H
+#define TABLEDIFFWG_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QPointer>
+#include <QStringList>
+
+#include <model/columntablestore.h>
+#include <model/tablediff.h>
+
+class TabelFormatWG;
+
+namespace Ui {
+class TableDiffWG;
+}
+
+/**
+ * @brief Compare mode of the packet and frame tables
+ *
+ * Aligns a test table to a reference table by stream and timestamp, e.g. the
+ * output of an encoder build against a known good one, and shows the inserted,
+ * missing and changed rows in one merged table. Either side is an open table
+ * window or a saved session file. The work runs as a TableDiff job on
+ * ZProbeScheduler.
+ */
+class TableDiffWG : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TableDiffWG(QWidget *parent = nullptr);
+    ~TableDiffWG();
+
+    // Selects an open table as the reference side
+    void setReference(TabelFormatWG *window);
+
+public slots:
+    void compare();
+
+    // Lists the open table windows again, the selections are kept
+    void refreshSources();
+
+protected:
+    void changeEvent(QEvent *event) override;
+
+private slots:
+    void on_compare_btn_clicked();
+    void on_reference_btn_clicked();
+    void on_test_btn_clicked();
+
+private:
+    struct Source {
+        QString name;
+        QPointer<TabelFormatWG> window;
+        QString sessionFile;
+    };
+
+    // Rows of one side, session files are read on the worker
+    struct Input {
+        ColumnTableStore store;
+        QStringList headers;
+        QString sessionFile;
+    };
+
+    void fillComboBox(QComboBox *comboBox, const Source &selected);
+    Source currentSource(QComboBox *comboBox) const;
+    bool takeInput(QComboBox *comboBox, Input *input, QString *error) const;
+    void addSessionFile(QComboBox *comboBox);
+    static bool loadInput(Input *input, QString *error);
+
+    void onCompared(int generation, bool ok, const QString &error, const ColumnTableStore &store,
+                    const QStringList &headers, const TableDiff::Summary &summary, qint64 elapsed);
+
+private:
+    Ui::TableDiffWG *ui;
+
+    QList<Source> m_sources;        // items of both combo boxes, in the same order
+    QStringList m_sessionFiles;
+    int m_generation;
+};
+
+#endif // TABLEDIFFWG_H
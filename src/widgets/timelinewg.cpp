@@ -0,0 +1,482 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#include "timelinewg.h"
+
+#include <QApplication>
+#include <QPainter>
+#include <QPointer>
+#include <QMenu>
+#include <QActionGroup>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QDebug>
+
+#include <cmath>
+
+#include <common/qtcompat.h>
+#include <common/zprobescheduler.h>
+
+#define TIMELINE_REBUILD_MS 300     // quiet time after the last change before the chart is rebuilt
+#define TIMELINE_ZOOM_STEP 1.0015   // zoom per wheel delta unit, about 20% per notch
+#define TIMELINE_CLICK_PIXELS 4     // distance a press may move and still count as a click
+#define TIMELINE_TICK_PIXELS 100    // pixels between two time labels
+#define TIMELINE_MARGIN_LEFT 64     // room for the size labels
+#define TIMELINE_MARGIN_BOTTOM 20   // room for the time labels
+#define TIMELINE_MARGIN 6
+
+namespace {
+
+// drawn in category order, the key pictures end up on top
+const QColor CATEGORY_COLORS[TimelinePyramid::CATEGORY_COUNT] = {
+    QColor(150, 150, 150),          // other
+    QColor(30, 136, 229),           // B
+    QColor(67, 160, 71),            // P
+    QColor(251, 140, 0),            // I
+    QColor(229, 57, 53)             // key
+};
+
+const char *const CATEGORY_NAMES[TimelinePyramid::CATEGORY_COUNT] = {
+    "Other", "B", "P", "I", "Key"
+};
+
+// 1, 2 or 5 times a power of ten, at least raw
+double niceStep(double raw)
+{
+    double base = std::pow(10.0, std::floor(std::log10(raw)));
+    double fraction = raw / base;
+    if (fraction <= 1) {
+        return base;
+    }
+    if (fraction <= 2) {
+        return 2 * base;
+    }
+    if (fraction <= 5) {
+        return 5 * base;
+    }
+    return 10 * base;
+}
+
+}
+
+TimelineWG::TimelineWG(QWidget *parent)
+    : QWidget(parent)
+    , m_stream(-1)
+    , m_generation(0)
+    , m_dirty(true)
+    , m_from(0)
+    , m_to(1)
+    , m_fitted(true)
+    , m_pressed(false)
+    , m_dragged(false)
+    , m_pressFrom(0)
+    , m_pressTo(0)
+    , m_markerTime(0)
+    , m_hasMarker(false)
+{
+    setMinimumHeight(120);
+
+    m_rebuildTimer.setSingleShot(true);
+    m_rebuildTimer.setInterval(TIMELINE_REBUILD_MS);
+    connect(&m_rebuildTimer, &QTimer::timeout, this, &TimelineWG::rebuild);
+}
+
+TimelineWG::~TimelineWG()
+{
+    ZProbeScheduler::instance().cancel(this);
+}
+
+void TimelineWG::setTableSource(const TableSource &source)
+{
+    m_source = source;
+    invalidate();
+}
+
+QSize TimelineWG::sizeHint() const
+{
+    return QSize(640, 180);
+}
+
+void TimelineWG::invalidate()
+{
+    m_dirty = true;
+
+    // hidden charts are built when they are shown
+    if (isVisible()) {
+        m_rebuildTimer.start();
+    }
+}
+
+void TimelineWG::fitAll()
+{
+    m_fitted = true;
+    if (m_pyramid && !m_pyramid->isEmpty()) {
+        double first = m_pyramid->firstTime();
+        double last = m_pyramid->lastTime();
+        // a single point still gets a range around it
+        setRange(first, last > first ? last : first + 1);
+    }
+    update();
+}
+
+void TimelineWG::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    QColor textColor = palette().color(QPalette::Text);
+    if (!m_pyramid || m_pyramid->isEmpty()) {
+        painter.setPen(textColor);
+        painter.drawText(rect(), Qt::AlignCenter, m_message.isEmpty() ? tr("No packets or frames to plot") : m_message);
+        return;
+    }
+
+    QRect plot = plotRect();
+    int width = plot.width();
+    if (width <= 0 || plot.height() <= 0) {
+        return;
+    }
+
+    // every category first, the vertical scale follows the largest visible size
+    m_minimum.resize(width * TimelinePyramid::CATEGORY_COUNT);
+    m_maximum.resize(width * TimelinePyramid::CATEGORY_COUNT);
+    float peak = 0;
+    for (int category = 0; category < TimelinePyramid::CATEGORY_COUNT; ++category) {
+        float *minimum = m_minimum.data() + category * width;
+        float *maximum = m_maximum.data() + category * width;
+        m_pyramid->decimate(static_cast<TimelinePyramid::Category>(category), m_from, m_to, width, minimum, maximum);
+        for (int x = 0; x < width; ++x) {
+            if (minimum[x] <= maximum[x]) {
+                peak = qMax(peak, maximum[x]);
+            }
+        }
+    }
+    if (peak <= 0) {
+        peak = 1;
+    }
+
+    double base = plot.top() + plot.height();
+    double yScale = plot.height() / (peak * 1.05);
+    auto yOf = [base, yScale](double value) {
+        return base - value * yScale;
+    };
+
+    // size grid and labels
+    QColor gridColor = palette().color(QPalette::Mid);
+    gridColor.setAlpha(80);
+    double sizeStep = niceStep(peak / 4);
+    for (double size = sizeStep; size <= peak * 1.05; size += sizeStep) {
+        int y = static_cast<int>(yOf(size));
+        painter.setPen(gridColor);
+        painter.drawLine(plot.left(), y, plot.right(), y);
+        painter.setPen(textColor);
+        painter.drawText(QRect(0, y - 8, TIMELINE_MARGIN_LEFT - 4, 16), Qt::AlignRight | Qt::AlignVCenter, sizeText(size));
+    }
+
+    // time labels
+    double timeStep = niceStep((m_to - m_from) * TIMELINE_TICK_PIXELS / width);
+    for (double time = std::ceil(m_from / timeStep) * timeStep; time <= m_to; time += timeStep) {
+        int x = static_cast<int>(xOf(time));
+        painter.setPen(gridColor);
+        painter.drawLine(x, plot.top(), x, plot.bottom());
+        painter.setPen(textColor);
+        painter.drawText(QRect(x - TIMELINE_TICK_PIXELS / 2, plot.bottom() + 2, TIMELINE_TICK_PIXELS, TIMELINE_MARGIN_BOTTOM - 2),
+                         Qt::AlignHCenter | Qt::AlignTop, timeText(time, timeStep));
+    }
+
+    // one vertical line per pixel column: a bar for a single size, the min/max extent of several
+    QVector<QLineF> lines;
+    lines.reserve(width);
+    for (int category = 0; category < TimelinePyramid::CATEGORY_COUNT; ++category) {
+        const float *minimum = m_minimum.constData() + category * width;
+        const float *maximum = m_maximum.constData() + category * width;
+
+        lines.clear();
+        for (int x = 0; x < width; ++x) {
+            if (minimum[x] > maximum[x]) {
+                continue;
+            }
+            double top = yOf(maximum[x]);
+            double bottom = minimum[x] == maximum[x] ? base : yOf(minimum[x]);
+            if (bottom - top < 1) {
+                bottom = top + 1;
+            }
+            double lineX = plot.left() + x + 0.5;
+            lines.append(QLineF(lineX, bottom, lineX, top));
+        }
+
+        painter.setPen(CATEGORY_COLORS[category]);
+        painter.drawLines(lines);
+    }
+
+    if (m_hasMarker && m_markerTime >= m_from && m_markerTime <= m_to) {
+        painter.setPen(QPen(textColor, 1, Qt::DashLine));
+        int x = static_cast<int>(xOf(m_markerTime));
+        painter.drawLine(x, plot.top(), x, plot.bottom());
+    }
+
+    // legend of the categories present, right to left
+    QFontMetrics metrics = painter.fontMetrics();
+    int legendX = plot.right();
+    for (int category = TimelinePyramid::CATEGORY_COUNT - 1; category >= 0; --category) {
+        int count = m_pyramid->pointCount(static_cast<TimelinePyramid::Category>(category));
+        if (count == 0) {
+            continue;
+        }
+        QString name = tr(CATEGORY_NAMES[category]);
+        int textWidth = metrics.boundingRect(name).width();
+        legendX -= textWidth + 18;
+        painter.fillRect(QRect(legendX, plot.top() + 3, 10, 10), CATEGORY_COLORS[category]);
+        painter.setPen(textColor);
+        painter.drawText(QRect(legendX + 14, plot.top(), textWidth + 4, 16), Qt::AlignLeft | Qt::AlignVCenter, name);
+    }
+
+    QString axes = m_pyramid->timeColumn().isEmpty()
+        ? tr("%1 by row").arg(m_pyramid->valueColumn())
+        : tr("%1 over %2").arg(m_pyramid->valueColumn(), m_pyramid->timeColumn());
+    if (m_stream >= 0) {
+        axes += tr(", stream %1").arg(m_stream);
+    }
+    painter.drawText(QRect(plot.left() + 4, plot.top(), plot.width() / 2, 16), Qt::AlignLeft | Qt::AlignVCenter, axes);
+}
+
+void TimelineWG::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    if (m_dirty) {
+        rebuild();
+    }
+}
+
+void TimelineWG::wheelEvent(QWheelEvent *event)
+{
+    if (!m_pyramid || m_pyramid->isEmpty()) {
+        return;
+    }
+
+    // zoom around the time under the cursor
+    double anchor = timeAt(QT_WHEEL_EVENT_X(event));
+    double factor = std::pow(TIMELINE_ZOOM_STEP, -event->angleDelta().y());
+    setRange(anchor - (anchor - m_from) * factor, anchor + (m_to - anchor) * factor);
+    m_fitted = false;
+    update();
+    event->accept();
+}
+
+void TimelineWG::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    m_pressed = true;
+    m_dragged = false;
+    m_pressPos = event->pos();
+    m_pressFrom = m_from;
+    m_pressTo = m_to;
+}
+
+void TimelineWG::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_pressed || !m_pyramid) {
+        return;
+    }
+
+    int dx = event->pos().x() - m_pressPos.x();
+    if (!m_dragged && std::abs(dx) < TIMELINE_CLICK_PIXELS) {
+        return;
+    }
+
+    m_dragged = true;
+    m_fitted = false;
+    setCursor(Qt::ClosedHandCursor);
+
+    double shift = dx * (m_pressTo - m_pressFrom) / qMax(1, plotRect().width());
+    setRange(m_pressFrom - shift, m_pressTo - shift);
+    update();
+}
+
+void TimelineWG::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || !m_pressed) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+
+    m_pressed = false;
+    unsetCursor();
+    if (m_dragged || !m_pyramid) {
+        return;
+    }
+
+    // rows moved since the last build, the points would name the wrong rows
+    if (m_dirty) {
+        return;
+    }
+
+    double tolerance = TIMELINE_CLICK_PIXELS * (m_to - m_from) / qMax(1, plotRect().width());
+    double time = timeAt(event->pos().x());
+    int row = m_pyramid->nearestRow(time, tolerance);
+    if (row < 0) {
+        return;
+    }
+
+    m_markerTime = time;
+    m_hasMarker = true;
+    update();
+    emit rowClicked(row);
+}
+
+void TimelineWG::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event)
+    fitAll();
+}
+
+void TimelineWG::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu(this);
+    menu.addAction(tr("Fit"), this, &TimelineWG::fitAll);
+
+    // packets of audio and video streams are better looked at one stream at a time
+    if (m_pyramid && m_pyramid->streams().size() > 1) {
+        QMenu *streamMenu = menu.addMenu(tr("Stream"));
+        QActionGroup *group = new QActionGroup(streamMenu);
+
+        QVector<qint64> streams = m_pyramid->streams();
+        streams.prepend(-1);
+        for (qint64 stream : qAsConst(streams)) {
+            QAction *action = streamMenu->addAction(stream < 0 ? tr("All Streams") : tr("Stream %1").arg(stream));
+            action->setCheckable(true);
+            action->setChecked(stream == m_stream);
+            group->addAction(action);
+            connect(action, &QAction::triggered, this, [this, stream]() {
+                m_stream = stream;
+                m_fitted = true;
+                m_hasMarker = false;
+                rebuild();
+            });
+        }
+    }
+
+    menu.exec(event->globalPos());
+}
+
+void TimelineWG::rebuild()
+{
+    m_rebuildTimer.stop();
+    m_dirty = true;
+
+    ColumnTableStore store;
+    QStringList headers;
+    QString reason;
+    if (!m_source || !m_source(&store, &headers, &reason)) {
+        onBuilt(++m_generation, QSharedPointer<const TimelinePyramid>(), reason);
+        return;
+    }
+
+    int generation = ++m_generation;
+    qint64 stream = m_stream;
+    QPointer<TimelineWG> guard(this);
+
+    // a newer build of this chart cancels the running one
+    ZProbeScheduler::instance().submitTable(this, ZProbeScheduler::PRIORITY_BACKGROUND, [guard, store, headers, stream, generation]() {
+        QSharedPointer<TimelinePyramid> pyramid(new TimelinePyramid);
+        QString error;
+        if (!pyramid->build(store, headers, stream, &error, ZProbeScheduler::currentToken())) {
+            if (ZProbeScheduler::isCanceled()) {
+                return;
+            }
+            pyramid.reset();
+        }
+
+        QMetaObject::invokeMethod(qApp, [guard, generation, pyramid, error]() {
+            if (guard) {
+                guard->onBuilt(generation, pyramid, error);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TimelineWG::onBuilt(int generation, const QSharedPointer<const TimelinePyramid> &pyramid, const QString &message)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_dirty = false;
+    m_pyramid = pyramid;
+    m_message = message;
+
+    // the stream may be gone after a reload
+    if (m_pyramid && m_stream >= 0 && !m_pyramid->streams().contains(m_stream)) {
+        m_stream = -1;
+        rebuild();
+        return;
+    }
+
+    if (m_fitted) {
+        fitAll();
+    }
+    update();
+}
+
+QRect TimelineWG::plotRect() const
+{
+    return rect().adjusted(TIMELINE_MARGIN_LEFT, TIMELINE_MARGIN, -TIMELINE_MARGIN, -TIMELINE_MARGIN_BOTTOM);
+}
+
+double TimelineWG::timeAt(double x) const
+{
+    QRect plot = plotRect();
+    return m_from + (x - plot.left()) * (m_to - m_from) / qMax(1, plot.width());
+}
+
+double TimelineWG::xOf(double time) const
+{
+    QRect plot = plotRect();
+    return plot.left() + (time - m_from) * plot.width() / (m_to - m_from);
+}
+
+void TimelineWG::setRange(double from, double to)
+{
+    if (!m_pyramid || m_pyramid->isEmpty()) {
+        return;
+    }
+
+    double first = m_pyramid->firstTime();
+    double last = qMax(m_pyramid->lastTime(), first + 1e-6);
+    double span = last - first;
+
+    // no further out than the whole table, no further in than a few microseconds
+    double length = qBound(1e-6, to - from, span);
+    from = qBound(first, from, last - length);
+    m_from = from;
+    m_to = from + length;
+}
+
+QString TimelineWG::timeText(double time, double step) const
+{
+    if (m_pyramid && m_pyramid->timeColumn().isEmpty()) {
+        return QString::number(qRound64(time) + 1);
+    }
+
+    int decimals = qMax(0, static_cast<int>(-std::floor(std::log10(step))));
+    return QString("%1s").arg(time, 0, 'f', decimals);
+}
+
+QString TimelineWG::sizeText(double size)
+{
+    if (size >= 1024 * 1024) {
+        return QString("%1 MB").arg(size / (1024 * 1024), 0, 'f', 1);
+    }
+    if (size >= 1024) {
+        return QString("%1 KB").arg(size / 1024, 0, 'f', 1);
+    }
+    return QString("%1 B").arg(size, 0, 'f', 0);
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 zhang hongyuan <2063218120@qq.com>
+// SPDX-License-Identifier: MIT
+
+#ifndef TIMELINEWG_H
+#define TIMELINEWG_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <functional>
+
+#include <model/columntablestore.h>
+#include <model/timelinepyramid.h>
+
+/**
+ * @brief Timeline chart of the packet or frame sizes of a table
+ *
+ * Sizes are drawn over time, coloured by key flag and picture type, to spot
+ * bitrate spikes and GOP patterns. The chart keeps a TimelinePyramid and draws
+ * the min/max of every pixel column, so zoom (wheel) and pan (drag) redraw at
+ * the same cost for any table length. A click reports the table row of the
+ * nearest point, a double click shows the whole table again.
+ *
+ * The pyramid is rebuilt on a ZProbeScheduler thread once the rows settle.
+ */
+class TimelineWG : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // Snapshot of the plotted table, false if there is none to plot, e.g. a paged table
+    using TableSource = std::function<bool(ColumnTableStore *store, QStringList *headers, QString *reason)>;
+
+    explicit TimelineWG(QWidget *parent = nullptr);
+    ~TimelineWG();
+
+    void setTableSource(const TableSource &source);
+
+    QSize sizeHint() const override;
+
+public slots:
+    // The rows changed, the chart is rebuilt once they settle
+    void invalidate();
+
+    void fitAll();
+
+signals:
+    void rowClicked(int row);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
+private:
+    void rebuild();
+    void onBuilt(int generation, const QSharedPointer<const TimelinePyramid> &pyramid, const QString &message);
+
+    QRect plotRect() const;
+    double timeAt(double x) const;
+    double xOf(double time) const;
+    void setRange(double from, double to);
+
+    QString timeText(double time, double step) const;
+    static QString sizeText(double size);
+
+private:
+    TableSource m_source;
+    QSharedPointer<const TimelinePyramid> m_pyramid;
+    qint64 m_stream;                // stream_index shown, -1 for every stream
+    int m_generation;
+    bool m_dirty;                   // rows changed since the last build
+    QTimer m_rebuildTimer;
+    QString m_message;              // shown instead of the chart
+
+    // visible time range
+    double m_from;
+    double m_to;
+    bool m_fitted;                  // follow the whole table while it grows
+
+    // drag to pan
+    bool m_pressed;
+    bool m_dragged;
+    QPoint m_pressPos;
+    double m_pressFrom;
+    double m_pressTo;
+
+    double m_markerTime;            // time of the clicked point
+    bool m_hasMarker;
+
+    // min/max of every pixel column, reused by every paint
+    QVector<float> m_minimum;
+    QVector<float> m_maximum;
+};
+
+#endif // TIMELINEWG_H